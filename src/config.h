@@ -7,3 +7,18 @@
  */
 
 #include "core/platform.h"
+
+// Records the strings hashed by StringId32/StringId64 in string_id_table.
+#ifndef CROWN_STRING_ID_TABLE
+#  if CROWN_DEBUG
+#    define CROWN_STRING_ID_TABLE 1
+#  else
+#    define CROWN_STRING_ID_TABLE 0
+#  endif
+#endif
+
+// Counts the acquisitions, contended acquisitions and wait time of the
+// locks that have a name, see lock_stats.h.
+#ifndef CROWN_LOCK_STATS
+#  define CROWN_LOCK_STATS 0
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/types.h"
+
+#if CROWN_COMPILER_MSVC
+#  include <intrin.h>
+#endif
+
+namespace crown
+{
+    // Returns the number of trailing zero bits in `x`.
+    // `x` must not be zero.
+    inline u32 count_trailing_zeros(u64 x)
+    {
+#if CROWN_COMPILER_GCC || CROWN_COMPILER_CLANG
+        return (u32)__builtin_ctzll(x);
+#elif CROWN_CPU_64BIT
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return (u32)index;
+#else
+        unsigned long index;
+        if (_BitScanForward(&index, (u32)x))
+            return (u32)index;
+        _BitScanForward(&index, (u32)(x >> 32));
+        return (u32)index + 32;
+#endif
+    }
+
+    // Returns the number of leading zero bits in `x`.
+    // `x` must not be zero.
+    inline u32 count_leading_zeros(u64 x)
+    {
+#if CROWN_COMPILER_GCC || CROWN_COMPILER_CLANG
+        return (u32)__builtin_clzll(x);
+#elif CROWN_CPU_64BIT
+        unsigned long index;
+        _BitScanReverse64(&index, x);
+        return 63 - (u32)index;
+#else
+        unsigned long index;
+        if (_BitScanReverse(&index, (u32)(x >> 32)))
+            return 31 - (u32)index;
+        _BitScanReverse(&index, (u32)x);
+        return 63 - (u32)index;
+#endif
+    }
+
+    // Returns the number of bits set in `x`.
+    inline u32 popcount(u64 x)
+    {
+#if CROWN_COMPILER_GCC || CROWN_COMPILER_CLANG
+        return (u32)__builtin_popcountll(x);
+#elif CROWN_SIMD_AVX2 && CROWN_CPU_64BIT
+        // Every AVX2 capable CPU has popcnt.
+        return (u32)__popcnt64(x);
+#else
+        x = x - ((x >> 1) & 0x5555555555555555ull);
+        x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+        x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        return (u32)((x * 0x0101010101010101ull) >> 56);
+#endif
+    }
+
+} // namespace crown
@@ -0,0 +1,422 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/bits.inl"
+#include "core/containers/array_algorithms.h"
+#include "core/error/error.inl"
+
+#if CROWN_SIMD_AVX2
+#  include <immintrin.h>
+#elif CROWN_SIMD_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace crown
+{
+
+namespace array_algorithms
+{
+    u32 find(const u32* data, u32 n, u32 val)
+    {
+        u32 i = 0;
+
+#if CROWN_SIMD_AVX2
+        const __m256i v = _mm256_set1_epi32((int)val);
+        for (; i + 32 <= n; i += 32)
+        {
+            const __m256i* p = (const __m256i*)(data + i);
+            const __m256i e0 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 0), v);
+            const __m256i e1 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 1), v);
+            const __m256i e2 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 2), v);
+            const __m256i e3 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 3), v);
+            const __m256i any = _mm256_or_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e2, e3));
+            if (!_mm256_testz_si256(any, any))
+            {
+                const u64 mask = u64(_mm256_movemask_ps(_mm256_castsi256_ps(e0)))
+                    | u64(_mm256_movemask_ps(_mm256_castsi256_ps(e1))) << 8
+                    | u64(_mm256_movemask_ps(_mm256_castsi256_ps(e2))) << 16
+                    | u64(_mm256_movemask_ps(_mm256_castsi256_ps(e3))) << 24
+                    ;
+                return i + count_trailing_zeros(mask);
+            }
+        }
+#elif CROWN_SIMD_SSE2
+        const __m128i v = _mm_set1_epi32((int)val);
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m128i* p = (const __m128i*)(data + i);
+            const __m128i e0 = _mm_cmpeq_epi32(_mm_loadu_si128(p + 0), v);
+            const __m128i e1 = _mm_cmpeq_epi32(_mm_loadu_si128(p + 1), v);
+            const __m128i e2 = _mm_cmpeq_epi32(_mm_loadu_si128(p + 2), v);
+            const __m128i e3 = _mm_cmpeq_epi32(_mm_loadu_si128(p + 3), v);
+            const __m128i any = _mm_or_si128(_mm_or_si128(e0, e1), _mm_or_si128(e2, e3));
+            if (_mm_movemask_epi8(any) != 0)
+            {
+                const u64 mask = u64(_mm_movemask_ps(_mm_castsi128_ps(e0)))
+                    | u64(_mm_movemask_ps(_mm_castsi128_ps(e1))) << 4
+                    | u64(_mm_movemask_ps(_mm_castsi128_ps(e2))) << 8
+                    | u64(_mm_movemask_ps(_mm_castsi128_ps(e3))) << 12
+                    ;
+                return i + count_trailing_zeros(mask);
+            }
+        }
+#endif
+
+        for (; i < n; ++i)
+        {
+            if (data[i] == val)
+                return i;
+        }
+
+        return n;
+    }
+
+    u32 find(const u64* data, u32 n, u64 val)
+    {
+        u32 i = 0;
+
+#if CROWN_SIMD_AVX2
+        const __m256i v = _mm256_set1_epi64x((long long)val);
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256i* p = (const __m256i*)(data + i);
+            const __m256i e0 = _mm256_cmpeq_epi64(_mm256_loadu_si256(p + 0), v);
+            const __m256i e1 = _mm256_cmpeq_epi64(_mm256_loadu_si256(p + 1), v);
+            const u32 mask = u32(_mm256_movemask_pd(_mm256_castsi256_pd(e0)))
+                | u32(_mm256_movemask_pd(_mm256_castsi256_pd(e1))) << 4
+                ;
+            if (mask != 0)
+                return i + count_trailing_zeros(mask);
+        }
+#elif CROWN_SIMD_SSE2
+        // SSE2 has no 64-bit compare: both 32-bit halves must match.
+        const __m128i v = _mm_set1_epi64x((long long)val);
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128i* p = (const __m128i*)(data + i);
+            __m128i e0 = _mm_cmpeq_epi32(_mm_loadu_si128(p + 0), v);
+            __m128i e1 = _mm_cmpeq_epi32(_mm_loadu_si128(p + 1), v);
+            e0 = _mm_and_si128(e0, _mm_shuffle_epi32(e0, _MM_SHUFFLE(2, 3, 0, 1)));
+            e1 = _mm_and_si128(e1, _mm_shuffle_epi32(e1, _MM_SHUFFLE(2, 3, 0, 1)));
+            const u32 mask = u32(_mm_movemask_pd(_mm_castsi128_pd(e0)))
+                | u32(_mm_movemask_pd(_mm_castsi128_pd(e1))) << 2
+                ;
+            if (mask != 0)
+                return i + count_trailing_zeros(mask);
+        }
+#endif
+
+        for (; i < n; ++i)
+        {
+            if (data[i] == val)
+                return i;
+        }
+
+        return n;
+    }
+
+    u32 find(const f32* data, u32 n, f32 val)
+    {
+        u32 i = 0;
+
+#if CROWN_SIMD_AVX2
+        const __m256 v = _mm256_set1_ps(val);
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m256 e0 = _mm256_cmp_ps(_mm256_loadu_ps(data + i + 0), v, _CMP_EQ_OQ);
+            const __m256 e1 = _mm256_cmp_ps(_mm256_loadu_ps(data + i + 8), v, _CMP_EQ_OQ);
+            const u32 mask = u32(_mm256_movemask_ps(e0)) | u32(_mm256_movemask_ps(e1)) << 8;
+            if (mask != 0)
+                return i + count_trailing_zeros(mask);
+        }
+#elif CROWN_SIMD_SSE2
+        const __m128 v = _mm_set1_ps(val);
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m128 e0 = _mm_cmpeq_ps(_mm_loadu_ps(data + i + 0), v);
+            const __m128 e1 = _mm_cmpeq_ps(_mm_loadu_ps(data + i + 4), v);
+            const u32 mask = u32(_mm_movemask_ps(e0)) | u32(_mm_movemask_ps(e1)) << 4;
+            if (mask != 0)
+                return i + count_trailing_zeros(mask);
+        }
+#endif
+
+        for (; i < n; ++i)
+        {
+            if (data[i] == val)
+                return i;
+        }
+
+        return n;
+    }
+
+#if CROWN_SIMD_AVX2
+    static inline u32 sum_epi32(__m256i v)
+    {
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+        return (u32)_mm_cvtsi128_si32(s);
+    }
+#elif CROWN_SIMD_SSE2
+    static inline u32 sum_epi32(__m128i s)
+    {
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+        return (u32)_mm_cvtsi128_si32(s);
+    }
+#endif
+
+    u32 count(const u32* data, u32 n, u32 val)
+    {
+        u32 i = 0;
+        u32 num = 0;
+
+        // Matching lanes are all ones (-1), subtracting them counts matches.
+#if CROWN_SIMD_AVX2
+        const __m256i v = _mm256_set1_epi32((int)val);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m256i* p = (const __m256i*)(data + i);
+            acc = _mm256_sub_epi32(acc, _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 0), v));
+            acc = _mm256_sub_epi32(acc, _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 1), v));
+        }
+        num = sum_epi32(acc);
+#elif CROWN_SIMD_SSE2
+        const __m128i v = _mm_set1_epi32((int)val);
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m128i* p = (const __m128i*)(data + i);
+            acc = _mm_sub_epi32(acc, _mm_cmpeq_epi32(_mm_loadu_si128(p + 0), v));
+            acc = _mm_sub_epi32(acc, _mm_cmpeq_epi32(_mm_loadu_si128(p + 1), v));
+        }
+        num = sum_epi32(acc);
+#endif
+
+        for (; i < n; ++i)
+            num += data[i] == val;
+
+        return num;
+    }
+
+    u32 count(const u64* data, u32 n, u64 val)
+    {
+        u32 i = 0;
+        u32 num = 0;
+
+#if CROWN_SIMD_AVX2
+        const __m256i v = _mm256_set1_epi64x((long long)val);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 4 <= n; i += 4)
+            acc = _mm256_sub_epi64(acc, _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(data + i)), v));
+
+        u64 lanes[4];
+        _mm256_storeu_si256((__m256i*)lanes, acc);
+        num = u32(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#elif CROWN_SIMD_SSE2
+        const __m128i v = _mm_set1_epi64x((long long)val);
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128i e = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(data + i)), v);
+            e = _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+            acc = _mm_sub_epi64(acc, e);
+        }
+
+        u64 lanes[2];
+        _mm_storeu_si128((__m128i*)lanes, acc);
+        num = u32(lanes[0] + lanes[1]);
+#endif
+
+        for (; i < n; ++i)
+            num += data[i] == val;
+
+        return num;
+    }
+
+    u32 count(const f32* data, u32 n, f32 val)
+    {
+        u32 i = 0;
+        u32 num = 0;
+
+#if CROWN_SIMD_AVX2
+        const __m256 v = _mm256_set1_ps(val);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256 e = _mm256_cmp_ps(_mm256_loadu_ps(data + i), v, _CMP_EQ_OQ);
+            acc = _mm256_sub_epi32(acc, _mm256_castps_si256(e));
+        }
+        num = sum_epi32(acc);
+#elif CROWN_SIMD_SSE2
+        const __m128 v = _mm_set1_ps(val);
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 e = _mm_cmpeq_ps(_mm_loadu_ps(data + i), v);
+            acc = _mm_sub_epi32(acc, _mm_castps_si128(e));
+        }
+        num = sum_epi32(acc);
+#endif
+
+        for (; i < n; ++i)
+            num += data[i] == val;
+
+        return num;
+    }
+
+    // Computes min/max of 32-bit integers in the signed domain. Unsigned
+    // integers are flipped into it by xoring `bias` (the sign bit) in and out.
+    static void min_max_32(const u32* data, u32 n, u32 bias, u32& min, u32& max)
+    {
+        CE_ASSERT(n > 0, "Empty range");
+
+        s32 mn = s32(data[0] ^ bias);
+        s32 mx = mn;
+        u32 i = 0;
+
+#if CROWN_SIMD_AVX2
+        if (n >= 8)
+        {
+            const __m256i b = _mm256_set1_epi32((int)bias);
+            __m256i vmn = _mm256_set1_epi32(mn);
+            __m256i vmx = vmn;
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(data + i)), b);
+                vmn = _mm256_min_epi32(vmn, x);
+                vmx = _mm256_max_epi32(vmx, x);
+            }
+
+            s32 lmn[8], lmx[8];
+            _mm256_storeu_si256((__m256i*)lmn, vmn);
+            _mm256_storeu_si256((__m256i*)lmx, vmx);
+            for (u32 j = 0; j < 8; ++j)
+            {
+                mn = lmn[j] < mn ? lmn[j] : mn;
+                mx = lmx[j] > mx ? lmx[j] : mx;
+            }
+        }
+#elif CROWN_SIMD_SSE2
+        if (n >= 4)
+        {
+            // SSE2 has no 32-bit min/max: select with a compare mask.
+            const __m128i b = _mm_set1_epi32((int)bias);
+            __m128i vmn = _mm_set1_epi32(mn);
+            __m128i vmx = vmn;
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(data + i)), b);
+                const __m128i lt = _mm_cmplt_epi32(x, vmn);
+                const __m128i gt = _mm_cmpgt_epi32(x, vmx);
+                vmn = _mm_or_si128(_mm_and_si128(lt, x), _mm_andnot_si128(lt, vmn));
+                vmx = _mm_or_si128(_mm_and_si128(gt, x), _mm_andnot_si128(gt, vmx));
+            }
+
+            s32 lmn[4], lmx[4];
+            _mm_storeu_si128((__m128i*)lmn, vmn);
+            _mm_storeu_si128((__m128i*)lmx, vmx);
+            for (u32 j = 0; j < 4; ++j)
+            {
+                mn = lmn[j] < mn ? lmn[j] : mn;
+                mx = lmx[j] > mx ? lmx[j] : mx;
+            }
+        }
+#endif
+
+        for (; i < n; ++i)
+        {
+            const s32 x = s32(data[i] ^ bias);
+            mn = x < mn ? x : mn;
+            mx = x > mx ? x : mx;
+        }
+
+        min = u32(mn) ^ bias;
+        max = u32(mx) ^ bias;
+    }
+
+    void min_max(const u32* data, u32 n, u32& min, u32& max)
+    {
+        min_max_32(data, n, 0x80000000u, min, max);
+    }
+
+    void min_max(const s32* data, u32 n, s32& min, s32& max)
+    {
+        u32 mn, mx;
+        min_max_32((const u32*)data, n, 0u, mn, mx);
+        min = s32(mn);
+        max = s32(mx);
+    }
+
+    void min_max(const f32* data, u32 n, f32& min, f32& max)
+    {
+        CE_ASSERT(n > 0, "Empty range");
+
+        f32 mn = data[0];
+        f32 mx = data[0];
+        u32 i = 0;
+
+#if CROWN_SIMD_AVX2
+        if (n >= 8)
+        {
+            __m256 vmn = _mm256_set1_ps(mn);
+            __m256 vmx = vmn;
+            for (; i + 8 <= n; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(data + i);
+                vmn = _mm256_min_ps(vmn, x);
+                vmx = _mm256_max_ps(vmx, x);
+            }
+
+            f32 lmn[8], lmx[8];
+            _mm256_storeu_ps(lmn, vmn);
+            _mm256_storeu_ps(lmx, vmx);
+            for (u32 j = 0; j < 8; ++j)
+            {
+                mn = lmn[j] < mn ? lmn[j] : mn;
+                mx = lmx[j] > mx ? lmx[j] : mx;
+            }
+        }
+#elif CROWN_SIMD_SSE2
+        if (n >= 4)
+        {
+            __m128 vmn = _mm_set1_ps(mn);
+            __m128 vmx = vmn;
+            for (; i + 4 <= n; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(data + i);
+                vmn = _mm_min_ps(vmn, x);
+                vmx = _mm_max_ps(vmx, x);
+            }
+
+            f32 lmn[4], lmx[4];
+            _mm_storeu_ps(lmn, vmn);
+            _mm_storeu_ps(lmx, vmx);
+            for (u32 j = 0; j < 4; ++j)
+            {
+                mn = lmn[j] < mn ? lmn[j] : mn;
+                mx = lmx[j] > mx ? lmx[j] : mx;
+            }
+        }
+#endif
+
+        for (; i < n; ++i)
+        {
+            mn = data[i] < mn ? data[i] : mn;
+            mx = data[i] > mx ? data[i] : mx;
+        }
+
+        min = mn;
+        max = mx;
+    }
+
+} // namespace array_algorithms
+
+} // namespace crown
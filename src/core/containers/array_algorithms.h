@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/types.h"
+
+namespace crown
+{
+    // Search kernels used by the Array algorithms in array_algorithms.inl.
+    //
+    // They use SSE2/AVX2 when enabled at compile time (see CROWN_SIMD_*)
+    // and fall back to scalar loops otherwise.
+    namespace array_algorithms
+    {
+        // Returns the index of the first item equal to `val` in `data`,
+        // or `n` if there is none.
+        u32 find(const u32* data, u32 n, u32 val);
+        u32 find(const u64* data, u32 n, u64 val);
+        u32 find(const f32* data, u32 n, f32 val);
+
+        // Returns the number of items equal to `val` in `data`.
+        u32 count(const u32* data, u32 n, u32 val);
+        u32 count(const u64* data, u32 n, u64 val);
+        u32 count(const f32* data, u32 n, f32 val);
+
+        // Returns the smallest and the largest item in `data`.
+        // `n` must be greater than zero and `data` must not contain NaNs.
+        void min_max(const u32* data, u32 n, u32& min, u32& max);
+        void min_max(const s32* data, u32 n, s32& min, s32& max);
+        void min_max(const f32* data, u32 n, f32& min, f32& max);
+
+    } // namespace array_algorithms
+
+} // namespace crown
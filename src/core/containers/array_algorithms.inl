@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/containers/array.inl"
+#include "core/containers/array_algorithms.h"
+#include "core/functional.inl"
+#include "core/memory/globals.h"
+#include <string.h> // memcpy, memset
+#include <type_traits>
+
+namespace crown
+{
+
+    // Sorting and searching algorithms over Array.
+    namespace array
+    {
+
+        // Sorts the items of the array `a` in ascending order with a LSD
+        // radix sort. The sort is stable.
+        //
+        // T must be a 4 or 8 bytes unsigned integer, or a type that is
+        // ordered like one (e.g. StringId32, StringId64), or a 16 bytes type
+        // ordered like a 128-bit integer with its low half first (e.g. Guid).
+        // A temporary buffer of size(a) items is allocated from `scratch`.
+        template <typename T> void radix_sort(Array<T>& a, Allocator& scratch = default_scratch_allocator());
+
+        // Sorts `keys` like radix_sort() above and reorders `values` so
+        // that each value stays next to its key.
+        // `keys` and `values` must have the same size.
+        template <typename K, typename V> void radix_sort(Array<K>& keys, Array<V>& values, Allocator& scratch = default_scratch_allocator());
+
+        // Sorts the items of the array `a` with a stable merge sort.
+        //
+        // `cmp(x, y)` must return true if `x` goes before `y`.
+        // A temporary buffer of size(a) items is allocated from `scratch`.
+        template <typename T, typename C> void merge_sort(Array<T>& a, C cmp, Allocator& scratch = default_scratch_allocator());
+
+        // Sorts the items of the array `a` in ascending order with a stable
+        // merge sort.
+        template <typename T> void merge_sort(Array<T>& a);
+
+        // Returns the index of the first item equal to `val` in the array
+        // `a`, or size(a) if there is none.
+        template <typename T> u32 find(const Array<T>& a, const T& val);
+
+        // Returns the number of items equal to `val` in the array `a`.
+        template <typename T> u32 count(const Array<T>& a, const T& val);
+
+        // Returns the smallest and the largest item of the array `a`.
+        // The array must not be empty.
+        template <typename T> void min_max(const Array<T>& a, T& min, T& max);
+
+    } // namespace array
+
+    namespace array_algorithms
+    {
+        // Scalar fallbacks for the types without a SIMD kernel.
+        template <typename T>
+        inline u32 find(const T* data, u32 n, const T& val)
+        {
+            for (u32 i = 0; i < n; ++i)
+            {
+                if (data[i] == val)
+                    return i;
+            }
+
+            return n;
+        }
+
+        template <typename T>
+        inline u32 count(const T* data, u32 n, const T& val)
+        {
+            u32 num = 0;
+            for (u32 i = 0; i < n; ++i)
+                num += data[i] == val;
+            return num;
+        }
+
+        template <typename T>
+        inline void min_max(const T* data, u32 n, T& min, T& max)
+        {
+            CE_ASSERT(n > 0, "Empty range");
+
+            min = data[0];
+            max = data[0];
+            for (u32 i = 1; i < n; ++i)
+            {
+                if (data[i] < min)
+                    min = data[i];
+                if (max < data[i])
+                    max = data[i];
+            }
+        }
+
+        // Signed integers compare equal iff their bits do.
+        inline u32 find(const s32* data, u32 n, const s32& val)
+        {
+            return find((const u32*)data, n, (u32)val);
+        }
+
+        inline u32 find(const s64* data, u32 n, const s64& val)
+        {
+            return find((const u64*)data, n, (u64)val);
+        }
+
+        inline u32 count(const s32* data, u32 n, const s32& val)
+        {
+            return count((const u32*)data, n, (u32)val);
+        }
+
+        inline u32 count(const s64* data, u32 n, const s64& val)
+        {
+            return count((const u64*)data, n, (u64)val);
+        }
+
+        template <int SIZE> struct RadixKey;
+        template <> struct RadixKey<4> { typedef u32 Type; };
+        template <> struct RadixKey<8> { typedef u64 Type; };
+
+        // 128-bit key, e.g. a Guid. Only what radix_sort() needs to
+        // extract digits.
+        struct Radix128
+        {
+            u64 lo;
+            u64 hi;
+
+            u64 operator>>(u32 shift) const
+            {
+                if (shift >= 64)
+                    return hi >> (shift - 64);
+                return shift == 0 ? lo : (lo >> shift) | (hi << (64 - shift));
+            }
+        };
+        template <> struct RadixKey<16> { typedef Radix128 Type; };
+
+        template <typename T>
+        inline typename RadixKey<sizeof(T)>::Type radix_key(const T& item)
+        {
+            CE_STATIC_ASSERT(!std::is_signed<T>::value && !std::is_floating_point<T>::value, "Signed and floating point keys do not sort like their bits");
+            typename RadixKey<sizeof(T)>::Type key;
+            memcpy(&key, &item, sizeof(key));
+            return key;
+        }
+
+        template <typename T>
+        inline u32 scratch_align()
+        {
+            // ScratchAllocator wants 4-bytes aligned requests at least.
+            return alignof(T) < Allocator::DEFAULT_ALIGN ? u32(Allocator::DEFAULT_ALIGN) : u32(alignof(T));
+        }
+
+        // Sorts 11 bits per pass (3 passes for 32-bit keys, 6 for 64-bit,
+        // 12 for 128-bit). All the histograms are built in a single read of
+        // the keys, and passes where every key has the same digit are
+        // skipped, so small keys only pay for the digits that differ.
+        template <typename K, typename V, bool HAS_VALUES>
+        inline void radix_sort(K* keys, V* values, u32 n, Allocator& scratch)
+        {
+            typedef typename RadixKey<sizeof(K)>::Type Key;
+            const u32 DIGIT_BITS = 11;
+            const u32 NUM_DIGITS = 1u << DIGIT_BITS;
+            const u32 NUM_PASSES = (sizeof(Key) * 8 + DIGIT_BITS - 1) / DIGIT_BITS;
+
+            if (n < 2)
+                return;
+
+            // Histograms are too big for small (e.g. fiber) stacks.
+            u32 (*hist)[NUM_DIGITS] = (u32 (*)[NUM_DIGITS])scratch.allocate(NUM_PASSES * NUM_DIGITS * sizeof(u32), alignof(u32));
+            memset(hist, 0, NUM_PASSES * NUM_DIGITS * sizeof(u32));
+
+            for (u32 i = 0; i < n; ++i)
+            {
+                const Key key = radix_key(keys[i]);
+                for (u32 p = 0; p < NUM_PASSES; ++p)
+                    ++hist[p][(key >> (p * DIGIT_BITS)) & (NUM_DIGITS - 1)];
+            }
+
+            K* tmp_keys = (K*)scratch.allocate(n * sizeof(K), scratch_align<K>());
+            V* tmp_values = HAS_VALUES ? (V*)scratch.allocate(n * sizeof(V), scratch_align<V>()) : NULL;
+
+            K* src_keys = keys;
+            K* dst_keys = tmp_keys;
+            V* src_values = values;
+            V* dst_values = tmp_values;
+            const Key first = radix_key(keys[0]);
+
+            for (u32 p = 0; p < NUM_PASSES; ++p)
+            {
+                const u32 shift = p * DIGIT_BITS;
+                u32* offsets = hist[p];
+
+                if (offsets[(first >> shift) & (NUM_DIGITS - 1)] == n)
+                    continue;
+
+                u32 sum = 0;
+                for (u32 d = 0; d < NUM_DIGITS; ++d)
+                {
+                    const u32 c = offsets[d];
+                    offsets[d] = sum;
+                    sum += c;
+                }
+
+                if (HAS_VALUES)
+                {
+                    for (u32 i = 0; i < n; ++i)
+                    {
+                        const u32 pos = offsets[(radix_key(src_keys[i]) >> shift) & (NUM_DIGITS - 1)]++;
+                        dst_keys[pos] = src_keys[i];
+                        dst_values[pos] = src_values[i];
+                    }
+                    exchange(src_values, dst_values);
+                }
+                else
+                {
+                    for (u32 i = 0; i < n; ++i)
+                    {
+                        const u32 pos = offsets[(radix_key(src_keys[i]) >> shift) & (NUM_DIGITS - 1)]++;
+                        dst_keys[pos] = src_keys[i];
+                    }
+                }
+
+                exchange(src_keys, dst_keys);
+            }
+
+            if (src_keys != keys)
+            {
+                memcpy(keys, src_keys, n * sizeof(K));
+                if (HAS_VALUES)
+                    memcpy(values, src_values, n * sizeof(V));
+            }
+
+            scratch.deallocate(tmp_values);
+            scratch.deallocate(tmp_keys);
+            scratch.deallocate(hist);
+        }
+
+        const u32 MERGE_SORT_RUN = 32;
+
+        // Bottom-up merge sort. Runs of MERGE_SORT_RUN items are insertion
+        // sorted in place, then merged back and forth with `tmp`, which
+        // holds `n` items.
+        template <typename T, typename C>
+        inline void merge_sort(T* data, u32 n, C& cmp, T* tmp)
+        {
+            const u32 RUN_SIZE = MERGE_SORT_RUN;
+
+            for (u32 lo = 0; lo < n; lo += RUN_SIZE)
+            {
+                const u32 hi = min(lo + RUN_SIZE, n);
+                for (u32 i = lo + 1; i < hi; ++i)
+                {
+                    const T item = data[i];
+                    u32 j = i;
+                    for (; j > lo && cmp(item, data[j - 1]); --j)
+                        data[j] = data[j - 1];
+                    data[j] = item;
+                }
+            }
+
+            if (n <= RUN_SIZE)
+                return;
+
+            T* src = data;
+            T* dst = tmp;
+
+            for (u32 width = RUN_SIZE; width < n; width *= 2)
+            {
+                for (u32 lo = 0; lo < n; lo += 2 * width)
+                {
+                    const u32 mid = min(lo + width, n);
+                    const u32 hi = min(lo + 2 * width, n);
+
+                    // Already in order, nothing to merge.
+                    if (mid == hi || !cmp(src[mid], src[mid - 1]))
+                    {
+                        memcpy(dst + lo, src + lo, (hi - lo) * sizeof(T));
+                        continue;
+                    }
+
+                    u32 i = lo;
+                    u32 j = mid;
+                    u32 k = lo;
+                    while (i < mid && j < hi)
+                        dst[k++] = cmp(src[j], src[i]) ? src[j++] : src[i++];
+
+                    memcpy(dst + k, src + i, (mid - i) * sizeof(T));
+                    k += mid - i;
+                    memcpy(dst + k, src + j, (hi - j) * sizeof(T));
+                }
+
+                exchange(src, dst);
+            }
+
+            if (src != data)
+                memcpy(data, src, n * sizeof(T));
+        }
+
+        template <typename T, typename C>
+        inline void merge_sort(T* data, u32 n, C& cmp, Allocator& scratch)
+        {
+            // A single run needs no buffer.
+            T* tmp = n > MERGE_SORT_RUN ? (T*)scratch.allocate(n * sizeof(T), scratch_align<T>()) : NULL;
+            merge_sort(data, n, cmp, tmp);
+            scratch.deallocate(tmp);
+        }
+
+    } // namespace array_algorithms
+
+    namespace array
+    {
+
+        template <typename T>
+        inline void radix_sort(Array<T>& a, Allocator& scratch)
+        {
+            array_algorithms::radix_sort<T, char, false>(a._data, NULL, a._size, scratch);
+        }
+
+        template <typename K, typename V>
+        inline void radix_sort(Array<K>& keys, Array<V>& values, Allocator& scratch)
+        {
+            CE_ASSERT(keys._size == values._size, "Keys and values mismatch");
+            array_algorithms::radix_sort<K, V, true>(keys._data, values._data, keys._size, scratch);
+        }
+
+        template <typename T, typename C>
+        inline void merge_sort(Array<T>& a, C cmp, Allocator& scratch)
+        {
+            array_algorithms::merge_sort(a._data, a._size, cmp, scratch);
+        }
+
+        template <typename T>
+        inline void merge_sort(Array<T>& a)
+        {
+            merge_sort(a, less<T>());
+        }
+
+        template <typename T>
+        inline u32 find(const Array<T>& a, const T& val)
+        {
+            return array_algorithms::find(a._data, a._size, val);
+        }
+
+        template <typename T>
+        inline u32 count(const Array<T>& a, const T& val)
+        {
+            return array_algorithms::count(a._data, a._size, val);
+        }
+
+        template <typename T>
+        inline void min_max(const Array<T>& a, T& min, T& max)
+        {
+            CE_ASSERT(a._size > 0, "The array is empty");
+            array_algorithms::min_max(a._data, a._size, min, max);
+        }
+
+    } // namespace array
+
+} // namespace crown
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/containers/bit_array.inl"
+
+#if CROWN_SIMD_AVX2
+#  include <immintrin.h>
+#elif CROWN_SIMD_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace crown
+{
+
+namespace bit_array
+{
+    using namespace bit_array_internal;
+
+#if CROWN_SIMD_AVX2
+    typedef __m256i Vec;
+    const u32 VEC_WORDS = 4;
+    static inline Vec load(const u64* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static inline void store(u64* p, Vec v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static inline Vec vand(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+    static inline Vec vor(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    static inline Vec vxor(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+    static inline Vec vandnot(Vec a, Vec b) { return _mm256_andnot_si256(b, a); }
+#elif CROWN_SIMD_SSE2
+    typedef __m128i Vec;
+    const u32 VEC_WORDS = 2;
+    static inline Vec load(const u64* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static inline void store(u64* p, Vec v) { _mm_storeu_si128((__m128i*)p, v); }
+    static inline Vec vand(Vec a, Vec b) { return _mm_and_si128(a, b); }
+    static inline Vec vor(Vec a, Vec b) { return _mm_or_si128(a, b); }
+    static inline Vec vxor(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+    static inline Vec vandnot(Vec a, Vec b) { return _mm_andnot_si128(b, a); }
+#endif
+
+    struct And
+    {
+        u64 operator()(u64 a, u64 b) const { return a & b; }
+#if CROWN_SIMD_SSE2
+        Vec operator()(Vec a, Vec b) const { return vand(a, b); }
+#endif
+    };
+
+    struct Or
+    {
+        u64 operator()(u64 a, u64 b) const { return a | b; }
+#if CROWN_SIMD_SSE2
+        Vec operator()(Vec a, Vec b) const { return vor(a, b); }
+#endif
+    };
+
+    struct Xor
+    {
+        u64 operator()(u64 a, u64 b) const { return a ^ b; }
+#if CROWN_SIMD_SSE2
+        Vec operator()(Vec a, Vec b) const { return vxor(a, b); }
+#endif
+    };
+
+    struct AndNot
+    {
+        u64 operator()(u64 a, u64 b) const { return a & ~b; }
+#if CROWN_SIMD_SSE2
+        Vec operator()(Vec a, Vec b) const { return vandnot(a, b); }
+#endif
+    };
+
+    // Computes `dst = op(dst, src)` a vector at a time, then word by word.
+    template <typename Op>
+    static void bulk_op(BitArray& dst, const BitArray& src, Op op)
+    {
+        CE_ASSERT(dst._size == src._size, "Size mismatch");
+
+        u64* d = dst._data;
+        const u64* s = src._data;
+        const u32 n = num_words(dst._size);
+        u32 i = 0;
+
+#if CROWN_SIMD_SSE2
+        for (; i + VEC_WORDS <= n; i += VEC_WORDS)
+            store(d + i, op(load(d + i), load(s + i)));
+#endif
+
+        for (; i < n; ++i)
+            d[i] = op(d[i], s[i]);
+    }
+
+    void bit_and(BitArray& dst, const BitArray& src)
+    {
+        bulk_op(dst, src, And());
+    }
+
+    void bit_or(BitArray& dst, const BitArray& src)
+    {
+        bulk_op(dst, src, Or());
+    }
+
+    void bit_xor(BitArray& dst, const BitArray& src)
+    {
+        bulk_op(dst, src, Xor());
+    }
+
+    void bit_andnot(BitArray& dst, const BitArray& src)
+    {
+        bulk_op(dst, src, AndNot());
+    }
+
+    u32 count(const BitArray& ba)
+    {
+        const u64* data = ba._data;
+        const u32 n = num_words(ba._size);
+        u32 i = 0;
+        u64 num = 0;
+
+#if CROWN_SIMD_AVX2
+        // Wojciech Mula's nibble lookup, see https://arxiv.org/abs/1611.07612
+        const __m256i lookup = _mm256_setr_epi8(
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+            );
+        const __m256i low_mask = _mm256_set1_epi8(0x0f);
+        __m256i acc = _mm256_setzero_si256();
+
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+            const __m256i lo = _mm256_and_si256(v, low_mask);
+            const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+            const __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+        }
+
+        u64 lanes[4];
+        _mm256_storeu_si256((__m256i*)lanes, acc);
+        num = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+        // Four independent counters to keep popcnt units busy.
+        u64 c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            c0 += popcount(data[i + 0]);
+            c1 += popcount(data[i + 1]);
+            c2 += popcount(data[i + 2]);
+            c3 += popcount(data[i + 3]);
+        }
+        for (; i < n; ++i)
+            c0 += popcount(data[i]);
+
+        return u32(num + c0 + c1 + c2 + c3);
+    }
+
+    bool any(const BitArray& ba)
+    {
+        return find_first_set(ba, 0) != ba._size;
+    }
+
+    // Returns the index of the first word at or after `wi` that is not
+    // equal to `skip`, or `n`.
+    static u32 skip_words(const u64* data, u32 wi, u32 n, u64 skip)
+    {
+#if CROWN_SIMD_AVX2
+        const __m256i s = _mm256_set1_epi64x((long long)skip);
+        for (; wi + 4 <= n; wi += 4)
+        {
+            const __m256i v = _mm256_loadu_si256((const __m256i*)(data + wi));
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(v, s)) != -1)
+                break;
+        }
+#elif CROWN_SIMD_SSE2
+        const __m128i s = _mm_set1_epi64x((long long)skip);
+        for (; wi + 2 <= n; wi += 2)
+        {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(data + wi));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(v, s)) != 0xffff)
+                break;
+        }
+#endif
+
+        for (; wi < n && data[wi] == skip; ++wi)
+        {
+        }
+
+        return wi;
+    }
+
+    u32 find_first_set(const BitArray& ba, u32 from)
+    {
+        if (from >= ba._size)
+            return ba._size;
+
+        const u32 n = num_words(ba._size);
+        u32 wi = from / WORD_BITS;
+
+        const u64 first = ba._data[wi] & (~u64(0) << (from % WORD_BITS));
+        if (first != 0)
+            return wi * WORD_BITS + count_trailing_zeros(first);
+
+        wi = skip_words(ba._data, wi + 1, n, 0);
+        if (wi == n)
+            return ba._size;
+
+        return wi * WORD_BITS + count_trailing_zeros(ba._data[wi]);
+    }
+
+    u32 find_first_clear(const BitArray& ba, u32 from)
+    {
+        if (from >= ba._size)
+            return ba._size;
+
+        const u32 n = num_words(ba._size);
+        u32 wi = from / WORD_BITS;
+
+        const u64 first = ~ba._data[wi] & (~u64(0) << (from % WORD_BITS));
+        if (first != 0)
+            return min(wi * WORD_BITS + count_trailing_zeros(first), ba._size);
+
+        wi = skip_words(ba._data, wi + 1, n, ~u64(0));
+        if (wi == n)
+            return ba._size;
+
+        // Tail bits are zero, so clamp to the size.
+        return min(wi * WORD_BITS + count_trailing_zeros(~ba._data[wi]), ba._size);
+    }
+
+} // namespace bit_array
+
+} // namespace crown
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/bits.inl"
+#include "core/containers/types.h"
+#include "core/error/error.inl"
+#include "core/memory/allocator.h"
+#include <string.h> // memcpy, memset
+
+namespace crown
+{
+
+    // Functions to manipulate BitArray.
+    namespace bit_array
+    {
+
+        // Returns whether the bit array `ba` has no bits.
+        bool empty(const BitArray& ba);
+
+        // Returns the number of bits in the bit array `ba`.
+        u32 size(const BitArray& ba);
+
+        // Resizes the bit array `ba` to `num_bits` bits.
+        //
+        // Old bits are kept, new bits are cleared.
+        void resize(BitArray& ba, u32 num_bits);
+
+        // Sets the bit `i` of the bit array `ba`.
+        void set(BitArray& ba, u32 i);
+
+        // Clears the bit `i` of the bit array `ba`.
+        void clear(BitArray& ba, u32 i);
+
+        // Sets the bit `i` of the bit array `ba` to `value`.
+        void assign(BitArray& ba, u32 i, bool value);
+
+        // Returns whether the bit `i` of the bit array `ba` is set.
+        bool test(const BitArray& ba, u32 i);
+
+        // Sets all the bits of the bit array `ba`.
+        void set_all(BitArray& ba);
+
+        // Clears all the bits of the bit array `ba`.
+        void clear_all(BitArray& ba);
+
+        // Computes `dst &= src`. Both arrays must have the same size.
+        void bit_and(BitArray& dst, const BitArray& src);
+
+        // Computes `dst |= src`. Both arrays must have the same size.
+        void bit_or(BitArray& dst, const BitArray& src);
+
+        // Computes `dst ^= src`. Both arrays must have the same size.
+        void bit_xor(BitArray& dst, const BitArray& src);
+
+        // Computes `dst &= ~src`. Both arrays must have the same size.
+        void bit_andnot(BitArray& dst, const BitArray& src);
+
+        // Returns the number of bits set in the bit array `ba`.
+        u32 count(const BitArray& ba);
+
+        // Returns whether any bit of the bit array `ba` is set.
+        bool any(const BitArray& ba);
+
+        // Returns the index of the first set bit at or after `from` in the
+        // bit array `ba`, or size(ba) if there is none.
+        u32 find_first_set(const BitArray& ba, u32 from = 0);
+
+        // Returns the index of the first clear bit at or after `from` in the
+        // bit array `ba`, or size(ba) if there is none.
+        u32 find_first_clear(const BitArray& ba, u32 from = 0);
+
+        // Calls `fn(index)` for each set bit of the bit array `ba`, in
+        // ascending order.
+        template <typename F> void for_each_set(const BitArray& ba, F fn);
+
+    } // namespace bit_array
+
+    namespace bit_array_internal
+    {
+        const u32 WORD_BITS = 64;
+
+        inline u32 num_words(u32 num_bits)
+        {
+            return (num_bits + WORD_BITS - 1) / WORD_BITS;
+        }
+
+        // Returns the mask of the valid bits in the last word of `num_bits` bits.
+        inline u64 tail_mask(u32 num_bits)
+        {
+            const u32 rem = num_bits % WORD_BITS;
+            return rem == 0 ? ~u64(0) : (u64(1) << rem) - 1;
+        }
+
+        inline void set_capacity(BitArray& ba, u32 capacity)
+        {
+            if (capacity == ba._capacity)
+                return;
+
+            u64* data = (u64*)ba._allocator->allocate(capacity * sizeof(u64), alignof(u64));
+            memcpy(data, ba._data, min(capacity, num_words(ba._size)) * sizeof(u64));
+            ba._allocator->deallocate(ba._data);
+
+            ba._data = data;
+            ba._capacity = capacity;
+        }
+
+    } // namespace bit_array_internal
+
+    namespace bit_array
+    {
+
+        inline bool empty(const BitArray& ba)
+        {
+            return ba._size == 0;
+        }
+
+        inline u32 size(const BitArray& ba)
+        {
+            return ba._size;
+        }
+
+        inline void resize(BitArray& ba, u32 num_bits)
+        {
+            using namespace bit_array_internal;
+
+            const u32 old_words = num_words(ba._size);
+            const u32 new_words = num_words(num_bits);
+
+            if (new_words > ba._capacity)
+                set_capacity(ba, max(new_words, ba._capacity * 2 + 1));
+
+            if (new_words > old_words)
+                memset(ba._data + old_words, 0, (new_words - old_words) * sizeof(u64));
+
+            ba._size = num_bits;
+
+            if (new_words > 0)
+                ba._data[new_words - 1] &= tail_mask(num_bits);
+        }
+
+        inline void set(BitArray& ba, u32 i)
+        {
+            CE_ASSERT(i < ba._size, "Index out of bounds");
+            ba._data[i / 64] |= u64(1) << (i % 64);
+        }
+
+        inline void clear(BitArray& ba, u32 i)
+        {
+            CE_ASSERT(i < ba._size, "Index out of bounds");
+            ba._data[i / 64] &= ~(u64(1) << (i % 64));
+        }
+
+        inline void assign(BitArray& ba, u32 i, bool value)
+        {
+            CE_ASSERT(i < ba._size, "Index out of bounds");
+            const u64 bit = u64(1) << (i % 64);
+            u64& word = ba._data[i / 64];
+            word = (word & ~bit) | ((u64(0) - u64(value)) & bit);
+        }
+
+        inline bool test(const BitArray& ba, u32 i)
+        {
+            CE_ASSERT(i < ba._size, "Index out of bounds");
+            return (ba._data[i / 64] >> (i % 64)) & 1;
+        }
+
+        inline void set_all(BitArray& ba)
+        {
+            using namespace bit_array_internal;
+
+            const u32 n = num_words(ba._size);
+            if (n == 0)
+                return;
+
+            memset(ba._data, 0xff, n * sizeof(u64));
+            ba._data[n - 1] = tail_mask(ba._size);
+        }
+
+        inline void clear_all(BitArray& ba)
+        {
+            memset(ba._data, 0, bit_array_internal::num_words(ba._size) * sizeof(u64));
+        }
+
+        template <typename F>
+        inline void for_each_set(const BitArray& ba, F fn)
+        {
+            const u32 n = bit_array_internal::num_words(ba._size);
+            for (u32 wi = 0; wi < n; ++wi)
+            {
+                u64 word = ba._data[wi];
+                while (word != 0)
+                {
+                    fn(wi * 64 + count_trailing_zeros(word));
+                    word &= word - 1;
+                }
+            }
+        }
+
+    } // namespace bit_array
+
+    inline BitArray::BitArray(Allocator& a)
+        : _allocator(&a)
+        , _size(0)
+        , _capacity(0)
+        , _data(NULL)
+    {
+    }
+
+    inline BitArray::BitArray(const BitArray& other)
+        : _allocator(other._allocator)
+        , _size(0)
+        , _capacity(0)
+        , _data(NULL)
+    {
+        *this = other;
+    }
+
+    inline BitArray::~BitArray()
+    {
+        _allocator->deallocate(_data);
+    }
+
+    inline BitArray& BitArray::operator=(const BitArray& other)
+    {
+        const u32 n = bit_array_internal::num_words(other._size);
+        if (n > _capacity)
+            bit_array_internal::set_capacity(*this, n);
+
+        memcpy(_data, other._data, n * sizeof(u64));
+        _size = other._size;
+        return *this;
+    }
+
+} // namespace crown
@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/bits.inl"
+#include "core/containers/array.inl"
+#include "core/containers/types.h"
+#include "core/error/error.inl"
+#include "core/memory/allocator.h"
+#include <string.h> // memcpy, memset
+
+namespace crown
+{
+
+    // Functions to manipulate BucketArray.
+    //
+    // Items are addressed by index: the item at `index` lives in bucket
+    // `index / BUCKET_SIZE`, slot `index % BUCKET_SIZE`. Indices are stable
+    // for the lifetime of the item and are recycled after remove().
+    namespace bucket_array
+    {
+
+        // Returns whether the bucket array `ba` is empty.
+        template <typename T, u32 N> bool empty(const BucketArray<T, N>& ba);
+
+        // Returns the number of items in the bucket array `ba`.
+        template <typename T, u32 N> u32 size(const BucketArray<T, N>& ba);
+
+        // Returns the number of items the bucket array `ba` can hold
+        // without allocating a new bucket.
+        template <typename T, u32 N> u32 capacity(const BucketArray<T, N>& ba);
+
+        // Allocates buckets until the bucket array `ba` can hold at least
+        // `capacity` items.
+        template <typename T, u32 N> void reserve(BucketArray<T, N>& ba, u32 capacity);
+
+        // Copies `item` into a free slot of the bucket array `ba` and returns
+        // its index. A new bucket is allocated if there are no free slots.
+        template <typename T, u32 N> u32 add(BucketArray<T, N>& ba, const T& item);
+
+        // Removes the item at `index` from the bucket array `ba`.
+        template <typename T, u32 N> void remove(BucketArray<T, N>& ba, u32 index);
+
+        // Returns whether there is an item at `index` in the bucket array `ba`.
+        template <typename T, u32 N> bool has(const BucketArray<T, N>& ba, u32 index);
+
+        // Removes all the items from the bucket array `ba`.
+        //
+        // Does not free the buckets, they will be reused by later adds.
+        template <typename T, u32 N> void clear(BucketArray<T, N>& ba);
+
+        // Frees the buckets of the bucket array `ba` that hold no items.
+        // Indices of remaining items are unchanged.
+        template <typename T, u32 N> void shrink_to_fit(BucketArray<T, N>& ba);
+
+        // Returns the index of the first item in the bucket array `ba`, or
+        // end() if the array is empty.
+        template <typename T, u32 N> u32 begin(const BucketArray<T, N>& ba);
+
+        // Returns the index of the item following `index` in the bucket
+        // array `ba`, or end() if there are no more items.
+        template <typename T, u32 N> u32 next(const BucketArray<T, N>& ba, u32 index);
+
+        // Returns the index past the last item of the bucket array `ba`.
+        template <typename T, u32 N> u32 end(const BucketArray<T, N>& ba);
+
+        // Calls `fn(index, item)` for each item in the bucket array `ba`,
+        // bucket by bucket in index order.
+        template <typename T, u32 N, typename F> void for_each(BucketArray<T, N>& ba, F fn);
+
+    } // namespace bucket_array
+
+    namespace bucket_array_internal
+    {
+        const u32 WORD_BITS = 64;
+
+        template <typename T, u32 N>
+        inline bool is_used(const typename BucketArray<T, N>::Bucket& b, u32 slot)
+        {
+            return (b._used[slot / WORD_BITS] & (u64(1) << (slot % WORD_BITS))) != 0;
+        }
+
+        // Free slots store the index of the next free slot in their first bytes.
+        template <typename T, u32 N>
+        inline u32 next_free(const typename BucketArray<T, N>::Bucket& b, u32 slot)
+        {
+            u32 next;
+            memcpy(&next, &b._items[slot], sizeof(next));
+            return next;
+        }
+
+        template <typename T, u32 N>
+        inline void set_next_free(typename BucketArray<T, N>::Bucket& b, u32 slot, u32 next)
+        {
+            memcpy(&b._items[slot], &next, sizeof(next));
+        }
+
+        // Links all the slots of the bucket `bi` in front of the free list,
+        // lowest index first.
+        template <typename T, u32 N>
+        inline void push_free_bucket(BucketArray<T, N>& ba, u32 bi)
+        {
+            typename BucketArray<T, N>::Bucket& b = *ba._buckets[bi];
+            const u32 base = bi * N;
+
+            for (u32 i = 0; i < N - 1; ++i)
+                set_next_free<T, N>(b, i, base + i + 1);
+            set_next_free<T, N>(b, N - 1, ba._free);
+
+            ba._free = base;
+        }
+
+        template <typename T, u32 N>
+        inline void allocate_bucket(BucketArray<T, N>& ba)
+        {
+            typedef typename BucketArray<T, N>::Bucket Bucket;
+
+            Allocator& a = *ba._buckets._allocator;
+            Bucket* b = (Bucket*)a.allocate(sizeof(Bucket), alignof(Bucket));
+            memset(b->_used, 0, sizeof(b->_used));
+
+            array::push_back(ba._buckets, b);
+            push_free_bucket(ba, array::size(ba._buckets) - 1);
+        }
+
+        // Returns the first used index at or after `index`, or NO_INDEX.
+        template <typename T, u32 N>
+        inline u32 find_used(const BucketArray<T, N>& ba, u32 index)
+        {
+            const u32 num_buckets = array::size(ba._buckets);
+            u32 bi = index / N;
+            u32 wi = (index % N) / WORD_BITS;
+            u64 mask = ~u64(0) << (index % WORD_BITS);
+
+            for (; bi < num_buckets; ++bi, wi = 0, mask = ~u64(0))
+            {
+                const typename BucketArray<T, N>::Bucket& b = *ba._buckets[bi];
+
+                for (; wi < countof(b._used); ++wi, mask = ~u64(0))
+                {
+                    const u64 word = b._used[wi] & mask;
+                    if (word != 0)
+                        return bi * N + wi * WORD_BITS + count_trailing_zeros(word);
+                }
+            }
+
+            return BucketArray<T, N>::NO_INDEX;
+        }
+
+    } // namespace bucket_array_internal
+
+    namespace bucket_array
+    {
+
+        template <typename T, u32 N>
+        inline bool empty(const BucketArray<T, N>& ba)
+        {
+            return ba._size == 0;
+        }
+
+        template <typename T, u32 N>
+        inline u32 size(const BucketArray<T, N>& ba)
+        {
+            return ba._size;
+        }
+
+        template <typename T, u32 N>
+        inline u32 capacity(const BucketArray<T, N>& ba)
+        {
+            return array::size(ba._buckets) * N;
+        }
+
+        template <typename T, u32 N>
+        inline void reserve(BucketArray<T, N>& ba, u32 capacity)
+        {
+            while (bucket_array::capacity(ba) < capacity)
+                bucket_array_internal::allocate_bucket(ba);
+        }
+
+        template <typename T, u32 N>
+        inline u32 add(BucketArray<T, N>& ba, const T& item)
+        {
+            using namespace bucket_array_internal;
+
+            if (ba._free == BucketArray<T, N>::NO_INDEX)
+                allocate_bucket(ba);
+
+            const u32 index = ba._free;
+            const u32 slot = index % N;
+            typename BucketArray<T, N>::Bucket& b = *ba._buckets[index / N];
+
+            ba._free = next_free<T, N>(b, slot);
+            b._used[slot / WORD_BITS] |= u64(1) << (slot % WORD_BITS);
+            memcpy(&b._items[slot], &item, sizeof(T));
+            ++ba._size;
+
+            return index;
+        }
+
+        template <typename T, u32 N>
+        inline void remove(BucketArray<T, N>& ba, u32 index)
+        {
+            using namespace bucket_array_internal;
+
+            CE_ASSERT(has(ba, index), "Index out of bounds");
+            const u32 slot = index % N;
+            typename BucketArray<T, N>::Bucket& b = *ba._buckets[index / N];
+
+            b._used[slot / WORD_BITS] &= ~(u64(1) << (slot % WORD_BITS));
+            set_next_free<T, N>(b, slot, ba._free);
+            ba._free = index;
+            --ba._size;
+        }
+
+        template <typename T, u32 N>
+        inline bool has(const BucketArray<T, N>& ba, u32 index)
+        {
+            if (index / N >= array::size(ba._buckets))
+                return false;
+
+            return bucket_array_internal::is_used<T, N>(*ba._buckets[index / N], index % N);
+        }
+
+        template <typename T, u32 N>
+        inline void clear(BucketArray<T, N>& ba)
+        {
+            ba._size = 0;
+            ba._free = BucketArray<T, N>::NO_INDEX;
+
+            // Walk backwards so that the lowest indices end up in front.
+            for (u32 bi = array::size(ba._buckets); bi > 0; --bi)
+            {
+                typename BucketArray<T, N>::Bucket& b = *ba._buckets[bi - 1];
+                memset(b._used, 0, sizeof(b._used));
+                bucket_array_internal::push_free_bucket(ba, bi - 1);
+            }
+        }
+
+        template <typename T, u32 N>
+        inline void shrink_to_fit(BucketArray<T, N>& ba)
+        {
+            using namespace bucket_array_internal;
+
+            Allocator& a = *ba._buckets._allocator;
+
+            // Only trailing buckets can be freed without changing indices.
+            while (!array::empty(ba._buckets))
+            {
+                typename BucketArray<T, N>::Bucket* b = array::back(ba._buckets);
+
+                u64 used = 0;
+                for (u32 wi = 0; wi < countof(b->_used); ++wi)
+                    used |= b->_used[wi];
+
+                if (used != 0)
+                    break;
+
+                a.deallocate(b);
+                array::pop_back(ba._buckets);
+            }
+
+            // Rebuild the free list without the slots of the freed buckets.
+            ba._free = BucketArray<T, N>::NO_INDEX;
+            for (u32 bi = array::size(ba._buckets); bi > 0; --bi)
+            {
+                typename BucketArray<T, N>::Bucket& b = *ba._buckets[bi - 1];
+
+                for (u32 slot = N; slot > 0; --slot)
+                {
+                    if (is_used<T, N>(b, slot - 1))
+                        continue;
+
+                    set_next_free<T, N>(b, slot - 1, ba._free);
+                    ba._free = (bi - 1) * N + slot - 1;
+                }
+            }
+        }
+
+        template <typename T, u32 N>
+        inline u32 begin(const BucketArray<T, N>& ba)
+        {
+            return bucket_array_internal::find_used(ba, 0);
+        }
+
+        template <typename T, u32 N>
+        inline u32 next(const BucketArray<T, N>& ba, u32 index)
+        {
+            return bucket_array_internal::find_used(ba, index + 1);
+        }
+
+        template <typename T, u32 N>
+        inline u32 end(const BucketArray<T, N>& /*ba*/)
+        {
+            return BucketArray<T, N>::NO_INDEX;
+        }
+
+        template <typename T, u32 N, typename F>
+        inline void for_each(BucketArray<T, N>& ba, F fn)
+        {
+            using namespace bucket_array_internal;
+
+            const u32 num_buckets = array::size(ba._buckets);
+            for (u32 bi = 0; bi < num_buckets; ++bi)
+            {
+                typename BucketArray<T, N>::Bucket& b = *ba._buckets[bi];
+
+                for (u32 wi = 0; wi < countof(b._used); ++wi)
+                {
+                    u64 word = b._used[wi];
+                    while (word != 0)
+                    {
+                        const u32 slot = wi * WORD_BITS + count_trailing_zeros(word);
+                        fn(bi * N + slot, b._items[slot]);
+                        word &= word - 1;
+                    }
+                }
+            }
+        }
+
+    } // namespace bucket_array
+
+    template <typename T, u32 N>
+    inline BucketArray<T, N>::BucketArray(Allocator& a)
+        : _buckets(a)
+        , _size(0)
+        , _free(NO_INDEX)
+    {
+        CE_STATIC_ASSERT(sizeof(T) >= sizeof(u32), "Items must be able to hold a free list link");
+        CE_STATIC_ASSERT(N > 0 && (N & (N - 1)) == 0, "BUCKET_SIZE must be a power of two");
+    }
+
+    template <typename T, u32 N>
+    inline BucketArray<T, N>::~BucketArray()
+    {
+        Allocator& a = *_buckets._allocator;
+        for (u32 i = 0; i < array::size(_buckets); ++i)
+            a.deallocate(_buckets[i]);
+    }
+
+    template <typename T, u32 N>
+    inline T& BucketArray<T, N>::operator[](u32 index)
+    {
+        CE_ASSERT(bucket_array::has(*this, index), "Index out of bounds");
+        return _buckets[index / N]->_items[index % N];
+    }
+
+    template <typename T, u32 N>
+    inline const T& BucketArray<T, N>::operator[](u32 index) const
+    {
+        CE_ASSERT(bucket_array::has(*this, index), "Index out of bounds");
+        return _buckets[index / N]->_items[index % N];
+    }
+
+} // namespace crown
@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/containers/array.inl"
+#include "core/containers/array_algorithms.inl"
+#include "core/memory/globals.h"
+#include "core/thread/job_system.h"
+#include <new>
+#include <string.h> // memcpy, memset
+
+namespace crown
+{
+    // Data-parallel loops run on a JobSystem. The calling thread takes part
+    // and returns once all the work is done.
+    //
+    // [0, n) is cut into chunks of `grain` items, or of a size picked from
+    // `n` alone if `grain` is 0, and the workers take chunks until none are
+    // left. Since the chunks never depend on the number of threads, neither
+    // do the results: reductions and scans combine the chunks in order, so
+    // even floating-point sums come out the same on any machine. They can
+    // differ from a serial loop's, which has a single chunk.
+    //
+    // The loops over index ranges are for data spread over several arrays,
+    // e.g. structures of arrays.
+
+    // Calls `fn(begin, end)` for the chunks covering [0, n).
+    template <typename F> void parallel_for(JobSystem& js, u32 n, F fn, u32 grain = 0);
+
+    // Returns `combine` folded over `identity` and the `map(begin, end)` of
+    // the chunks covering [0, n), from first to last.
+    template <typename R, typename M, typename C> R parallel_reduce(JobSystem& js, u32 n, const R& identity, M map, C combine, u32 grain = 0);
+
+    namespace array
+    {
+        // Calls `fn(item)` for each item of the array `a`.
+        template <typename T, typename F> void parallel_for(JobSystem& js, Array<T>& a, F fn, u32 grain = 0);
+
+        // Returns `combine` folded over `identity` and the items of the
+        // array `a`, chunk by chunk.
+        template <typename T, typename C> T parallel_reduce(JobSystem& js, const Array<T>& a, const T& identity, C combine, u32 grain = 0);
+
+        // Replaces each item of the array `a` with the sum of the items up
+        // to and including it.
+        template <typename T> void parallel_prefix_sum(JobSystem& js, Array<T>& a, u32 grain = 0);
+
+        // Sorts the array `a` like radix_sort() does, with 8-bit digits so
+        // that the histograms of all the chunks stay small.
+        template <typename T> void parallel_radix_sort(JobSystem& js, Array<T>& a, Allocator& scratch = default_scratch_allocator());
+
+        // Sorts the array `a` like merge_sort() does. Chunks are sorted in
+        // parallel, then merged pairwise, each merge being split among the
+        // workers too. Only the calling thread uses `scratch`: the chunks
+        // share one buffer allocated up front.
+        template <typename T, typename C> void parallel_merge_sort(JobSystem& js, Array<T>& a, C cmp, Allocator& scratch = default_scratch_allocator());
+
+        // Sorts the array `a` in ascending order like merge_sort() does.
+        template <typename T> void parallel_merge_sort(JobSystem& js, Array<T>& a);
+
+    } // namespace array
+
+    namespace parallel_internal
+    {
+        const u32 MAX_JOBS = 64;      // Per loop, the calling thread included.
+        const u32 MAX_CHUNKS = 512;   // When the grain is picked automatically.
+        const u32 MIN_GRAIN = 64;
+        const u32 SORT_GRAIN = 16384;
+        const u32 MAX_SORT_CHUNKS = 64;
+
+        inline u32 grain_size(u32 n, u32 grain)
+        {
+            if (grain != 0)
+                return grain;
+            return max(MIN_GRAIN, (n + MAX_CHUNKS - 1) / MAX_CHUNKS);
+        }
+
+        template <typename F>
+        struct ChunkLoop
+        {
+            F* fn;
+            u32 num_chunks;
+            std::atomic<u32> next;
+        };
+
+        template <typename F>
+        inline void chunk_job(void* user_data)
+        {
+            ChunkLoop<F>& loop = *(ChunkLoop<F>*)user_data;
+            for (u32 c = loop.next.fetch_add(1, std::memory_order_relaxed)
+                ; c < loop.num_chunks
+                ; c = loop.next.fetch_add(1, std::memory_order_relaxed)
+                )
+                (*loop.fn)(c);
+        }
+
+        // Calls `fn(c)` for each chunk `c` in [0, num_chunks).
+        template <typename F>
+        inline void for_chunks(JobSystem& js, u32 num_chunks, F& fn)
+        {
+            if (num_chunks <= 1)
+            {
+                if (num_chunks == 1)
+                    fn(0u);
+                return;
+            }
+
+            ChunkLoop<F> loop;
+            loop.fn = &fn;
+            loop.num_chunks = num_chunks;
+            loop.next.store(0, std::memory_order_relaxed);
+
+            Job jobs[MAX_JOBS - 1];
+            const u32 num_jobs = min(min(num_chunks, js.num_workers() + 1), MAX_JOBS) - 1;
+            for (u32 i = 0; i < num_jobs; ++i)
+            {
+                jobs[i].func = chunk_job<F>;
+                jobs[i].user_data = &loop;
+            }
+
+            JobCounter counter;
+            js.run(jobs, num_jobs, &counter);
+            chunk_job<F>(&loop);
+            js.wait(counter);
+        }
+
+        template <typename T>
+        inline void parallel_copy(JobSystem& js, T* dst, const T* src, u32 n)
+        {
+            const u32 grain = grain_size(n, 0);
+            auto copy = [&](u32 c) {
+                const u32 begin = c * grain;
+                memcpy(dst + begin, src + begin, (min(begin + grain, n) - begin) * sizeof(T));
+            };
+            for_chunks(js, (n + grain - 1) / grain, copy);
+        }
+
+        // Returns how many items of `a` go before the `k`-th item of the
+        // stable merge of `a` and `b`.
+        template <typename T, typename C>
+        inline u32 merge_split(const T* a, u32 na, const T* b, u32 nb, u32 k, C& cmp)
+        {
+            u32 lo = k > nb ? k - nb : 0;
+            u32 hi = min(k, na);
+            while (lo < hi)
+            {
+                const u32 i = lo + (hi - lo) / 2;
+                const u32 j = k - i - 1;
+                // Ties go to `a`: take more of it unless b[j] is smaller.
+                if (!cmp(b[j], a[i]))
+                    lo = i + 1;
+                else
+                    hi = i;
+            }
+            return lo;
+        }
+
+    } // namespace parallel_internal
+
+    template <typename F>
+    inline void parallel_for(JobSystem& js, u32 n, F fn, u32 grain)
+    {
+        grain = parallel_internal::grain_size(n, grain);
+        auto chunk = [&](u32 c) {
+            const u32 begin = c * grain;
+            fn(begin, min(begin + grain, n));
+        };
+        parallel_internal::for_chunks(js, (n + grain - 1) / grain, chunk);
+    }
+
+    template <typename R, typename M, typename C>
+    inline R parallel_reduce(JobSystem& js, u32 n, const R& identity, M map, C combine, u32 grain)
+    {
+        grain = parallel_internal::grain_size(n, grain);
+        const u32 num_chunks = (n + grain - 1) / grain;
+
+        Allocator& scratch = default_scratch_allocator();
+        R* partials = (R*)scratch.allocate(max(1u, num_chunks) * sizeof(R), array_algorithms::scratch_align<R>());
+        auto chunk = [&](u32 c) {
+            const u32 begin = c * grain;
+            new (&partials[c]) R(map(begin, min(begin + grain, n)));
+        };
+        parallel_internal::for_chunks(js, num_chunks, chunk);
+
+        R result = identity;
+        for (u32 c = 0; c < num_chunks; ++c)
+        {
+            result = combine(result, partials[c]);
+            partials[c].~R();
+        }
+
+        scratch.deallocate(partials);
+        return result;
+    }
+
+    namespace array
+    {
+        template <typename T, typename F>
+        inline void parallel_for(JobSystem& js, Array<T>& a, F fn, u32 grain)
+        {
+            T* data = a._data;
+            crown::parallel_for(js, a._size, [&](u32 begin, u32 end) {
+                for (u32 i = begin; i < end; ++i)
+                    fn(data[i]);
+            }, grain);
+        }
+
+        template <typename T, typename C>
+        inline T parallel_reduce(JobSystem& js, const Array<T>& a, const T& identity, C combine, u32 grain)
+        {
+            const T* data = a._data;
+            return crown::parallel_reduce(js, a._size, identity, [&](u32 begin, u32 end) {
+                T acc = identity;
+                for (u32 i = begin; i < end; ++i)
+                    acc = combine(acc, data[i]);
+                return acc;
+            }, combine, grain);
+        }
+
+        template <typename T>
+        inline void parallel_prefix_sum(JobSystem& js, Array<T>& a, u32 grain)
+        {
+            const u32 n = a._size;
+            T* data = a._data;
+            grain = parallel_internal::grain_size(n, grain);
+            const u32 num_chunks = (n + grain - 1) / grain;
+            if (num_chunks == 0)
+                return;
+
+            // Scan each chunk, then add the total of the chunks before.
+            Allocator& scratch = default_scratch_allocator();
+            T* totals = (T*)scratch.allocate(num_chunks * sizeof(T), array_algorithms::scratch_align<T>());
+            auto scan = [&](u32 c) {
+                const u32 begin = c * grain;
+                const u32 end = min(begin + grain, n);
+                T sum = data[begin];
+                for (u32 i = begin + 1; i < end; ++i)
+                    data[i] = sum = sum + data[i];
+                totals[c] = sum;
+            };
+            parallel_internal::for_chunks(js, num_chunks, scan);
+
+            for (u32 c = 1; c < num_chunks; ++c)
+                totals[c] = totals[c - 1] + totals[c];
+
+            auto add = [&](u32 c) {
+                const u32 begin = (c + 1) * grain;
+                const u32 end = min(begin + grain, n);
+                const T offset = totals[c];
+                for (u32 i = begin; i < end; ++i)
+                    data[i] = offset + data[i];
+            };
+            parallel_internal::for_chunks(js, num_chunks - 1, add);
+
+            scratch.deallocate(totals);
+        }
+
+        template <typename T>
+        inline void parallel_radix_sort(JobSystem& js, Array<T>& a, Allocator& scratch)
+        {
+            using namespace array_algorithms;
+            using namespace parallel_internal;
+            typedef typename RadixKey<sizeof(T)>::Type Key;
+            const u32 DIGIT_BITS = 8;
+            const u32 NUM_DIGITS = 1u << DIGIT_BITS;
+            const u32 NUM_PASSES = sizeof(Key) * 8 / DIGIT_BITS;
+
+            const u32 n = a._size;
+            const u32 num_chunks = min(MAX_SORT_CHUNKS, n / SORT_GRAIN);
+            if (num_chunks < 2)
+            {
+                radix_sort(a, scratch);
+                return;
+            }
+            const u32 grain = (n + num_chunks - 1) / num_chunks;
+
+            u32 (*hist)[NUM_DIGITS] = (u32 (*)[NUM_DIGITS])scratch.allocate(num_chunks * NUM_DIGITS * sizeof(u32), alignof(u32));
+            T* tmp = (T*)scratch.allocate(n * sizeof(T), scratch_align<T>());
+            T* src = a._data;
+            T* dst = tmp;
+
+            for (u32 p = 0; p < NUM_PASSES; ++p)
+            {
+                const u32 shift = p * DIGIT_BITS;
+
+                auto count = [&](u32 c) {
+                    u32* h = hist[c];
+                    memset(h, 0, NUM_DIGITS * sizeof(u32));
+                    const u32 end = min((c + 1) * grain, n);
+                    for (u32 i = c * grain; i < end; ++i)
+                        ++h[(radix_key(src[i]) >> shift) & (NUM_DIGITS - 1)];
+                };
+                for_chunks(js, num_chunks, count);
+
+                // Digits first, then chunks in order: the sort stays stable.
+                u32 sum = 0;
+                bool same_digit = false;
+                for (u32 d = 0; d < NUM_DIGITS && !same_digit; ++d)
+                {
+                    const u32 start = sum;
+                    for (u32 c = 0; c < num_chunks; ++c)
+                    {
+                        const u32 num = hist[c][d];
+                        hist[c][d] = sum;
+                        sum += num;
+                    }
+                    same_digit = sum - start == n;
+                }
+                if (same_digit)
+                    continue;
+
+                auto scatter = [&](u32 c) {
+                    u32* offsets = hist[c];
+                    const u32 end = min((c + 1) * grain, n);
+                    for (u32 i = c * grain; i < end; ++i)
+                        dst[offsets[(radix_key(src[i]) >> shift) & (NUM_DIGITS - 1)]++] = src[i];
+                };
+                for_chunks(js, num_chunks, scatter);
+
+                exchange(src, dst);
+            }
+
+            if (src != a._data)
+                parallel_copy(js, a._data, src, n);
+
+            scratch.deallocate(tmp);
+            scratch.deallocate(hist);
+        }
+
+        template <typename T, typename C>
+        inline void parallel_merge_sort(JobSystem& js, Array<T>& a, C cmp, Allocator& scratch)
+        {
+            using namespace parallel_internal;
+
+            const u32 n = a._size;
+            const u32 num_chunks = min(MAX_SORT_CHUNKS, n / SORT_GRAIN);
+            if (num_chunks < 2)
+            {
+                merge_sort(a, cmp, scratch);
+                return;
+            }
+            const u32 run = (n + num_chunks - 1) / num_chunks;
+
+            // Each run is sorted with its own slice of the buffer the merges
+            // use next.
+            T* tmp = (T*)scratch.allocate(n * sizeof(T), array_algorithms::scratch_align<T>());
+            auto sort_run = [&](u32 c) {
+                const u32 begin = c * run;
+                array_algorithms::merge_sort(a._data + begin, min(begin + run, n) - begin, cmp, tmp + begin);
+            };
+            for_chunks(js, num_chunks, sort_run);
+
+            T* src = a._data;
+            T* dst = tmp;
+
+            // Each merge is split into pieces of SORT_GRAIN output items, and
+            // all the pieces of a level run in parallel.
+            for (u32 width = run; width < n; width *= 2)
+            {
+                const u32 pieces_per_merge = (2 * width + SORT_GRAIN - 1) / SORT_GRAIN;
+                const u32 num_merges = (n + 2 * width - 1) / (2 * width);
+
+                auto merge = [&](u32 piece) {
+                    const u32 lo = (piece / pieces_per_merge) * 2 * width;
+                    const u32 mid = min(lo + width, n);
+                    const u32 hi = min(lo + 2 * width, n);
+                    const u32 k0 = (piece % pieces_per_merge) * SORT_GRAIN;
+                    if (lo + k0 >= hi)
+                        return;
+                    const u32 k1 = min(k0 + SORT_GRAIN, hi - lo);
+
+                    const T* sa = src + lo;
+                    const T* sb = src + mid;
+                    const u32 na = mid - lo;
+                    const u32 nb = hi - mid;
+                    u32 i = merge_split(sa, na, sb, nb, k0, cmp);
+                    u32 j = k0 - i;
+                    const u32 i1 = merge_split(sa, na, sb, nb, k1, cmp);
+                    const u32 j1 = k1 - i1;
+
+                    T* out = dst + lo + k0;
+                    while (i < i1 && j < j1)
+                        *out++ = cmp(sb[j], sa[i]) ? sb[j++] : sa[i++];
+                    memcpy(out, sa + i, (i1 - i) * sizeof(T));
+                    out += i1 - i;
+                    memcpy(out, sb + j, (j1 - j) * sizeof(T));
+                };
+                for_chunks(js, num_merges * pieces_per_merge, merge);
+
+                exchange(src, dst);
+            }
+
+            if (src != a._data)
+                parallel_copy(js, a._data, src, n);
+
+            scratch.deallocate(tmp);
+        }
+
+        template <typename T>
+        inline void parallel_merge_sort(JobSystem& js, Array<T>& a)
+        {
+            parallel_merge_sort(js, a, less<T>());
+        }
+
+    } // namespace array
+
+} // namespace crown
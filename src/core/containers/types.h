@@ -39,6 +39,56 @@ namespace crown
 
     typedef Array<char> Buffer;
 
+    // Dense array of bits.
+    //
+    // Bits are packed into 64-bit words. Bits past the size in the last
+    // word are always zero.
+    struct BitArray
+    {
+        ALLOCATOR_AWARE;
+
+        Allocator* _allocator;
+        u32 _size;      // Number of bits.
+        u32 _capacity;  // Number of words.
+        u64* _data;
+
+        BitArray(Allocator& a);
+        BitArray(const BitArray& other);
+        ~BitArray();
+        BitArray& operator=(const BitArray& other);
+    };
+
+    // Segmented array of POD items.
+    //
+    // Items are stored in fixed-size buckets of BUCKET_SIZE items. Buckets
+    // are never reallocated, so growing does not copy old items and pointers
+    // to items stay valid until the item is removed. Removed slots are
+    // chained into a free list and reused by the following adds.
+    template <typename T, u32 BUCKET_SIZE = 256>
+    struct BucketArray
+    {
+        ALLOCATOR_AWARE;
+
+        struct Bucket
+        {
+            u64 _used[(BUCKET_SIZE + 63) / 64]; // One bit per occupied slot.
+            T _items[BUCKET_SIZE];
+        };
+
+        Array<Bucket*> _buckets;
+        u32 _size;
+        u32 _free; // Index of the first free slot or NO_INDEX.
+
+        BucketArray(Allocator& a);
+        ~BucketArray();
+        T& operator[](u32 index);
+        const T& operator[](u32 index) const;
+
+        BucketArray(const BucketArray&) = delete;
+        BucketArray& operator=(const BucketArray&) = delete;
+
+        static const u32 NO_INDEX = 0xffffffffu;
+    };
 
 
 } // namespace crown
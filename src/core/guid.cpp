@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/error/error.inl"
+#include "core/guid.inl"
+#include "core/strings/number_parse.h"
+#include <atomic>
+#include <chrono>
+#include <string.h> // memcpy
+
+namespace crown
+{
+    namespace guid_internal
+    {
+        // xoroshiro128+ state of the calling thread, all zero until seeded.
+        static CE_THREAD u64 s_state[2];
+        static std::atomic<u64> s_num_seeds(0);
+
+        static inline u64 splitmix64(u64& x)
+        {
+            u64 z = (x += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        static void seed()
+        {
+            // Time, the address of the thread's state and a global counter
+            // tell apart threads and processes started at the same time.
+            u64 x = u64(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+            x ^= u64(uintptr_t(&s_state)) << 16;
+            x ^= s_num_seeds.fetch_add(1, std::memory_order_relaxed) * 0xd1b54a32d192ed03ull;
+
+            s_state[0] = splitmix64(x);
+            s_state[1] = splitmix64(x);
+            if ((s_state[0] | s_state[1]) == 0)
+                s_state[1] = 1;
+        }
+
+        static inline u64 next()
+        {
+            const u64 s0 = s_state[0];
+            u64 s1 = s_state[1];
+            const u64 result = s0 + s1;
+
+            s1 ^= s0;
+            s_state[0] = ((s0 << 24) | (s0 >> 40)) ^ s1 ^ (s1 << 16);
+            s_state[1] = (s1 << 37) | (s1 >> 27);
+            return result;
+        }
+
+        // Writes the `num` low nibbles of `val` as hex digits.
+        static inline void write_hex(char* dst, u64 val, u32 num)
+        {
+            const char* digits = "0123456789abcdef";
+            for (u32 i = 0; i < num; ++i)
+                dst[num - 1 - i] = digits[(val >> (i * 4)) & 0xf];
+        }
+
+        // Reads the `num` hex digits at str[pos] into `val`.
+        static inline bool read_hex(const StringView& str, u32 pos, u32 num, u64& val)
+        {
+            const ParseResult r = parse_hex(StringView(str._data + pos, num), val, num);
+            return r.consumed == num;
+        }
+
+    } // namespace guid_internal
+
+    namespace guid
+    {
+        Guid new_guid()
+        {
+            using namespace guid_internal;
+
+            if (CE_UNLIKELY((s_state[0] | s_state[1]) == 0))
+                seed();
+
+            Guid guid;
+            guid.hi = (next() & ~u64(0xf000)) | 0x4000; // Version 4
+            guid.lo = (next() & ~(u64(3) << 62)) | (u64(2) << 62); // Variant 1
+            return guid;
+        }
+
+        Guid parse(const StringView& str)
+        {
+            Guid guid;
+            const bool success = try_parse(guid, str);
+            CE_ASSERT(success, "Failed to parse Guid: '%.*s'", (int)str._length, str._data);
+            CE_UNUSED(success);
+            return guid;
+        }
+
+        bool try_parse(Guid& guid, const StringView& str)
+        {
+            using namespace guid_internal;
+
+            if (str._length != GUID_BUF_LEN - 1
+                || str._data[8] != '-'
+                || str._data[13] != '-'
+                || str._data[18] != '-'
+                || str._data[23] != '-'
+                )
+                return false;
+
+            u64 a, b, c, d, e;
+            if (!read_hex(str, 0, 8, a)
+                || !read_hex(str, 9, 4, b)
+                || !read_hex(str, 14, 4, c)
+                || !read_hex(str, 19, 4, d)
+                || !read_hex(str, 24, 12, e)
+                )
+                return false;
+
+            guid.hi = a << 32 | b << 16 | c;
+            guid.lo = d << 48 | e;
+            return true;
+        }
+
+        const char* to_string(char* buf, u32 len, const Guid& guid)
+        {
+            using namespace guid_internal;
+
+            char str[GUID_BUF_LEN];
+            write_hex(str, guid.hi >> 32, 8);
+            str[8] = '-';
+            write_hex(str + 9, guid.hi >> 16, 4);
+            str[13] = '-';
+            write_hex(str + 14, guid.hi, 4);
+            str[18] = '-';
+            write_hex(str + 19, guid.lo >> 48, 4);
+            str[23] = '-';
+            write_hex(str + 24, guid.lo, 12);
+            str[36] = '\0';
+
+            if (len > 0)
+            {
+                const u32 num = min(len - 1, u32(GUID_BUF_LEN - 1));
+                memcpy(buf, str, num);
+                buf[num] = '\0';
+            }
+            return buf;
+        }
+
+    } // namespace guid
+
+} // namespace crown
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/strings/string_view.h"
+#include "core/types.h"
+
+#define GUID_BUF_LEN 37
+
+namespace crown
+{
+    // Globally unique identifier.
+    //
+    // The string form "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" prints `hi`
+    // then `lo` in hexadecimal. Guids compare like the 128-bit integers
+    // hi:lo, which is also the order of their strings and, with `lo` first
+    // in memory, the order array::radix_sort() sorts them in.
+    struct Guid
+    {
+        u64 lo;
+        u64 hi;
+    };
+
+    const Guid GUID_ZERO = { 0u, 0u };
+
+    namespace guid
+    {
+        // Returns a new random (version 4) Guid. Uses a generator local to
+        // the calling thread, seeded once per thread: fast, but not
+        // suitable for secrets.
+        Guid new_guid();
+
+        // Parses the string form of a Guid, hex digits of either case.
+        // Asserts if `str` is not a valid Guid.
+        Guid parse(const StringView& str);
+
+        // Parses the string form of a Guid into `guid`.
+        // Returns false if `str` is not a valid Guid.
+        bool try_parse(Guid& guid, const StringView& str);
+
+        // Writes the string form of `guid` to `buf` and returns it.
+        // `buf` size must be greater than or equal to GUID_BUF_LEN or the
+        // returned string will be truncated.
+        const char* to_string(char* buf, u32 len, const Guid& guid);
+
+    } // namespace guid
+
+} // namespace crown
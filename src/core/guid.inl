@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/functional.h"
+#include "core/guid.h"
+#include "core/strings/string_view.inl"
+
+namespace crown
+{
+    inline bool operator==(const Guid& a, const Guid& b)
+    {
+        return a.lo == b.lo && a.hi == b.hi;
+    }
+
+    inline bool operator!=(const Guid& a, const Guid& b)
+    {
+        return a.lo != b.lo || a.hi != b.hi;
+    }
+
+    inline bool operator<(const Guid& a, const Guid& b)
+    {
+        return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+    }
+
+    template <>
+    struct hash<Guid>
+    {
+        u32 operator()(const Guid& id) const
+        {
+            const u64 h = id.lo ^ (id.hi * 0x9e3779b97f4a7c15ull);
+            return u32(h ^ (h >> 32));
+        }
+    };
+
+} // namespace crown
@@ -6,10 +6,12 @@
  * @date     2021-03-30
  */
 
+#include "config.h"
 #include "core/error/error.inl"
 #include "core/memory/allocator.h"
 #include "core/memory/globals.h"
 #include "core/memory/memory.inl"
+#include "core/strings/string_id_table.h"
 #include "core/thread/scoped_mutex.inl"
 #include <stdlib.h> // malloc
 
@@ -203,25 +205,37 @@ namespace memory
             CE_ASSERT(align % 4 == 0, "Must be 4-byte aligned");
             size = ((size + 3)/4)*4; // TODO: align to 4???
 
+            // Nothing in use, start over from the beginning.
+            if (_free == _allocate)
+                _free = _allocate = _begin;
+
             char* p = _allocate;
             Header* h = (Header*)p;
             char* data = (char*) data_pointer(h, align);
             p = data + size;
 
-            // Reached the end of the buffer, wrap around to the beginning.
+            // Reached the end of the buffer, wrap around to the beginning if
+            // the blocks in use leave room there. Blocks can be freed in any
+            // order, so this must check the whole range and not just its end.
             if (p > _end)
             {
-                h->size = u32(_end - (char*)h) | 0x80000000u;
+                Header* wrap = (Header*)_begin;
+                char* wrap_data = (char*)data_pointer(wrap, align);
+                if (_allocate < _free || wrap_data + size >= _free)
+                    return _backing.allocate(size, align);
 
-                p = _begin;
-                h = (Header*)p;
-                data = (char*)data_pointer(h, align);
+                if ((char*)h < _end)
+                    h->size = u32(_end - (char*)h) | 0x80000000u;
+
+                h = wrap;
+                data = wrap_data;
                 p = data + size;
             }
-
             // If the buffer is exhausted use the backing allocator instead.
-            if (in_use(p))
+            else if (in_use(p))
+            {
                 return _backing.allocate(size, align);
+            }
 
             fill(h, data, u32(p - (char*)h));
             _allocate = p;
@@ -254,7 +268,10 @@ namespace memory
                     break;
 
                 _free += h->size & 0x7fffffffu;
-                if (_free == _end)
+
+                // The last block may end exactly at the end of the buffer
+                // and leave _allocate there: only wrap if it is not.
+                if (_free == _end && _allocate != _end)
                     _free = _begin;
             }
         }
@@ -286,10 +303,16 @@ namespace memory_globals
     {
         _default_allocator = new (_buffer) HeapAllocator();
         _default_scratch_allocator = new (_buffer + sizeof(HeapAllocator)) ScratchAllocator(*_default_allocator, 1024*1024);
+#if CROWN_STRING_ID_TABLE
+        string_id_table::init(*_default_allocator);
+#endif
     }
 
     void shutdown(void)
     {
+#if CROWN_STRING_ID_TABLE
+        string_id_table::shutdown();
+#endif
         _default_scratch_allocator->~ScratchAllocator();
         _default_allocator->~HeapAllocator();
     }
@@ -18,11 +18,13 @@ namespace crown
 
     namespace memory_globals
     {
-        // Constructs the initial default allocators.
+        // Constructs the initial default allocators, and the string id
+        // table if CROWN_STRING_ID_TABLE is enabled.
         // Has to be called before anything else during the engine startup.
         void init(void);
 
-        // Destroys the allocators created with memory_globals::init().
+        // Destroys the allocators and the string id table created with
+        // memory_globals::init().
         // Should be the last call of the program.
         void shutdown(void);
 
@@ -6,7 +6,9 @@
  * @date     2021-03-31
  */
 
+#include "core/error/error.inl"
 #include "core/murmur.h"
+#include <string.h> // memcpy
 
 namespace crown
 {
@@ -112,4 +114,137 @@ namespace crown
         return h;
     }
 
+    static const u64 MURMUR64_M = 0xc6a4a7935bd1e995ull;
+    static const int MURMUR64_R = 47;
+
+    static inline u64 murmur64_load(const u8* p)
+    {
+        u64 k;
+        memcpy(&k, p, sizeof(k));
+        return k;
+    }
+
+    static inline u64 murmur64_block(u64 h, u64 k)
+    {
+        k *= MURMUR64_M;
+        k ^= k >> MURMUR64_R;
+        k *= MURMUR64_M;
+
+        h ^= k;
+        h *= MURMUR64_M;
+        return h;
+    }
+
+    // Mixes the last `len` < 8 bytes and finalizes the hash.
+    static inline u64 murmur64_finish(u64 h, const u8* data, u32 len)
+    {
+        if (len != 0)
+        {
+            // Same as the switch in murmur64(), without the jump table.
+            u64 k = 0;
+            for (u32 i = 0; i < len; ++i)
+                k |= u64(data[i]) << (i * 8);
+            h ^= k;
+            h *= MURMUR64_M;
+        }
+
+        h ^= h >> MURMUR64_R;
+        h *= MURMUR64_M;
+        h ^= h >> MURMUR64_R;
+
+        return h;
+    }
+
+    void murmur64_init(Murmur64State& st, u32 len, u64 seed)
+    {
+        st._h = seed ^ (len * MURMUR64_M);
+        st._len = len;
+        st._num = 0;
+        st._tail_len = 0;
+    }
+
+    void murmur64_update(Murmur64State& st, const void* data, u32 len)
+    {
+        CE_ASSERT(st._num + len <= st._len, "More data than announced");
+        const u8* p = (const u8*)data;
+        st._num += len;
+
+        // Complete the block left over by the previous update.
+        if (st._tail_len != 0)
+        {
+            const u32 num = min(len, 8 - st._tail_len);
+            memcpy(st._tail + st._tail_len, p, num);
+            st._tail_len += num;
+            p += num;
+            len -= num;
+
+            if (st._tail_len < 8)
+                return;
+
+            st._h = murmur64_block(st._h, murmur64_load(st._tail));
+            st._tail_len = 0;
+        }
+
+        u64 h = st._h;
+        for (; len >= 8; p += 8, len -= 8)
+            h = murmur64_block(h, murmur64_load(p));
+        st._h = h;
+
+        memcpy(st._tail, p, len);
+        st._tail_len = len;
+    }
+
+    u64 murmur64_final(Murmur64State& st)
+    {
+        CE_ASSERT(st._num == st._len, "Less data than announced");
+        return murmur64_finish(st._h, st._tail, st._tail_len);
+    }
+
+    void murmur64_batch(const void* const* keys, const u32* lens, u32 num, u64 seed, u64* hashes)
+    {
+        u32 i = 0;
+
+        // Four keys in lockstep give the CPU four independent dependency
+        // chains. There is no 64-bit vector multiply below AVX-512, so the
+        // lanes are scalar.
+        for (; i + 4 <= num; i += 4)
+        {
+            const u8* p0 = (const u8*)keys[i + 0];
+            const u8* p1 = (const u8*)keys[i + 1];
+            const u8* p2 = (const u8*)keys[i + 2];
+            const u8* p3 = (const u8*)keys[i + 3];
+            u32 n0 = lens[i + 0];
+            u32 n1 = lens[i + 1];
+            u32 n2 = lens[i + 2];
+            u32 n3 = lens[i + 3];
+            u64 h0 = seed ^ (n0 * MURMUR64_M);
+            u64 h1 = seed ^ (n1 * MURMUR64_M);
+            u64 h2 = seed ^ (n2 * MURMUR64_M);
+            u64 h3 = seed ^ (n3 * MURMUR64_M);
+
+            while (n0 >= 8 && n1 >= 8 && n2 >= 8 && n3 >= 8)
+            {
+                h0 = murmur64_block(h0, murmur64_load(p0));
+                h1 = murmur64_block(h1, murmur64_load(p1));
+                h2 = murmur64_block(h2, murmur64_load(p2));
+                h3 = murmur64_block(h3, murmur64_load(p3));
+                p0 += 8; p1 += 8; p2 += 8; p3 += 8;
+                n0 -= 8; n1 -= 8; n2 -= 8; n3 -= 8;
+            }
+
+            for (; n0 >= 8; p0 += 8, n0 -= 8) h0 = murmur64_block(h0, murmur64_load(p0));
+            for (; n1 >= 8; p1 += 8, n1 -= 8) h1 = murmur64_block(h1, murmur64_load(p1));
+            for (; n2 >= 8; p2 += 8, n2 -= 8) h2 = murmur64_block(h2, murmur64_load(p2));
+            for (; n3 >= 8; p3 += 8, n3 -= 8) h3 = murmur64_block(h3, murmur64_load(p3));
+
+            hashes[i + 0] = murmur64_finish(h0, p0, n0);
+            hashes[i + 1] = murmur64_finish(h1, p1, n1);
+            hashes[i + 2] = murmur64_finish(h2, p2, n2);
+            hashes[i + 3] = murmur64_finish(h3, p3, n3);
+        }
+
+        for (; i < num; ++i)
+            hashes[i] = murmur64(keys[i], lens[i], seed);
+    }
+
 } // namespace crown
@@ -15,4 +15,113 @@ namespace crown
     u32 murmur32(const void* key, u32 len, u32 seed);
     u64 murmur64(const void* key, u32 len, u64 seed);
 
+    // State of an incremental murmur64().
+    struct Murmur64State
+    {
+        u64 _h;
+        u32 _len;
+        u32 _num;
+        u32 _tail_len;
+        u8 _tail[8];
+    };
+
+    // Starts hashing `len` bytes with `seed`. MurmurHash2 mixes the total
+    // length into its initial state, so it must be known upfront.
+    void murmur64_init(Murmur64State& st, u32 len, u64 seed);
+
+    // Feeds the next `len` bytes of `data`.
+    void murmur64_update(Murmur64State& st, const void* data, u32 len);
+
+    // Returns the hash once all the bytes announced to murmur64_init() have
+    // been fed. The result is the same as murmur64() over the whole data.
+    u64 murmur64_final(Murmur64State& st);
+
+    // Computes hashes[i] = murmur64(keys[i], lens[i], seed) for `num` keys.
+    // Hashes several keys at once to hide the latency of the multiplies.
+    void murmur64_batch(const void* const* keys, const u32* lens, u32 num, u64 seed, u64* hashes);
+
+    // Same as murmur32() but usable in constant expressions.
+    // Matches murmur32() on little-endian machines only.
+    constexpr u32 murmur32_constexpr(const char* str, u32 len, u32 seed)
+    {
+        const u32 m = 0x5bd1e995;
+        const u32 r = 24;
+
+        u32 h = seed ^ len;
+        u32 i = 0;
+
+        for (; len - i >= 4; i += 4)
+        {
+            u32 k = u32(u8(str[i + 0])) <<  0
+                  | u32(u8(str[i + 1])) <<  8
+                  | u32(u8(str[i + 2])) << 16
+                  | u32(u8(str[i + 3])) << 24
+                  ;
+
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+
+            h *= m;
+            h ^= k;
+        }
+
+        switch (len - i)
+        {
+        case 3: h ^= u32(u8(str[i + 2])) << 16; // Fallthrough
+        case 2: h ^= u32(u8(str[i + 1])) << 8;  // Fallthrough
+        case 1: h ^= u32(u8(str[i + 0]));       // Fallthrough
+            h *= m;
+        };
+
+        h ^= h >> 13;
+        h *= m;
+        h ^= h >> 15;
+
+        return h;
+    }
+
+    // Same as murmur64() but usable in constant expressions.
+    // Matches murmur64() on little-endian machines only.
+    constexpr u64 murmur64_constexpr(const char* str, u32 len, u64 seed)
+    {
+        const u64 m = 0xc6a4a7935bd1e995ull;
+        const u32 r = 47;
+
+        u64 h = seed ^ (len * m);
+        u32 i = 0;
+
+        for (; len - i >= 8; i += 8)
+        {
+            u64 k = 0;
+            for (u32 j = 0; j < 8; ++j)
+                k |= u64(u8(str[i + j])) << (j * 8);
+
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+
+            h ^= k;
+            h *= m;
+        }
+
+        switch (len - i)
+        {
+        case 7: h ^= u64(u8(str[i + 6])) << 48; // Fallthrough
+        case 6: h ^= u64(u8(str[i + 5])) << 40; // Fallthrough
+        case 5: h ^= u64(u8(str[i + 4])) << 32; // Fallthrough
+        case 4: h ^= u64(u8(str[i + 3])) << 24; // Fallthrough
+        case 3: h ^= u64(u8(str[i + 2])) << 16; // Fallthrough
+        case 2: h ^= u64(u8(str[i + 1])) << 8;  // Fallthrough
+        case 1: h ^= u64(u8(str[i + 0]));       // Fallthrough
+            h *= m;
+        };
+
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+
+        return h;
+    }
+
 } // namespace crown
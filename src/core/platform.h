@@ -27,6 +27,9 @@
 #define CROWN_CPU_32BIT 0
 #define CROWN_CPU_64BIT 0
 
+#define CROWN_SIMD_SSE2 0
+#define CROWN_SIMD_AVX2 0
+
 
 // Detects Compiler
 #if defined(_MSC_VER)
@@ -93,6 +96,17 @@
 #  define CROWN_CPU_32BIT 1
 #endif
 
+// Detects SIMD instruction sets enabled at compile time
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  undef CROWN_SIMD_SSE2
+#  define CROWN_SIMD_SSE2 1
+#endif
+
+#if defined(__AVX2__)
+#  undef CROWN_SIMD_AVX2
+#  define CROWN_SIMD_AVX2 1
+#endif
+
 
 // Platform Name
 #if CROWN_PLATFORM_ANDROID
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/memory/types.h"
+#include "core/strings/string_id.h"
+#include "core/strings/string_view.h"
+#include "core/types.h"
+
+namespace crown
+{
+    // Mutable NUL-terminated string.
+    //
+    // Strings up to INLINE_CAPACITY characters are stored inside the object
+    // and never touch the allocator. The StringId32/StringId64 of the
+    // content are cached and only recomputed after a mutation.
+    struct DynamicString
+    {
+        ALLOCATOR_AWARE;
+
+        enum { INLINE_CAPACITY = 23 };
+
+        enum
+        {
+            HAS_ID32 = 1 << 0,
+            HAS_ID64 = 1 << 1
+        };
+
+        Allocator* _allocator;
+        char* _heap;    // NULL while the string fits in _inline.
+        u32 _length;
+        u32 _capacity;  // Not counting the NUL terminator.
+        mutable u64 _id64;
+        mutable u32 _id32;
+        mutable u32 _flags;
+        char _inline[INLINE_CAPACITY + 1];
+
+        explicit DynamicString(Allocator& a);
+        DynamicString(Allocator& a, const char* str);
+        DynamicString(Allocator& a, const char* str, u32 len);
+        DynamicString(const DynamicString& other);
+        ~DynamicString();
+
+        DynamicString& operator=(const DynamicString& other);
+        DynamicString& operator=(const char* str);
+        DynamicString& operator=(const StringView& str);
+
+        DynamicString& operator+=(const DynamicString& str);
+        DynamicString& operator+=(const char* str);
+        DynamicString& operator+=(const StringView& str);
+        DynamicString& operator+=(char ch);
+
+        // Replaces the content with the `len` characters of `str`.
+        void set(const char* str, u32 len);
+
+        // Appends the `len` characters of `str`.
+        void append(const char* str, u32 len);
+
+        // Replaces the content with the printf-style `fmt`.
+        void format(const char* fmt, ...);
+
+        // Appends the printf-style `fmt`.
+        void append_format(const char* fmt, ...);
+
+        // Makes room for at least `capacity` characters.
+        void reserve(u32 capacity);
+
+        // Sets the length to zero, keeping the memory.
+        void clear();
+
+        // Returns the number of characters.
+        u32 length() const;
+
+        // Returns whether the string is empty.
+        bool empty() const;
+
+        // Returns the NUL-terminated string.
+        const char* c_str() const;
+
+        // Returns a view of the whole string. Invalidated by mutations.
+        StringView view() const;
+
+        // Returns a view of `len` characters starting at `pos`, clamped to
+        // the end of the string. Invalidated by mutations.
+        StringView substring(u32 pos, u32 len) const;
+
+        // Returns whether the string begins with `prefix`.
+        bool has_prefix(const StringView& prefix) const;
+
+        // Returns whether the string ends with `suffix`.
+        bool has_suffix(const StringView& suffix) const;
+
+        // Returns the StringId32 of the string.
+        StringId32 to_string_id32() const;
+
+        // Returns the StringId64 of the string.
+        StringId64 to_string_id64() const;
+    };
+
+} // namespace crown
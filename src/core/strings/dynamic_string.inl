@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/memory/allocator.h"
+#include "core/strings/dynamic_string.h"
+#include "core/strings/string.inl"
+#include "core/strings/string_id.inl"
+#include "core/strings/string_view.inl"
+
+namespace crown
+{
+    namespace dynamic_string_internal
+    {
+        inline char* data(DynamicString& s)
+        {
+            return s._heap != NULL ? s._heap : s._inline;
+        }
+
+        // Appends `fmt` to `s`. Arguments may point into `s`, so the text
+        // is never formatted over the string's own buffer.
+        inline void append_vformat(DynamicString& s, const char* fmt, va_list args)
+        {
+            char buf[256];
+            va_list copy;
+            va_copy(copy, args);
+            const s32 len = vsnprintf(buf, sizeof(buf), fmt, copy);
+            va_end(copy);
+            CE_ASSERT(len >= 0, "Bad format");
+
+            if (u32(len) < sizeof(buf))
+            {
+                s.append(buf, u32(len));
+                return;
+            }
+
+            // Format into a new buffer and free the old one only afterwards.
+            const u32 capacity = max(s._length + u32(len), s._capacity * 2);
+            char* heap = (char*)s._allocator->allocate(capacity + 1);
+            memcpy(heap, s.c_str(), s._length);
+            vsnprintf(heap + s._length, u32(len) + 1, fmt, args);
+            s._allocator->deallocate(s._heap);
+            s._heap = heap;
+            s._capacity = capacity;
+            s._length += u32(len);
+            s._flags = 0;
+        }
+
+    } // namespace dynamic_string_internal
+
+    inline DynamicString::DynamicString(Allocator& a)
+        : _allocator(&a)
+        , _heap(NULL)
+        , _length(0)
+        , _capacity(INLINE_CAPACITY)
+        , _id64(0)
+        , _id32(0)
+        , _flags(0)
+    {
+        _inline[0] = '\0';
+    }
+
+    inline DynamicString::DynamicString(Allocator& a, const char* str)
+        : DynamicString(a)
+    {
+        set(str, strlen32(str));
+    }
+
+    inline DynamicString::DynamicString(Allocator& a, const char* str, u32 len)
+        : DynamicString(a)
+    {
+        set(str, len);
+    }
+
+    inline DynamicString::DynamicString(const DynamicString& other)
+        : DynamicString(*other._allocator)
+    {
+        *this = other;
+    }
+
+    inline DynamicString::~DynamicString()
+    {
+        _allocator->deallocate(_heap);
+    }
+
+    inline DynamicString& DynamicString::operator=(const DynamicString& other)
+    {
+        if (this != &other)
+        {
+            set(other.c_str(), other._length);
+            _id64 = other._id64;
+            _id32 = other._id32;
+            _flags = other._flags;
+        }
+        return *this;
+    }
+
+    inline DynamicString& DynamicString::operator=(const char* str)
+    {
+        set(str, strlen32(str));
+        return *this;
+    }
+
+    inline DynamicString& DynamicString::operator=(const StringView& str)
+    {
+        set(str._data, str._length);
+        return *this;
+    }
+
+    inline DynamicString& DynamicString::operator+=(const DynamicString& str)
+    {
+        append(str.c_str(), str._length);
+        return *this;
+    }
+
+    inline DynamicString& DynamicString::operator+=(const char* str)
+    {
+        append(str, strlen32(str));
+        return *this;
+    }
+
+    inline DynamicString& DynamicString::operator+=(const StringView& str)
+    {
+        append(str._data, str._length);
+        return *this;
+    }
+
+    inline DynamicString& DynamicString::operator+=(char ch)
+    {
+        append(&ch, 1);
+        return *this;
+    }
+
+    inline void DynamicString::set(const char* str, u32 len)
+    {
+        _length = 0;
+        append(str, len);
+    }
+
+    inline void DynamicString::append(const char* str, u32 len)
+    {
+        if (_length + len > _capacity)
+        {
+            // `str` may point into this string.
+            const uintptr_t offset = uintptr_t(str) - uintptr_t(c_str());
+            const bool inside = offset <= _length;
+            reserve(max(_length + len, _capacity * 2));
+            if (inside)
+                str = c_str() + offset;
+        }
+
+        char* d = dynamic_string_internal::data(*this);
+        memmove(d + _length, str, len);
+        _length += len;
+        d[_length] = '\0';
+        _flags = 0;
+    }
+
+    inline void DynamicString::format(const char* fmt, ...)
+    {
+        _length = 0;
+        va_list args;
+        va_start(args, fmt);
+        dynamic_string_internal::append_vformat(*this, fmt, args);
+        va_end(args);
+    }
+
+    inline void DynamicString::append_format(const char* fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        dynamic_string_internal::append_vformat(*this, fmt, args);
+        va_end(args);
+    }
+
+    inline void DynamicString::reserve(u32 capacity)
+    {
+        if (capacity <= _capacity)
+            return;
+
+        char* heap = (char*)_allocator->allocate(capacity + 1);
+        memcpy(heap, c_str(), _length + 1);
+        _allocator->deallocate(_heap);
+        _heap = heap;
+        _capacity = capacity;
+    }
+
+    inline void DynamicString::clear()
+    {
+        _length = 0;
+        dynamic_string_internal::data(*this)[0] = '\0';
+        _flags = 0;
+    }
+
+    inline u32 DynamicString::length() const
+    {
+        return _length;
+    }
+
+    inline bool DynamicString::empty() const
+    {
+        return _length == 0;
+    }
+
+    inline const char* DynamicString::c_str() const
+    {
+        return _heap != NULL ? _heap : _inline;
+    }
+
+    inline StringView DynamicString::view() const
+    {
+        return StringView(c_str(), _length);
+    }
+
+    inline StringView DynamicString::substring(u32 pos, u32 len) const
+    {
+        pos = min(pos, _length);
+        return StringView(c_str() + pos, min(len, _length - pos));
+    }
+
+    inline bool DynamicString::has_prefix(const StringView& prefix) const
+    {
+        return prefix._length <= _length
+            && memcmp(c_str(), prefix._data, prefix._length) == 0
+            ;
+    }
+
+    inline bool DynamicString::has_suffix(const StringView& suffix) const
+    {
+        return suffix._length <= _length
+            && memcmp(c_str() + _length - suffix._length, suffix._data, suffix._length) == 0
+            ;
+    }
+
+    inline StringId32 DynamicString::to_string_id32() const
+    {
+        if (!(_flags & HAS_ID32))
+        {
+            _id32 = StringId32(c_str(), _length)._id;
+            _flags |= HAS_ID32;
+        }
+        return StringId32(_id32);
+    }
+
+    inline StringId64 DynamicString::to_string_id64() const
+    {
+        if (!(_flags & HAS_ID64))
+        {
+            _id64 = StringId64(c_str(), _length)._id;
+            _flags |= HAS_ID64;
+        }
+        return StringId64(_id64);
+    }
+
+    inline bool operator==(const DynamicString& a, const char* str)
+    {
+        return a.view() == str;
+    }
+
+    inline bool operator==(const DynamicString& a, const StringView& b)
+    {
+        return a.view() == b;
+    }
+
+    inline bool operator==(const DynamicString& a, const DynamicString& b)
+    {
+        return a.view() == b.view();
+    }
+
+    inline bool operator!=(const DynamicString& a, const DynamicString& b)
+    {
+        return a.view() != b.view();
+    }
+
+    // Consistent with hash<StringView> and hash<StringId32>, and reuses the
+    // cached id. Not transparent: there is no to_key() from a view, which
+    // would have to allocate.
+    template <>
+    struct hash<DynamicString>
+    {
+        u32 operator()(const DynamicString& s) const
+        {
+            return s.to_string_id32()._id;
+        }
+
+        u32 operator()(const StringView& s) const
+        {
+            return hash<StringView>()(s);
+        }
+    };
+
+    template <>
+    struct equal_to<DynamicString>
+    {
+        bool operator()(const DynamicString& a, const DynamicString& b) const
+        {
+            return a == b;
+        }
+
+        bool operator()(const DynamicString& a, const StringView& b) const
+        {
+            return a == b;
+        }
+    };
+
+    inline bool operator<(const DynamicString& a, const DynamicString& b)
+    {
+        return a.view() < b.view();
+    }
+
+} // namespace crown
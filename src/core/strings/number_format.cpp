@@ -0,0 +1,454 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/bits.inl"
+#include "core/error/error.inl"
+#include "core/strings/number_format.h"
+#include <string.h> // memcpy, memmove, memset
+
+namespace crown
+{
+    static const char DIGIT_PAIRS[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899"
+        ;
+
+    static const u32 POW10[] =
+    {
+        1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+    };
+
+    template <typename T>
+    static inline u32 count_digits(T val)
+    {
+        u32 num = 1;
+        for (;;)
+        {
+            if (val < 10) return num;
+            if (val < 100) return num + 1;
+            if (val < 1000) return num + 2;
+            if (val < 10000) return num + 3;
+            val /= 10000u;
+            num += 4;
+        }
+    }
+
+    // Writes the digits of `val` backwards, two at a time, ending at `end`.
+    template <typename T>
+    static inline void write_digits(char* end, T val)
+    {
+        while (val >= 100)
+        {
+            const u32 i = u32(val % 100) * 2;
+            val /= 100;
+            *--end = DIGIT_PAIRS[i + 1];
+            *--end = DIGIT_PAIRS[i + 0];
+        }
+
+        if (val >= 10)
+        {
+            const u32 i = u32(val) * 2;
+            *--end = DIGIT_PAIRS[i + 1];
+            *--end = DIGIT_PAIRS[i + 0];
+        }
+        else
+        {
+            *--end = char('0' + val);
+        }
+    }
+
+    template <typename T>
+    static inline u32 format_unsigned(char* buf, T val)
+    {
+        const u32 len = count_digits(val);
+        write_digits(buf + len, val);
+        return len;
+    }
+
+    u32 format_u32(char* buf, u32 val)
+    {
+        return format_unsigned(buf, val);
+    }
+
+    u32 format_s32(char* buf, s32 val)
+    {
+        if (val >= 0)
+            return format_unsigned(buf, u32(val));
+
+        buf[0] = '-';
+        return 1 + format_unsigned(buf + 1, 0u - u32(val));
+    }
+
+    u32 format_u64(char* buf, u64 val)
+    {
+        return format_unsigned(buf, val);
+    }
+
+    u32 format_s64(char* buf, s64 val)
+    {
+        if (val >= 0)
+            return format_unsigned(buf, u64(val));
+
+        buf[0] = '-';
+        return 1 + format_unsigned(buf + 1, 0ull - u64(val));
+    }
+
+    u32 format_hex(char* buf, u64 val, u32 width)
+    {
+        CE_ASSERT(width <= 16, "Width must be <= 16");
+
+        const u32 bits = val != 0 ? 64 - count_leading_zeros(val) : 1;
+        const u32 len = max((bits + 3) / 4, width);
+
+        for (u32 i = len; i > 0; --i, val >>= 4)
+            buf[i - 1] = "0123456789abcdef"[val & 0xf];
+
+        return len;
+    }
+
+    u32 format_fixed(char* buf, f64 val, u32 decimals)
+    {
+        CE_ASSERT(decimals <= 9, "Decimals must be <= 9");
+
+        const bool neg = val < 0.0;
+        const f64 scaled = (neg ? -val : val) * POW10[decimals] + 0.5;
+        if (!(scaled < 9223372036854775808.0)) // Also catches NaN.
+            return format_f64(buf, val);
+
+        const u64 num = u64(scaled);
+        const u64 int_part = num / POW10[decimals];
+        const u32 frac_part = u32(num % POW10[decimals]);
+
+        u32 len = 0;
+        if (neg && num != 0)
+            buf[len++] = '-';
+        len += format_unsigned(buf + len, int_part);
+
+        if (decimals > 0)
+        {
+            buf[len++] = '.';
+            memset(buf + len, '0', decimals);
+            write_digits(buf + len + decimals, frac_part);
+            len += decimals;
+        }
+
+        return len;
+    }
+
+    // Grisu2, by Florian Loitsch
+    // https://www.cs.tufts.edu/~nr/cs257/archive/florian-loitsch/printf.pdf
+    //
+    // Always reads back to the same value and gives the shortest digits in
+    // the vast majority of cases. Follows Milo Yip's version in RapidJSON.
+    namespace grisu_internal
+    {
+        struct DiyFp
+        {
+            u64 f;
+            s32 e;
+        };
+
+        // 10^-348, 10^-340, ..., 10^340, normalized.
+        static const u64 CACHED_POWERS_F[] =
+        {
+            0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+            0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+            0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+            0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+            0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+            0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+            0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+            0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+            0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+            0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+            0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+            0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+            0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+            0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+            0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+            0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+            0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+            0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+            0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+            0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+            0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+            0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+            0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+            0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+            0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+            0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+            0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+            0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+            0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+        };
+
+        static const s16 CACHED_POWERS_E[] =
+        {
+            -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+            -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+            -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+            -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+            -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+            109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+            375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+            641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+            907, 933, 960, 986, 1013, 1039, 1066,
+        };
+
+        static inline DiyFp make_diyfp(u64 f, s32 e)
+        {
+            DiyFp d;
+            d.f = f;
+            d.e = e;
+            return d;
+        }
+
+        static inline DiyFp normalize(DiyFp d)
+        {
+            const u32 s = count_leading_zeros(d.f);
+            return make_diyfp(d.f << s, d.e - s32(s));
+        }
+
+        // Returns the upper 64 bits of the product, rounded.
+        static inline DiyFp multiply(DiyFp a, DiyFp b)
+        {
+            const u64 M32 = 0xffffffffu;
+            const u64 ac = (a.f >> 32) * (b.f >> 32);
+            const u64 bc = (a.f & M32) * (b.f >> 32);
+            const u64 ad = (a.f >> 32) * (b.f & M32);
+            const u64 bd = (a.f & M32) * (b.f & M32);
+            u64 tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+            tmp += 1u << 31;
+            return make_diyfp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), a.e + b.e + 64);
+        }
+
+        // Returns a cached power c = 10^-k such that e + c.e falls in the
+        // range digit_gen() expects.
+        static inline DiyFp cached_power(s32 e, s32& k)
+        {
+            const f64 dk = (-61 - e) * 0.30102999566398114 + 347;
+            s32 ik = s32(dk);
+            if (dk - ik > 0.0)
+                ++ik;
+
+            const u32 index = u32((ik >> 3) + 1);
+            k = -(-348 + s32(index * 8));
+            return make_diyfp(CACHED_POWERS_F[index], CACHED_POWERS_E[index]);
+        }
+
+        static inline void round_last(char* buf, u32 len, u64 delta, u64 rest, u64 ten_kappa, u64 wp_w)
+        {
+            while (rest < wp_w
+                && delta - rest >= ten_kappa
+                && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)
+                )
+            {
+                buf[len - 1]--;
+                rest += ten_kappa;
+            }
+        }
+
+        static u32 digit_gen(DiyFp w, DiyFp mp, u64 delta, char* buf, s32& k)
+        {
+            const DiyFp one = make_diyfp(u64(1) << -mp.e, mp.e);
+            const u64 wp_w = mp.f - w.f;
+            u32 p1 = u32(mp.f >> -one.e);
+            u64 p2 = mp.f & (one.f - 1);
+            s32 kappa = s32(count_digits(p1));
+            u32 len = 0;
+
+            while (kappa > 0)
+            {
+                const u32 div = POW10[kappa - 1];
+                const u32 d = p1 / div;
+                p1 -= d * div;
+
+                if (d != 0 || len != 0)
+                    buf[len++] = char('0' + d);
+
+                --kappa;
+                const u64 rest = (u64(p1) << -one.e) + p2;
+                if (rest <= delta)
+                {
+                    k += kappa;
+                    round_last(buf, len, delta, rest, u64(POW10[kappa]) << -one.e, wp_w);
+                    return len;
+                }
+            }
+
+            for (;;)
+            {
+                p2 *= 10;
+                delta *= 10;
+                const u32 d = u32(p2 >> -one.e);
+                if (d != 0 || len != 0)
+                    buf[len++] = char('0' + d);
+                p2 &= one.f - 1;
+                --kappa;
+
+                if (p2 < delta)
+                {
+                    k += kappa;
+                    const s32 index = -kappa;
+                    round_last(buf, len, delta, p2, one.f, wp_w * (index < 10 ? POW10[index] : 0));
+                    return len;
+                }
+            }
+        }
+
+        // Writes the digits of f * 2^e to `buf` and returns their number.
+        // The value is then digits * 10^k.
+        static u32 grisu2(u64 f, s32 e, bool lower_closer, char* buf, s32& k)
+        {
+            const DiyFp w = normalize(make_diyfp(f, e));
+            const DiyFp plus = normalize(make_diyfp((f << 1) + 1, e - 1));
+            DiyFp minus = lower_closer
+                ? make_diyfp((f << 2) - 1, e - 2)
+                : make_diyfp((f << 1) - 1, e - 1)
+                ;
+            minus.f <<= minus.e - plus.e;
+            minus.e = plus.e;
+
+            const DiyFp c = cached_power(plus.e, k);
+            const DiyFp W = multiply(w, c);
+            DiyFp Wp = multiply(plus, c);
+            DiyFp Wm = multiply(minus, c);
+            ++Wm.f;
+            --Wp.f;
+
+            return digit_gen(W, Wp, Wp.f - Wm.f, buf, k);
+        }
+
+        static inline u32 write_exponent(char* buf, s32 exp)
+        {
+            u32 len = 0;
+            buf[len++] = 'e';
+            if (exp < 0)
+            {
+                buf[len++] = '-';
+                exp = -exp;
+            }
+            return len + format_unsigned(buf + len, u32(exp));
+        }
+
+        // Lays out `len` digits times 10^k in `buf`.
+        static u32 prettify(char* buf, u32 len, s32 k)
+        {
+            const s32 kk = s32(len) + k; // 10^(kk-1) <= v < 10^kk
+
+            if (k >= 0 && kk <= 21)
+            {
+                // 1234e7 -> 12340000000
+                memset(buf + len, '0', k);
+                return u32(kk);
+            }
+
+            if (kk > 0 && kk <= 21)
+            {
+                // 1234e-2 -> 12.34
+                memmove(buf + kk + 1, buf + kk, len - kk);
+                buf[kk] = '.';
+                return len + 1;
+            }
+
+            if (kk > -6 && kk <= 0)
+            {
+                // 1234e-6 -> 0.001234
+                const u32 offset = u32(2 - kk);
+                memmove(buf + offset, buf, len);
+                buf[0] = '0';
+                buf[1] = '.';
+                memset(buf + 2, '0', offset - 2);
+                return len + offset;
+            }
+
+            if (len == 1)
+            {
+                // 1e30
+                return 1 + write_exponent(buf + 1, kk - 1);
+            }
+
+            // 1234e30 -> 1.234e33
+            memmove(buf + 2, buf + 1, len - 1);
+            buf[1] = '.';
+            return len + 1 + write_exponent(buf + len + 1, kk - 1);
+        }
+
+        // Formats the IEEE-754 number with the given fields.
+        static u32 format_float(char* buf, bool neg, u64 significand, u32 biased_e, u32 significand_bits, u32 max_biased_e, s32 bias)
+        {
+            if (biased_e == max_biased_e && significand != 0)
+            {
+                memcpy(buf, "nan", 3);
+                return 3;
+            }
+
+            u32 len = 0;
+            if (neg)
+                buf[len++] = '-';
+
+            if (biased_e == max_biased_e)
+            {
+                memcpy(buf + len, "inf", 3);
+                return len + 3;
+            }
+
+            if (biased_e == 0 && significand == 0)
+            {
+                buf[len++] = '0';
+                return len;
+            }
+
+            const u64 f = biased_e != 0 ? significand | (u64(1) << significand_bits) : significand;
+            const s32 e = biased_e != 0 ? s32(biased_e) - bias : 1 - bias;
+            const bool lower_closer = significand == 0 && biased_e > 1;
+
+            s32 k = 0;
+            const u32 num = grisu2(f, e, lower_closer, buf + len, k);
+            return len + prettify(buf + len, num, k);
+        }
+
+    } // namespace grisu_internal
+
+    u32 format_f32(char* buf, f32 val)
+    {
+        u32 bits;
+        memcpy(&bits, &val, sizeof(bits));
+        return grisu_internal::format_float(buf
+            , (bits >> 31) != 0
+            , bits & 0x7fffff
+            , (bits >> 23) & 0xff
+            , 23
+            , 0xff
+            , 127 + 23
+            );
+    }
+
+    u32 format_f64(char* buf, f64 val)
+    {
+        u64 bits;
+        memcpy(&bits, &val, sizeof(bits));
+        return grisu_internal::format_float(buf
+            , (bits >> 63) != 0
+            , bits & 0xfffffffffffffull
+            , u32(bits >> 52) & 0x7ff
+            , 52
+            , 0x7ff
+            , 1023 + 52
+            );
+    }
+
+} // namespace crown
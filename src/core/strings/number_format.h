@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/types.h"
+
+// Size of a buffer large enough to hold any number written by the
+// format_*() functions.
+#define NUMBER_BUF_LEN 32
+
+namespace crown
+{
+    // Writes `val` in decimal to `buf` and returns the number of characters
+    // written. `buf` must hold NUMBER_BUF_LEN characters. No NUL terminator
+    // is written by any of the format_*() functions.
+    u32 format_u32(char* buf, u32 val);
+    u32 format_s32(char* buf, s32 val);
+    u32 format_u64(char* buf, u64 val);
+    u32 format_s64(char* buf, s64 val);
+
+    // Writes the shortest decimal representation of `val` that reads back
+    // to the same value, using an exponent only for very large or very
+    // small magnitudes (e.g. "0.1", "1.5e-7", "1e30", "nan", "-inf").
+    u32 format_f32(char* buf, f32 val);
+    u32 format_f64(char* buf, f64 val);
+
+    // Writes `val` in lowercase hexadecimal, padded with zeros to at least
+    // `width` digits.
+    u32 format_hex(char* buf, u64 val, u32 width);
+
+    // Writes `val` with exactly `decimals` (<= 9) digits after the point,
+    // rounding half away from zero. Falls back to format_f64() when
+    // |val| * 10^decimals does not fit in 63 bits.
+    u32 format_fixed(char* buf, f64 val, u32 decimals);
+
+} // namespace crown
@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/error/error.inl"
+#include "core/strings/number_parse.h"
+#include "core/strings/string.inl"
+#include "core/strings/string_view.inl"
+#include <math.h>   // INFINITY, NAN
+#include <stdlib.h> // strtod, strtof
+#include <string.h> // memcmp
+
+namespace crown
+{
+    namespace number_parse_internal
+    {
+        static inline bool is_digit(char c)
+        {
+            return u8(c - '0') < 10;
+        }
+
+        static inline ParseResult result(u32 consumed, bool overflow)
+        {
+            ParseResult r;
+            r.consumed = consumed;
+            r.overflow = overflow;
+            return r;
+        }
+
+        // Reads the decimal digits in [p, end) into `val`, clamping at
+        // `limit`. Returns the first character that is not a digit.
+        static inline const char* parse_digits(const char* p, const char* end, u64 limit, u64& val, bool& overflow)
+        {
+            const u64 cutoff = limit / 10;
+            const u32 last = u32(limit % 10);
+            u64 v = 0;
+            for (; p != end && is_digit(*p); ++p)
+            {
+                const u32 d = u32(*p - '0');
+                if (v >= cutoff && (v > cutoff || d > last))
+                {
+                    overflow = true;
+                    v = limit;
+                }
+                else
+                {
+                    v = v * 10 + d;
+                }
+            }
+            val = v;
+            return p;
+        }
+
+        template <typename T>
+        static ParseResult parse_integer(const StringView& s, T& val, u64 max, bool is_signed)
+        {
+            const char* begin = s._data;
+            const char* end = s._data + s._length;
+            const char* p = begin;
+
+            bool neg = false;
+            if (p != end && (*p == '+' || (*p == '-' && is_signed)))
+                neg = *p++ == '-';
+
+            if (p == end || !is_digit(*p))
+                return result(0, false);
+
+            // Negative numbers go one further than positive ones.
+            u64 mag = 0;
+            bool overflow = false;
+            p = parse_digits(p, end, max + u64(neg), mag, overflow);
+
+            val = neg ? T(0 - mag) : T(mag);
+            return result(u32(p - begin), overflow);
+        }
+
+        // Significant digits kept for the slow path. The halfway point
+        // between two doubles never needs more than 767, so longer inputs
+        // round the same once truncated, as long as a nonzero digit stands
+        // in for the ones dropped.
+        const u32 MAX_DIGITS = 768;
+
+        // Decimal number digits * 10^exp10, as written in the text.
+        struct Decimal
+        {
+            char digits[MAX_DIGITS];
+            u64 mantissa;    // First 19 digits.
+            u32 num_stored;
+            u32 num_digits;  // Including the ones not stored.
+            s32 exp10;
+            bool truncated;  // A nonzero digit was not stored.
+            bool neg;
+            bool inf;
+            bool nan;
+        };
+
+        // Appends the digit `c` of the integer part (`frac` = 0) or of the
+        // fractional part (`frac` = 1).
+        static inline void push_digit(Decimal& dec, char c, s32 frac)
+        {
+            if (dec.num_digits < 19)
+                dec.mantissa = dec.mantissa * 10 + u32(c - '0');
+
+            if (dec.num_stored < MAX_DIGITS)
+            {
+                dec.digits[dec.num_stored++] = c;
+                dec.exp10 -= frac;
+            }
+            else
+            {
+                dec.exp10 += 1 - frac;
+                dec.truncated |= c != '0';
+            }
+
+            ++dec.num_digits;
+        }
+
+        static u32 scan_float(const StringView& s, Decimal& dec)
+        {
+            const char* begin = s._data;
+            const char* end = s._data + s._length;
+            const char* p = begin;
+
+            dec.mantissa = 0;
+            dec.num_stored = 0;
+            dec.num_digits = 0;
+            dec.exp10 = 0;
+            dec.truncated = false;
+            dec.neg = false;
+            dec.inf = false;
+            dec.nan = false;
+
+            if (p != end && (*p == '+' || *p == '-'))
+                dec.neg = *p++ == '-';
+
+            if (end - p >= 3 && memcmp(p, "inf", 3) == 0)
+            {
+                dec.inf = true;
+                return u32(p + 3 - begin);
+            }
+
+            if (end - p >= 3 && memcmp(p, "nan", 3) == 0)
+            {
+                dec.nan = true;
+                return u32(p + 3 - begin);
+            }
+
+            const char* digits = p;
+            while (p != end && *p == '0')
+                ++p;
+            for (; p != end && is_digit(*p); ++p)
+                push_digit(dec, *p, 0);
+            bool any = p != digits;
+
+            if (p != end && *p == '.')
+            {
+                digits = ++p;
+                if (dec.num_digits == 0)
+                {
+                    for (; p != end && *p == '0'; ++p)
+                        --dec.exp10;
+                }
+                for (; p != end && is_digit(*p); ++p)
+                    push_digit(dec, *p, 1);
+                any |= p != digits;
+
+                // A lone '.' is not part of the number.
+                if (!any)
+                    return 0;
+            }
+
+            if (!any)
+                return 0;
+
+            if (p != end && (*p == 'e' || *p == 'E'))
+            {
+                const char* q = p + 1;
+                bool neg_exp = false;
+                if (q != end && (*q == '+' || *q == '-'))
+                    neg_exp = *q++ == '-';
+
+                if (q != end && is_digit(*q))
+                {
+                    u64 e = 0;
+                    bool overflow = false;
+                    p = parse_digits(q, end, 99999, e, overflow);
+                    dec.exp10 += neg_exp ? -s32(e) : s32(e);
+                }
+            }
+
+            return u32(p - begin);
+        }
+
+        // Writes dec as "<digits>e<exp10>" for strtod()/strtof(). It has no
+        // decimal separator, so the locale does not matter.
+        static inline void to_string(const Decimal& dec, char* buf, u32 len)
+        {
+            if (dec.truncated)
+                snprintf(buf, len, "%.*s1e%d", (int)dec.num_stored, dec.digits, (int)dec.exp10 - 1);
+            else
+                snprintf(buf, len, "%.*se%d", (int)dec.num_stored, dec.digits, (int)dec.exp10);
+        }
+
+        static const f64 POW10[] =
+        {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        // Value of each hex digit or 0xff. A table because digits and
+        // letters are mixed at random in ids and branching on them would
+        // often mispredict.
+        static const u8 HEX_DIGITS[256] =
+        {
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        };
+
+        static const f32 POW10F[] =
+        {
+            1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+        };
+
+    } // namespace number_parse_internal
+
+    ParseResult parse_u32(const StringView& s, u32& val)
+    {
+        return number_parse_internal::parse_integer(s, val, UINT32_MAX, false);
+    }
+
+    ParseResult parse_s32(const StringView& s, s32& val)
+    {
+        return number_parse_internal::parse_integer(s, val, INT32_MAX, true);
+    }
+
+    ParseResult parse_u64(const StringView& s, u64& val)
+    {
+        return number_parse_internal::parse_integer(s, val, UINT64_MAX, false);
+    }
+
+    ParseResult parse_s64(const StringView& s, s64& val)
+    {
+        return number_parse_internal::parse_integer(s, val, INT64_MAX, true);
+    }
+
+    ParseResult parse_hex(const StringView& s, u64& val, u32 max_digits)
+    {
+        using namespace number_parse_internal;
+
+        const u32 len = min(s._length, max_digits);
+        u64 v = 0;
+        u32 num = 0;
+        bool overflow = false;
+
+        for (; num < len; ++num)
+        {
+            const u32 d = HEX_DIGITS[u8(s._data[num])];
+            if (d == 0xff)
+                break;
+
+            overflow |= (v >> 60) != 0;
+            v = (v << 4) | d;
+        }
+
+        if (num == 0)
+            return result(0, false);
+
+        val = overflow ? UINT64_MAX : v;
+        return result(num, overflow);
+    }
+
+    ParseResult parse_f64(const StringView& s, f64& val)
+    {
+        using namespace number_parse_internal;
+
+        Decimal dec;
+        const u32 consumed = scan_float(s, dec);
+        if (consumed == 0)
+            return result(0, false);
+
+        f64 v;
+        if (dec.nan)
+        {
+            v = f64(NAN);
+        }
+        else if (dec.inf)
+        {
+            v = f64(INFINITY);
+        }
+        else if (dec.num_digits == 0)
+        {
+            v = 0.0;
+        }
+        else
+        {
+            const u64 m = dec.mantissa;
+            const s32 e = dec.exp10;
+
+            // Clinger's fast path: both m and 10^|e| are exact doubles, so
+            // one multiplication or division rounds correctly.
+            if (dec.num_digits <= 19 && m <= (u64(1) << 53) && e >= -22 && e <= 22)
+            {
+                v = e < 0 ? f64(m) / POW10[-e] : f64(m) * POW10[e];
+            }
+            // Moving zeros from the exponent to m keeps it exact.
+            else if (dec.num_digits <= 19 && e > 22 && e <= 22 + 15 && m <= (u64(1) << 53) / u64(POW10[e - 22]))
+            {
+                v = f64(m * u64(POW10[e - 22])) * 1e22;
+            }
+            else
+            {
+                char buf[MAX_DIGITS + 16];
+                to_string(dec, buf, sizeof(buf));
+                v = strtod(buf, NULL);
+            }
+        }
+
+        val = dec.neg ? -v : v;
+        return result(consumed, !dec.inf && !dec.nan && v == f64(INFINITY));
+    }
+
+    ParseResult parse_f32(const StringView& s, f32& val)
+    {
+        using namespace number_parse_internal;
+
+        Decimal dec;
+        const u32 consumed = scan_float(s, dec);
+        if (consumed == 0)
+            return result(0, false);
+
+        f32 v;
+        if (dec.nan)
+        {
+            v = f32(NAN);
+        }
+        else if (dec.inf)
+        {
+            v = f32(INFINITY);
+        }
+        else if (dec.num_digits == 0)
+        {
+            v = 0.0f;
+        }
+        else
+        {
+            const u64 m = dec.mantissa;
+            const s32 e = dec.exp10;
+
+            if (dec.num_digits <= 19 && m <= (u64(1) << 24) && e >= -10 && e <= 10)
+            {
+                v = e < 0 ? f32(m) / POW10F[-e] : f32(m) * POW10F[e];
+            }
+            else
+            {
+                char buf[MAX_DIGITS + 16];
+                to_string(dec, buf, sizeof(buf));
+                v = strtof(buf, NULL);
+            }
+        }
+
+        val = dec.neg ? -v : v;
+        return result(consumed, !dec.inf && !dec.nan && v == f32(INFINITY));
+    }
+
+} // namespace crown
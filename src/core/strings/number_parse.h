@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/strings/string_view.h"
+#include "core/types.h"
+
+namespace crown
+{
+    // Outcome of the parse_*() functions.
+    struct ParseResult
+    {
+        u32 consumed;   // Number of characters read, 0 if `s` does not start with a number.
+        bool overflow;  // The number did not fit and the value was clamped.
+    };
+
+    // Parses the decimal integer at the start of `s` into `val`. Signed
+    // versions accept a leading '+' or '-', unsigned ones only '+'. Leading
+    // spaces are not skipped and the locale is never consulted. On overflow
+    // all the digits are still consumed and `val` is clamped to the range
+    // of its type.
+    ParseResult parse_u32(const StringView& s, u32& val);
+    ParseResult parse_s32(const StringView& s, s32& val);
+    ParseResult parse_u64(const StringView& s, u64& val);
+    ParseResult parse_s64(const StringView& s, s64& val);
+
+    // Parses at most `max_digits` hexadecimal digits, of either case and
+    // without "0x", at the start of `s` into `val`.
+    ParseResult parse_hex(const StringView& s, u64& val, u32 max_digits = 16);
+
+    // Parses the floating point number at the start of `s` into `val`:
+    // [+-] digits [. digits] [(e|E) [+-] digits], or "inf" and "nan".
+    // The decimal separator is always '.'. Values too large for the type
+    // overflow to infinity.
+    ParseResult parse_f32(const StringView& s, f32& val);
+    ParseResult parse_f64(const StringView& s, f64& val);
+
+} // namespace crown
@@ -23,7 +23,7 @@ inline s32 vsnprintf(char* s, size_t n, const char* fmt, va_list args)
 {
 #if CROWN_COMPILER_MSVC
     s32 len = _vsnprintf_s(s, n, _TRUNCATE, fmt, args);
-    return (len == 1) ? _vscprintf(fmt, args) : len;
+    return (len == -1) ? _vscprintf(fmt, args) : len;
 #else
     return ::vsnprintf(s, n, fmt, args);
 #endif
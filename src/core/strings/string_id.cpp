@@ -6,10 +6,14 @@
  * @date     2021-06-05
  */
 
+#include "config.h"
 #include "core/error/error.h"
 #include "core/murmur.h"
+#include "core/strings/number_parse.h"
 #include "core/strings/string.inl"
 #include "core/strings/string_id.h"
+#include "core/strings/string_id_table.h"
+#include "core/strings/string_view.inl"
 #include <inttypes.h> // PRIx64
 
 namespace crown
@@ -30,14 +34,21 @@ namespace crown
     {
         CE_ENSURE(str != NULL);
         _id = murmur32(str, len, 0);
+
+#if CROWN_STRING_ID_TABLE
+        const bool ok = string_id_table::add(*this, str, len);
+        CE_ASSERT(ok, "StringId32 collision: '%.*s'", (int)len, str);
+        CE_UNUSED(ok);
+#endif
     }
 
     void StringId32::parse(const char* str)
     {
         CE_ENSURE(str != NULL);
-        int num = sscanf(str, "%8x", &_id);
-        CE_ENSURE(num == 1);
-        CE_UNUSED(num);
+        u64 id = 0;
+        const ParseResult pr = parse_hex(str, id, 8);
+        CE_ENSURE(pr.consumed == 8);
+        _id = pr.consumed == 8 ? u32(id) : 0;
     }
 
     const char* StringId32::to_string(char* buf, u32 len) const
@@ -63,16 +74,21 @@ namespace crown
     {
         CE_ENSURE(str != NULL);
         _id = murmur64(str, len, 0);
+
+#if CROWN_STRING_ID_TABLE
+        const bool ok = string_id_table::add(*this, str, len);
+        CE_ASSERT(ok, "StringId64 collision: '%.*s'", (int)len, str);
+        CE_UNUSED(ok);
+#endif
     }
 
     void StringId64::parse(const char* str)
     {
-        u32 id[2];
         CE_ENSURE(str != NULL);
-        int num = sscanf(str, "%8x%8x", &id[0], &id[1]);
-        _id = (u64(id[0]) << 32) | u64(id[1]);
-        CE_ENSURE(num == 2);
-        CE_UNUSED(num);
+        u64 id = 0;
+        const ParseResult pr = parse_hex(str, id, 16);
+        CE_ENSURE(pr.consumed == 16);
+        _id = pr.consumed == 16 ? id : 0;
     }
 
     const char* StringId64::to_string(char* buf, u32 len) const
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "core/murmur.h"
 #include "core/types.h"
 
 #define STRING_ID32_BUF_LEN 7
@@ -20,14 +21,14 @@ namespace crown
     {
         u32 _id;
 
-        StringId32() : _id(0) {}
-        StringId32(u32 idx) : _id(idx) {}
+        constexpr StringId32() : _id(0) {}
+        constexpr StringId32(u32 idx) : _id(idx) {}
         explicit StringId32(const char* str);
         explicit StringId32(const char* str, u32 len);
 
         void hash(const char* str, u32 len);
 
-        // Parses the id from `str`.
+        // Parses the id from the 8 hex digits at `str`.
         void parse(const char* str);
 
         // Returns this string converted to ASSII.
@@ -41,14 +42,14 @@ namespace crown
     {
         u64 _id;
 
-        StringId64() : _id(0) {}
-        StringId64(u64 idx) : _id(idx) {}
+        constexpr StringId64() : _id(0) {}
+        constexpr StringId64(u64 idx) : _id(idx) {}
         explicit StringId64(const char* str);
         explicit StringId64(const char* str, u32 len);
 
         void hash(const char* str, u32 len);
 
-        // Parses the id from `str`.
+        // Parses the id from the 16 hex digits at `str`.
         void parse(const char* str);
 
         // Returns this string converted to ASSII.
@@ -57,4 +58,35 @@ namespace crown
         const char* to_string(char* buf, u32 len) const;
     };
 
+    namespace string_id_internal
+    {
+        // Forces `ID` to be evaluated at compile time.
+        template <u32 ID>
+        constexpr u32 constant_32() { return ID; }
+
+        template <u64 ID>
+        constexpr u64 constant_64() { return ID; }
+
+    } // namespace string_id_internal
+
+    // Returns the StringId32 of the string literal `str`.
+    // Usable in constant expressions: "foo"_id32.
+    constexpr StringId32 operator"" _id32(const char* str, size_t len)
+    {
+        return StringId32(murmur32_constexpr(str, u32(len), 0));
+    }
+
+    // Returns the StringId64 of the string literal `str`.
+    // Usable in constant expressions: "foo"_id64.
+    constexpr StringId64 operator"" _id64(const char* str, size_t len)
+    {
+        return StringId64(murmur64_constexpr(str, u32(len), 0));
+    }
+
 } // namespace crown
+
+// Returns the id of the string literal `str`, always hashed at compile
+// time, even in unoptimized builds. Replaces STRING_ID_32/STRING_ID_64
+// with hand-written ids.
+#define CE_STRING_ID_32(str) crown::string_id_internal::constant_32<crown::murmur32_constexpr(str, sizeof(str) - 1, 0)>()
+#define CE_STRING_ID_64(str) crown::string_id_internal::constant_64<crown::murmur64_constexpr(str, sizeof(str) - 1, 0)>()
@@ -12,6 +12,7 @@
 #include "core/murmur.h"
 #include "core/strings/string.inl"
 #include "core/strings/string_id.h"
+#include "core/strings/string_view.h"
 
 namespace crown
 {
@@ -36,13 +37,39 @@ namespace crown
         return a._id < b._id;
     }
 
+    // Also hashes views of the strings, to the same value as their ids,
+    // without registering them in the string_id_table like the StringId32
+    // constructors do: containers use this for heterogeneous lookup.
     template <>
     struct hash<StringId32>
     {
+        typedef void is_transparent;
+
         u32 operator()(const StringId32& id) const
         {
             return id._id;
         }
+
+        u32 operator()(const StringView& s) const
+        {
+            return murmur32(s._data, s._length, 0);
+        }
+
+        // Returns the id of the view, so that containers hash it once and
+        // then only compare ids.
+        StringId32 to_key(const StringView& s) const
+        {
+            return StringId32(murmur32(s._data, s._length, 0));
+        }
+    };
+
+    template <>
+    struct equal_to<StringId32>
+    {
+        bool operator()(const StringId32& a, const StringId32& b) const
+        {
+            return a._id == b._id;
+        }
     };
 
 #if CROWN_DEBUG
@@ -75,13 +102,39 @@ namespace crown
         return a._id < b._id;
     }
 
+    // Also hashes views of the strings, to the same value as their ids,
+    // without registering them in the string_id_table like the StringId64
+    // constructors do: containers use this for heterogeneous lookup.
     template <>
     struct hash<StringId64>
     {
+        typedef void is_transparent;
+
         u64 operator()(const StringId64& id) const
         {
             return id._id;
         }
+
+        u64 operator()(const StringView& s) const
+        {
+            return murmur64(s._data, s._length, 0);
+        }
+
+        // Returns the id of the view, so that containers hash it once and
+        // then only compare ids.
+        StringId64 to_key(const StringView& s) const
+        {
+            return StringId64(murmur64(s._data, s._length, 0));
+        }
+    };
+
+    template <>
+    struct equal_to<StringId64>
+    {
+        bool operator()(const StringId64& a, const StringId64& b) const
+        {
+            return a._id == b._id;
+        }
     };
 
 #if CROWN_DEBUG
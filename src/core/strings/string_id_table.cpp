@@ -0,0 +1,426 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/error/error.inl"
+#include "core/memory/allocator.h"
+#include "core/memory/memory.inl"
+#include "core/strings/string_id.h"
+#include "core/strings/string_id_table.h"
+#include "core/thread/scoped_mutex.inl"
+#include <atomic>
+#include <stdio.h>
+#include <string.h> // memcpy, memcmp
+
+namespace crown
+{
+
+namespace string_id_table_internal
+{
+    const u32 MAGIC = 0x54444953; // 'SIDT'
+    const u32 VERSION = 1;
+    const u32 MIN_CAPACITY = 1024;
+    const u32 CHUNK_SIZE = 64*1024;
+
+    struct Entry
+    {
+        u64 id;
+        u32 len;
+        std::atomic<const char*> str; // NULL if the slot is empty.
+    };
+
+    struct Table
+    {
+        Table* next_retired;
+        u32 capacity;
+        Entry* entries;
+    };
+
+    // Open addressing table of ids of one size. Written under the global
+    // mutex. Old tables are kept alive until shutdown so that lock-free
+    // readers never see freed memory.
+    struct IdTable
+    {
+        std::atomic<Table*> table;
+        Table* retired;
+        u32 num;
+    };
+
+    struct Chunk
+    {
+        Chunk* next;
+        u32 size;
+        u32 used;
+    };
+
+    struct Globals
+    {
+        Allocator* allocator;
+        IdTable ids[2]; // StringId32, StringId64
+        Chunk* chunks;
+        u32 num_collisions;
+        Mutex mutex;
+    };
+
+    static std::atomic<Globals*> s_globals(NULL);
+
+    static inline u32 slot(u64 id, u32 mask)
+    {
+        return u32(id ^ (id >> 32)) & mask;
+    }
+
+    static Table* create_table(Allocator& a, u32 capacity)
+    {
+        char* mem = (char*)a.allocate(sizeof(Table) + capacity*sizeof(Entry), alignof(Entry));
+        Table* t = (Table*)mem;
+        t->next_retired = NULL;
+        t->capacity = capacity;
+        t->entries = (Entry*)memory::align_top(mem + sizeof(Table), alignof(Entry));
+
+        for (u32 i = 0; i < capacity; ++i)
+        {
+            new (&t->entries[i]) Entry();
+            t->entries[i].str.store(NULL, std::memory_order_relaxed);
+        }
+
+        return t;
+    }
+
+    static const Entry* find(const Table* t, u64 id)
+    {
+        const u32 mask = t->capacity - 1;
+
+        // Tables are never more than half full, so there is always an
+        // empty slot to stop at.
+        for (u32 i = slot(id, mask); ; i = (i + 1) & mask)
+        {
+            const Entry& e = t->entries[i];
+            if (e.str.load(std::memory_order_acquire) == NULL)
+                return NULL;
+            if (e.id == id)
+                return &e;
+        }
+    }
+
+    static void insert(Table* t, u64 id, const char* str, u32 len)
+    {
+        const u32 mask = t->capacity - 1;
+        u32 i = slot(id, mask);
+
+        while (t->entries[i].str.load(std::memory_order_relaxed) != NULL)
+            i = (i + 1) & mask;
+
+        // Publish the string last: readers check it before the id.
+        t->entries[i].id = id;
+        t->entries[i].len = len;
+        t->entries[i].str.store(str, std::memory_order_release);
+    }
+
+    // Copies `str` to the arena and NUL terminates it.
+    static const char* copy_string(Globals& g, const char* str, u32 len)
+    {
+        Chunk* c = g.chunks;
+        if (c == NULL || c->used + len + 1 > c->size)
+        {
+            const u32 size = max(CHUNK_SIZE, len + 1);
+            c = (Chunk*)g.allocator->allocate(sizeof(Chunk) + size, alignof(Chunk));
+            c->next = g.chunks;
+            c->size = size;
+            c->used = 0;
+            g.chunks = c;
+        }
+
+        char* dst = (char*)(c + 1) + c->used;
+        memcpy(dst, str, len);
+        dst[len] = '\0';
+        c->used += len + 1;
+        return dst;
+    }
+
+    static bool same_string(const Entry& e, const char* str, u32 len)
+    {
+        return e.len == len && memcmp(e.str.load(std::memory_order_relaxed), str, len) == 0;
+    }
+
+    static bool add(u32 which, u64 id, const char* str, u32 len)
+    {
+        Globals* g = s_globals.load(std::memory_order_acquire);
+        if (g == NULL)
+            return true;
+
+        IdTable& ids = g->ids[which];
+
+        // Fast path, the string is already known.
+        const Table* t = ids.table.load(std::memory_order_acquire);
+        const Entry* e = find(t, id);
+        if (e != NULL && same_string(*e, str, len))
+            return true;
+
+        ScopedMutex sm(g->mutex);
+
+        Table* cur = ids.table.load(std::memory_order_relaxed);
+        e = find(cur, id);
+        if (e != NULL)
+        {
+            if (same_string(*e, str, len))
+                return true;
+
+            ++g->num_collisions;
+            return false;
+        }
+
+        if ((ids.num + 1) * 2 > cur->capacity)
+        {
+            Table* bigger = create_table(*g->allocator, cur->capacity * 2);
+            for (u32 i = 0; i < cur->capacity; ++i)
+            {
+                const Entry& old = cur->entries[i];
+                const char* s = old.str.load(std::memory_order_relaxed);
+                if (s != NULL)
+                    insert(bigger, old.id, s, old.len);
+            }
+
+            cur->next_retired = ids.retired;
+            ids.retired = cur;
+            ids.table.store(bigger, std::memory_order_release);
+            cur = bigger;
+        }
+
+        insert(cur, id, copy_string(*g, str, len), len);
+        ++ids.num;
+        return true;
+    }
+
+    static const char* lookup(u32 which, u64 id)
+    {
+        const Globals* g = s_globals.load(std::memory_order_acquire);
+        if (g == NULL)
+            return NULL;
+
+        const Entry* e = find(g->ids[which].table.load(std::memory_order_acquire), id);
+        return e != NULL ? e->str.load(std::memory_order_relaxed) : NULL;
+    }
+
+    static void destroy_tables(Allocator& a, IdTable& ids)
+    {
+        a.deallocate(ids.table.load(std::memory_order_relaxed));
+        for (Table* t = ids.retired; t != NULL; )
+        {
+            Table* next = t->next_retired;
+            a.deallocate(t);
+            t = next;
+        }
+    }
+
+    static bool write(FILE* f, const void* data, u32 size)
+    {
+        return fwrite(data, 1, size, f) == size;
+    }
+
+    static bool read(FILE* f, void* data, u32 size)
+    {
+        return fread(data, 1, size, f) == size;
+    }
+
+    // Writes the low `size` bytes of `val`, little-endian.
+    static bool write_le(FILE* f, u64 val, u32 size)
+    {
+        u8 buf[8];
+        for (u32 i = 0; i < size; ++i)
+            buf[i] = u8(val >> (i * 8));
+        return write(f, buf, size);
+    }
+
+    // Reads `size` bytes, little-endian, into `val`.
+    template <typename T>
+    static bool read_le(FILE* f, T& val, u32 size)
+    {
+        CE_ASSERT(size <= sizeof(T), "Value too small");
+        u8 buf[8];
+        if (!read(f, buf, size))
+            return false;
+
+        val = 0;
+        for (u32 i = 0; i < size; ++i)
+            val |= T(buf[i]) << (i * 8);
+        return true;
+    }
+
+    static bool save_ids(FILE* f, const IdTable& ids, u32 id_size)
+    {
+        const Table* t = ids.table.load(std::memory_order_relaxed);
+        bool ok = write_le(f, ids.num, sizeof(ids.num));
+
+        for (u32 i = 0; ok && i < t->capacity; ++i)
+        {
+            const Entry& e = t->entries[i];
+            const char* s = e.str.load(std::memory_order_relaxed);
+            if (s == NULL)
+                continue;
+
+            ok = write_le(f, e.id, id_size)
+                && write_le(f, e.len, sizeof(e.len))
+                && write(f, s, e.len)
+                ;
+        }
+
+        return ok;
+    }
+
+    static bool load_ids(FILE* f, Allocator& a, u32 which, u32 id_size)
+    {
+        u32 num = 0;
+        if (!read_le(f, num, sizeof(num)))
+            return false;
+
+        u32 buf_size = 256;
+        char* buf = (char*)a.allocate(buf_size);
+        bool ok = true;
+
+        for (u32 i = 0; ok && i < num; ++i)
+        {
+            u64 id = 0;
+            u32 len = 0;
+            ok = read_le(f, id, id_size) && read_le(f, len, sizeof(len));
+            if (!ok)
+                break;
+
+            if (len > buf_size)
+            {
+                a.deallocate(buf);
+                buf_size = len;
+                buf = (char*)a.allocate(buf_size);
+            }
+
+            ok = read(f, buf, len);
+            if (ok)
+                add(which, id, buf, len);
+        }
+
+        a.deallocate(buf);
+        return ok;
+    }
+
+} // namespace string_id_table_internal
+
+namespace string_id_table
+{
+    using namespace string_id_table_internal;
+
+    void init(Allocator& a)
+    {
+        CE_ASSERT(s_globals.load() == NULL, "Already initialized");
+
+        Globals* g = CE_NEW(a, Globals)();
+        g->allocator = &a;
+        g->chunks = NULL;
+        g->num_collisions = 0;
+
+        for (u32 i = 0; i < countof(g->ids); ++i)
+        {
+            g->ids[i].table.store(create_table(a, MIN_CAPACITY), std::memory_order_relaxed);
+            g->ids[i].retired = NULL;
+            g->ids[i].num = 0;
+        }
+
+        s_globals.store(g, std::memory_order_release);
+    }
+
+    void shutdown()
+    {
+        Globals* g = s_globals.exchange(NULL);
+        CE_ASSERT(g != NULL, "Not initialized");
+        Allocator& a = *g->allocator;
+
+        for (u32 i = 0; i < countof(g->ids); ++i)
+            destroy_tables(a, g->ids[i]);
+
+        for (Chunk* c = g->chunks; c != NULL; )
+        {
+            Chunk* next = c->next;
+            a.deallocate(c);
+            c = next;
+        }
+
+        CE_DELETE(a, g);
+    }
+
+    bool add(StringId32 id, const char* str, u32 len)
+    {
+        return string_id_table_internal::add(0, id._id, str, len);
+    }
+
+    bool add(StringId64 id, const char* str, u32 len)
+    {
+        return string_id_table_internal::add(1, id._id, str, len);
+    }
+
+    const char* lookup(StringId32 id)
+    {
+        return string_id_table_internal::lookup(0, id._id);
+    }
+
+    const char* lookup(StringId64 id)
+    {
+        return string_id_table_internal::lookup(1, id._id);
+    }
+
+    u32 num_collisions()
+    {
+        Globals* g = s_globals.load(std::memory_order_acquire);
+        if (g == NULL)
+            return 0;
+
+        ScopedMutex sm(g->mutex);
+        return g->num_collisions;
+    }
+
+    bool save(const char* path)
+    {
+        Globals* g = s_globals.load(std::memory_order_acquire);
+        CE_ASSERT(g != NULL, "Not initialized");
+
+        FILE* f = fopen(path, "wb");
+        if (f == NULL)
+            return false;
+
+        ScopedMutex sm(g->mutex);
+        const bool ok = write_le(f, MAGIC, sizeof(MAGIC))
+            && write_le(f, VERSION, sizeof(VERSION))
+            && save_ids(f, g->ids[0], sizeof(u32))
+            && save_ids(f, g->ids[1], sizeof(u64))
+            ;
+
+        return fclose(f) == 0 && ok;
+    }
+
+    bool load(const char* path)
+    {
+        Globals* g = s_globals.load(std::memory_order_acquire);
+        CE_ASSERT(g != NULL, "Not initialized");
+
+        FILE* f = fopen(path, "rb");
+        if (f == NULL)
+            return false;
+
+        u32 magic = 0;
+        u32 version = 0;
+        const bool ok = read_le(f, magic, sizeof(magic))
+            && read_le(f, version, sizeof(version))
+            && magic == MAGIC
+            && version == VERSION
+            && load_ids(f, *g->allocator, 0, sizeof(u32))
+            && load_ids(f, *g->allocator, 1, sizeof(u64))
+            ;
+
+        fclose(f);
+        return ok;
+    }
+
+} // namespace string_id_table
+
+} // namespace crown
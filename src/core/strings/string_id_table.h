@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/memory/types.h"
+#include "core/strings/types.h"
+#include "core/types.h"
+
+namespace crown
+{
+    // Global table mapping StringId32/StringId64 back to the strings they
+    // were hashed from, so logs and tools can print names instead of hex.
+    //
+    // When CROWN_STRING_ID_TABLE is enabled (the default in debug builds),
+    // memory_globals::init() creates the table and StringId32::hash() and
+    // StringId64::hash() record every string they see. Lookups never lock.
+    //
+    // File layout, little-endian:
+    //   u32 magic ('SIDT'), u32 version
+    //   u32 num, num * { u32 id, u32 len, char str[len] }   StringId32
+    //   u32 num, num * { u64 id, u32 len, char str[len] }   StringId64
+    namespace string_id_table
+    {
+        // Creates the global table. Strings are copied into an arena
+        // allocated from `a`.
+        void init(Allocator& a);
+
+        // Destroys the global table.
+        void shutdown();
+
+        // Records that `id` is the hash of the `len` characters of `str`.
+        // Returns false if `id` is already used by a different string.
+        bool add(StringId32 id, const char* str, u32 len);
+
+        // Records that `id` is the hash of the `len` characters of `str`.
+        // Returns false if `id` is already used by a different string.
+        bool add(StringId64 id, const char* str, u32 len);
+
+        // Returns the string `id` was hashed from or NULL if unknown.
+        const char* lookup(StringId32 id);
+
+        // Returns the string `id` was hashed from or NULL if unknown.
+        const char* lookup(StringId64 id);
+
+        // Returns the number of collisions detected by add().
+        u32 num_collisions();
+
+        // Writes the content of the table to the file at `path`.
+        bool save(const char* path);
+
+        // Adds the content of the file at `path` to the table.
+        bool load(const char* path);
+
+    } // namespace string_id_table
+
+} // namespace crown
@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/bits.inl"
+#include "core/error/error.inl"
+#include "core/strings/string_scan.h"
+#include "core/strings/string_view.inl"
+#include <string.h> // memcpy
+
+#if CROWN_SIMD_AVX2
+#  include <immintrin.h>
+#elif CROWN_SIMD_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace crown
+{
+
+namespace string_scan_internal
+{
+#if CROWN_SIMD_AVX2
+    typedef __m256i Vec;
+    const u32 BLOCK = 32;
+
+    static inline Vec load(const char* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static inline Vec zero() { return _mm256_setzero_si256(); }
+    static inline Vec splat(char ch) { return _mm256_set1_epi8(ch); }
+    static inline Vec eq(Vec a, Vec b) { return _mm256_cmpeq_epi8(a, b); }
+    static inline Vec or_(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm256_sub_epi8(a, b); }
+    static inline Vec min_u8(Vec a, Vec b) { return _mm256_min_epu8(a, b); }
+    static inline u32 mask(Vec a) { return u32(_mm256_movemask_epi8(a)); }
+
+    static inline u64 sum_bytes(Vec a)
+    {
+        // Four sums of at most 8 * 255, folded to two: 32 bits are enough
+        // and there is no 64-bit extract on 32-bit x86.
+        const __m256i s = _mm256_sad_epu8(a, _mm256_setzero_si256());
+        const __m128i h = _mm_add_epi64(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+        return u64(_mm_cvtsi128_si32(h)) + u64(_mm_cvtsi128_si32(_mm_srli_si128(h, 8)));
+    }
+#elif CROWN_SIMD_SSE2
+    typedef __m128i Vec;
+    const u32 BLOCK = 16;
+
+    static inline Vec load(const char* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static inline Vec zero() { return _mm_setzero_si128(); }
+    static inline Vec splat(char ch) { return _mm_set1_epi8(ch); }
+    static inline Vec eq(Vec a, Vec b) { return _mm_cmpeq_epi8(a, b); }
+    static inline Vec or_(Vec a, Vec b) { return _mm_or_si128(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm_sub_epi8(a, b); }
+    static inline Vec min_u8(Vec a, Vec b) { return _mm_min_epu8(a, b); }
+    static inline u32 mask(Vec a) { return u32(_mm_movemask_epi8(a)); }
+
+    static inline u64 sum_bytes(Vec a)
+    {
+        const __m128i s = _mm_sad_epu8(a, _mm_setzero_si128());
+        return u64(_mm_cvtsi128_si32(s)) + u64(_mm_cvtsi128_si32(_mm_srli_si128(s, 8)));
+    }
+#endif
+
+#if CROWN_SIMD_SSE2
+    // Returns a mask with the lowest `num` bits set.
+    static inline u32 low_bits(u32 num)
+    {
+        return u32((u64(1) << num) - 1);
+    }
+
+    // Loads the last n - i < BLOCK bytes of the text without reading past
+    // its end. If the text is long enough the load ends exactly at n and
+    // the bytes before i must be shifted out of the mask by `shift`,
+    // otherwise the bytes are copied and the rest of the vector is zero.
+    static inline Vec load_last(const char* data, u32 i, u32 n, u32& shift)
+    {
+        if (n >= BLOCK)
+        {
+            shift = BLOCK - (n - i);
+            return load(data + n - BLOCK);
+        }
+
+        char buf[BLOCK] = { 0 };
+        memcpy(buf, data + i, n - i);
+        shift = 0;
+        return load(buf);
+    }
+
+    // Returns the mask of the `num` bytes that start at data + i.
+    template <typename F>
+    static inline u32 block_mask(const char* data, u32 i, u32 num, u32 n, F match)
+    {
+        if (num == BLOCK)
+            return mask(match(load(data + i)));
+
+        u32 shift;
+        const Vec v = load_last(data, i, n, shift);
+        return (mask(match(v)) >> shift) & low_bits(num);
+    }
+
+    // Returns the first position in [i, n) whose byte matches `pred`, or n.
+    template <typename Pred>
+    static u32 scan(const char* data, u32 i, u32 n, const Pred& pred)
+    {
+        for (; i + 2*BLOCK <= n; i += 2*BLOCK)
+        {
+            const u64 m = u64(mask(pred.match(load(data + i))))
+                | u64(mask(pred.match(load(data + i + BLOCK)))) << BLOCK
+                ;
+            if (m != 0)
+                return i + count_trailing_zeros(m);
+        }
+
+        for (; i < n; i += BLOCK)
+        {
+            const u32 m = block_mask(data, i, min(BLOCK, n - i), n, [&](Vec v) { return pred.match(v); });
+            if (m != 0)
+                return i + count_trailing_zeros(m);
+        }
+
+        return n;
+    }
+#else
+    template <typename Pred>
+    static u32 scan(const char* data, u32 i, u32 n, const Pred& pred)
+    {
+        for (; i < n; ++i)
+        {
+            if (pred.test(data[i]))
+                return i;
+        }
+
+        return n;
+    }
+#endif
+
+    struct Byte
+    {
+        char ch;
+#if CROWN_SIMD_SSE2
+        Vec v;
+        Vec match(Vec a) const { return eq(a, v); }
+#endif
+        bool test(char c) const { return c == ch; }
+    };
+
+    // Up to MAX_SET characters are compared in vectors, larger sets use a
+    // lookup table one byte at a time.
+    const u32 MAX_SET = 16;
+
+    struct AnyOf
+    {
+        const char* set;
+        u32 num;
+#if CROWN_SIMD_SSE2
+        Vec v[MAX_SET];
+
+        Vec match(Vec a) const
+        {
+            Vec m = eq(a, v[0]);
+            for (u32 i = 1; i < num; ++i)
+                m = or_(m, eq(a, v[i]));
+            return m;
+        }
+#endif
+        bool test(char c) const { return memchr(set, c, num) != NULL; }
+    };
+
+    struct Table
+    {
+        bool table[256];
+        bool test(char c) const { return table[u8(c)]; }
+    };
+
+    struct NotSpace
+    {
+#if CROWN_SIMD_SSE2
+        Vec space;
+        Vec tab;
+        Vec four;
+
+        Vec match(Vec a) const
+        {
+            // \t \n \v \f \r are the bytes in [9, 13].
+            const Vec c = sub(a, tab);
+            const Vec is_space = or_(eq(a, space), eq(min_u8(c, four), c));
+            return eq(is_space, zero());
+        }
+#endif
+        bool test(char c) const { return !(c == ' ' || (c >= '\t' && c <= '\r')); }
+    };
+
+} // namespace string_scan_internal
+
+namespace string_scan
+{
+    using namespace string_scan_internal;
+
+    u32 find(const StringView& s, char ch, u32 from)
+    {
+        CE_ASSERT(from <= s._length, "Index out of bounds");
+        Byte pred;
+        pred.ch = ch;
+#if CROWN_SIMD_SSE2
+        pred.v = splat(ch);
+#endif
+        return scan(s._data, from, s._length, pred);
+    }
+
+    u32 find_any(const StringView& s, const char* set, u32 num, u32 from)
+    {
+        CE_ASSERT(from <= s._length, "Index out of bounds");
+
+        if (num == 0)
+            return s._length;
+
+        if (num == 1)
+            return find(s, set[0], from);
+
+        if (num > MAX_SET)
+        {
+            Table pred;
+            memset(pred.table, 0, sizeof(pred.table));
+            for (u32 i = 0; i < num; ++i)
+                pred.table[u8(set[i])] = true;
+
+            u32 i = from;
+            for (; i < s._length && !pred.test(s._data[i]); ++i)
+            {
+            }
+            return i;
+        }
+
+        AnyOf pred;
+        pred.set = set;
+        pred.num = num;
+#if CROWN_SIMD_SSE2
+        for (u32 i = 0; i < num; ++i)
+            pred.v[i] = splat(set[i]);
+#endif
+        return scan(s._data, from, s._length, pred);
+    }
+
+    u32 skip_spaces(const StringView& s, u32 from)
+    {
+        CE_ASSERT(from <= s._length, "Index out of bounds");
+        NotSpace pred;
+#if CROWN_SIMD_SSE2
+        pred.space = splat(' ');
+        pred.tab = splat('\t');
+        pred.four = splat(4);
+#endif
+        return scan(s._data, from, s._length, pred);
+    }
+
+    u32 count_newlines(const StringView& s)
+    {
+        const char* data = s._data;
+        const u32 n = s._length;
+        u32 i = 0;
+        u64 total = 0;
+
+#if CROWN_SIMD_SSE2
+        const Vec nl = splat('\n');
+        while (i + BLOCK <= n)
+        {
+            // Byte counters overflow after 255 blocks.
+            const u32 end = i + min((n - i) / BLOCK, 255u) * BLOCK;
+            Vec acc = zero();
+            for (; i < end; i += BLOCK)
+                acc = sub(acc, eq(load(data + i), nl));
+            total += sum_bytes(acc);
+        }
+
+        if (i < n)
+            total += popcount(block_mask(data, i, n - i, n, [&](Vec v) { return eq(v, nl); }));
+#else
+        for (; i < n; ++i)
+            total += data[i] == '\n';
+#endif
+
+        return u32(total);
+    }
+
+    u32 find_block_end(const StringView& s, char open, char close, u32 from)
+    {
+        CE_ASSERT(from <= s._length, "Index out of bounds");
+        CE_ASSERT(open != close, "Open and close must differ");
+
+        const char* data = s._data;
+        const u32 n = s._length;
+        u32 depth = 0;
+
+#if CROWN_SIMD_SSE2
+        const Vec vo = splat(open);
+        const Vec vc = splat(close);
+        for (u32 i = from; i < n; i += BLOCK)
+        {
+            const u32 num = min(BLOCK, n - i);
+            const u32 mo = block_mask(data, i, num, n, [&](Vec v) { return eq(v, vo); });
+            const u32 mc = block_mask(data, i, num, n, [&](Vec v) { return eq(v, vc); });
+
+            if (mo == 0)
+            {
+                // Only closes: none of them can end the block unless depth
+                // drops to zero here.
+                const u32 nc = popcount(mc);
+                if (depth > nc || depth == 0)
+                {
+                    depth -= depth != 0 ? nc : 0;
+                    continue;
+                }
+            }
+
+            for (u32 m = mo | mc; m != 0; m &= m - 1)
+            {
+                const u32 bit = count_trailing_zeros(m);
+                if ((mo >> bit) & 1)
+                    ++depth;
+                else if (depth > 0 && --depth == 0)
+                    return i + bit;
+            }
+        }
+#else
+        for (u32 i = from; i < n; ++i)
+        {
+            if (data[i] == open)
+                ++depth;
+            else if (data[i] == close && depth > 0 && --depth == 0)
+                return i;
+        }
+#endif
+
+        return n;
+    }
+
+    u32 split(const StringView& s, char delim, StringView* parts, u32 max_parts)
+    {
+        u32 num = 0;
+        u32 start = 0;
+
+        for (;;)
+        {
+            const u32 end = find(s, delim, start);
+            if (num < max_parts)
+                parts[num] = StringView(s._data + start, end - start);
+            ++num;
+
+            if (end == s._length)
+                return num;
+
+            start = end + 1;
+        }
+    }
+
+} // namespace string_scan
+
+} // namespace crown
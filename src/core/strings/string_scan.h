@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/strings/string_view.h"
+#include "core/types.h"
+
+namespace crown
+{
+    // Scanning kernels for text parsing.
+    //
+    // Unlike skip_spaces(), strnl() and skip_block() in string.inl, they
+    // work on a StringView and never read past its end, so the text does
+    // not need to be NUL-terminated. They use SSE2/AVX2 when enabled at
+    // compile time (see CROWN_SIMD_*) and fall back to scalar loops
+    // otherwise. Positions are byte offsets from the start of the view and
+    // "not found" is always reported as the length of the view.
+    namespace string_scan
+    {
+        // Returns the position of the first `ch` at or after `from`.
+        u32 find(const StringView& s, char ch, u32 from = 0);
+
+        // Returns the position of the first character at or after `from`
+        // that is one of the `num` characters in `set`.
+        u32 find_any(const StringView& s, const char* set, u32 num, u32 from = 0);
+
+        // Returns the position of the first character at or after `from`
+        // that is not a space, \t, \n, \v, \f or \r.
+        u32 skip_spaces(const StringView& s, u32 from = 0);
+
+        // Returns the number of '\n' in `s`.
+        u32 count_newlines(const StringView& s);
+
+        // Returns the position of the `close` that matches the first `open`
+        // at or after `from`. Nested blocks are skipped and unmatched
+        // `close` characters before the first `open` are ignored.
+        u32 find_block_end(const StringView& s, char open, char close, u32 from = 0);
+
+        // Splits `s` at each `delim` and writes up to `max_parts` parts to
+        // `parts`. Returns the total number of parts, which may be larger
+        // than `max_parts`. Empty parts are kept, so "a,,b" has 3 parts and
+        // an empty `s` has 1.
+        u32 split(const StringView& s, char delim, StringView* parts, u32 max_parts);
+
+    } // namespace string_scan
+
+} // namespace crown
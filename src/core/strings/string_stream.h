@@ -19,6 +19,13 @@ namespace crown
         // Retruns the stream as a NUL-terminated string.
         const char* c_str(StringStream& s);
 
+        // Appends `val` in lowercase hexadecimal, padded with zeros to at
+        // least `width` digits.
+        StringStream& stream_hex(StringStream& s, u64 val, u32 width = 0);
+
+        // Appends `val` with exactly `decimals` (<= 9) digits after the point.
+        StringStream& stream_fixed(StringStream& s, f64 val, u32 decimals);
+
         template <typename T> StringStream& stream_printf(StringStream& s, const char* format, T& val);
 
     } // namespace string_stream
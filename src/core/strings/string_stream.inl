@@ -9,11 +9,23 @@
 #pragma once
 
 #include "core/containers/array.inl"
+#include "core/strings/number_format.h"
 #include "core/strings/string.inl"
 #include "core/strings/string_stream.h"
 
 namespace crown
 {
+    namespace string_stream_internal
+    {
+        // Returns room for NUMBER_BUF_LEN characters at the end of `s`.
+        inline char* tail(StringStream& s)
+        {
+            array::reserve(s, s._size + NUMBER_BUF_LEN);
+            return s._data + s._size;
+        }
+
+    } // namespace string_stream_internal
+
     inline StringStream& operator<<(StringStream& s, char val)
     {
         array::push_back(s, val);
@@ -22,42 +34,50 @@ namespace crown
 
     inline StringStream& operator<<(StringStream& s, s16 val)
     {
-        return string_stream::stream_printf(s, "%hd", val);
+        s._size += format_s32(string_stream_internal::tail(s), val);
+        return s;
     }
 
     inline StringStream& operator<<(StringStream& s, u16 val)
     {
-        return string_stream::stream_printf(s, "%hu", val);
+        s._size += format_u32(string_stream_internal::tail(s), val);
+        return s;
     }
 
     inline StringStream& operator<<(StringStream& s, s32 val)
     {
-        return string_stream::stream_printf(s, "%d", val);
+        s._size += format_s32(string_stream_internal::tail(s), val);
+        return s;
     }
 
     inline StringStream& operator<<(StringStream& s, u32 val)
     {
-        return string_stream::stream_printf(s, "%u", val);
+        s._size += format_u32(string_stream_internal::tail(s), val);
+        return s;
     }
 
     inline StringStream& operator<<(StringStream& s, s64 val)
     {
-        return string_stream::stream_printf(s, "%lld", val);
+        s._size += format_s64(string_stream_internal::tail(s), val);
+        return s;
     }
 
     inline StringStream& operator<<(StringStream& s, u64 val)
     {
-        return string_stream::stream_printf(s, "%llu", val);
+        s._size += format_u64(string_stream_internal::tail(s), val);
+        return s;
     }
 
     inline StringStream& operator<<(StringStream& s, f32 val)
     {
-        return string_stream::stream_printf(s, "%.8g", val);
+        s._size += format_f32(string_stream_internal::tail(s), val);
+        return s;
     }
 
     inline StringStream& operator<<(StringStream& s, f64 val)
     {
-        return string_stream::stream_printf(s, "%.16g", val);
+        s._size += format_f64(string_stream_internal::tail(s), val);
+        return s;
     }
 
     inline StringStream& operator<<(StringStream& s, const char* str)
@@ -75,6 +95,18 @@ namespace crown
             return array::begin(s);
         }
 
+        inline StringStream& stream_hex(StringStream& s, u64 val, u32 width)
+        {
+            s._size += format_hex(string_stream_internal::tail(s), val, width);
+            return s;
+        }
+
+        inline StringStream& stream_fixed(StringStream& s, f64 val, u32 decimals)
+        {
+            s._size += format_fixed(string_stream_internal::tail(s), val, decimals);
+            return s;
+        }
+
         template <typename T>
         inline StringStream& stream_printf(StringStream& s, const char* format, T& val)
         {
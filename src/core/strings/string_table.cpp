@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/containers/array.inl"
+#include "core/error/error.inl"
+#include "core/memory/allocator.h"
+#include "core/murmur.h"
+#include "core/strings/string.inl"
+#include "core/strings/string_table.h"
+#include "core/strings/string_view.inl"
+#include <string.h> // memcpy, memcmp, memset
+
+namespace crown
+{
+    namespace string_table_internal
+    {
+        const u32 MAGIC = 0x54525453; // 'STRT'
+        const u32 VERSION = 2;
+        const u32 BYTE_ORDER = 0x01020304;
+        const u32 PAGE_SHIFT = 16;
+        const u32 PAGE_SIZE = 1u << PAGE_SHIFT;
+        const u32 PAGE_MASK = PAGE_SIZE - 1;
+        const u32 MIN_CAPACITY = 64;
+
+        struct Header
+        {
+            u32 magic;
+            u32 version;
+            u32 size;
+            u32 capacity;
+            u32 data_size;
+            u32 byte_order;
+        };
+
+        static inline u32 slot(u64 id, u32 mask)
+        {
+            return u32(id ^ (id >> 32)) & mask;
+        }
+
+        // Returns the slot of the string `str` with hash `id`, or the empty
+        // slot where it would go. `data(offset)` returns the string at
+        // `offset`. The index is never more than half full.
+        template <typename F>
+        static u32 find_slot(const StringTable::Entry* index, u32 capacity, u64 id, const StringView& str, F data)
+        {
+            const u32 mask = capacity - 1;
+            for (u32 i = slot(id, mask); ; i = (i + 1) & mask)
+            {
+                const StringTable::Entry& e = index[i];
+                if (e.offset == StringTable::NO_OFFSET)
+                    return i;
+                if (e.id == id && e.length == str._length && memcmp(data(e.offset), str._data, str._length) == 0)
+                    return i;
+            }
+        }
+
+        static void set_capacity(StringTable& st, u32 capacity)
+        {
+            StringTable::Entry* index = (StringTable::Entry*)st._allocator->allocate(capacity * sizeof(StringTable::Entry), alignof(StringTable::Entry));
+            memset(index, 0, capacity * sizeof(StringTable::Entry));
+            for (u32 i = 0; i < capacity; ++i)
+                index[i].offset = StringTable::NO_OFFSET;
+
+            const u32 mask = capacity - 1;
+            for (u32 i = 0; i < st._capacity; ++i)
+            {
+                const StringTable::Entry& e = st._index[i];
+                if (e.offset == StringTable::NO_OFFSET)
+                    continue;
+
+                u32 j = slot(e.id, mask);
+                while (index[j].offset != StringTable::NO_OFFSET)
+                    j = (j + 1) & mask;
+                index[j] = e;
+            }
+
+            st._allocator->deallocate(st._index);
+            st._index = index;
+            st._capacity = capacity;
+        }
+
+        // Reserves `size` contiguous bytes and returns their offset, or
+        // NO_OFFSET if offsets would not fit in 32 bits.
+        static u32 allocate(StringTable& st, u32 size)
+        {
+            const u32 pos = st._data_size & PAGE_MASK;
+            const u32 pad = pos != 0 && pos + size > PAGE_SIZE ? PAGE_SIZE - pos : 0;
+            if (u64(st._data_size) + pad + size >= u64(StringTable::NO_OFFSET))
+                return StringTable::NO_OFFSET;
+
+            if (pad != 0)
+            {
+                memset(st._pages[st._data_size >> PAGE_SHIFT].data + pos, 0, pad);
+                st._data_size += pad;
+            }
+
+            const u32 offset = st._data_size;
+
+            if ((offset >> PAGE_SHIFT) == array::size(st._pages))
+            {
+                const u32 num = (size + PAGE_MASK) >> PAGE_SHIFT;
+                char* mem = (char*)st._allocator->allocate(num * PAGE_SIZE);
+                for (u32 i = 0; i < num; ++i)
+                {
+                    StringTable::Page p;
+                    p.data = mem + i * PAGE_SIZE;
+                    p.owner = i == 0;
+                    array::push_back(st._pages, p);
+                }
+            }
+
+            st._data_size += size;
+            return offset;
+        }
+
+    } // namespace string_table_internal
+
+    StringTable::StringTable(Allocator& a)
+        : _allocator(&a)
+        , _pages(a)
+        , _index(NULL)
+        , _capacity(0)
+        , _size(0)
+        , _data_size(0)
+    {
+    }
+
+    StringTable::~StringTable()
+    {
+        clear();
+    }
+
+    u32 StringTable::add(const StringView& str)
+    {
+        using namespace string_table_internal;
+
+        const u64 id = murmur64(str._data, str._length, 0);
+        const auto data = [&](u32 o) { return c_str(o); };
+        u32 i = _capacity != 0 ? find_slot(_index, _capacity, id, str, data) : 0;
+        if (_capacity != 0 && _index[i].offset != NO_OFFSET)
+            return _index[i].offset;
+
+        // Only grow the index when inserting.
+        if ((_size + 1) * 2 > _capacity)
+        {
+            set_capacity(*this, max(MIN_CAPACITY, _capacity * 2));
+            i = find_slot(_index, _capacity, id, str, data);
+        }
+
+        const u32 offset = allocate(*this, str._length + 1);
+        if (offset == NO_OFFSET)
+            return NO_OFFSET;
+
+        Entry& e = _index[i];
+        char* dst = _pages[offset >> PAGE_SHIFT].data + (offset & PAGE_MASK);
+        memcpy(dst, str._data, str._length);
+        dst[str._length] = '\0';
+
+        e.id = id;
+        e.offset = offset;
+        e.length = str._length;
+        ++_size;
+        return offset;
+    }
+
+    u32 StringTable::find(const StringView& str) const
+    {
+        using namespace string_table_internal;
+
+        if (_size == 0)
+            return NO_OFFSET;
+
+        const u64 id = murmur64(str._data, str._length, 0);
+        const u32 i = find_slot(_index, _capacity, id, str, [&](u32 o) { return c_str(o); });
+        return _index[i].offset;
+    }
+
+    const char* StringTable::c_str(u32 offset) const
+    {
+        using namespace string_table_internal;
+        CE_ASSERT(offset < _data_size, "Index out of bounds");
+        return _pages[offset >> PAGE_SHIFT].data + (offset & PAGE_MASK);
+    }
+
+    StringView StringTable::view(u32 offset) const
+    {
+        return StringView(c_str(offset));
+    }
+
+    u32 StringTable::size() const
+    {
+        return _size;
+    }
+
+    u32 StringTable::data_size() const
+    {
+        return _data_size;
+    }
+
+    void StringTable::clear()
+    {
+        for (u32 i = 0; i < array::size(_pages); ++i)
+        {
+            if (_pages[i].owner)
+                _allocator->deallocate(_pages[i].data);
+        }
+
+        _allocator->deallocate(_index);
+
+        array::clear(_pages);
+        _index = NULL;
+        _capacity = 0;
+        _size = 0;
+        _data_size = 0;
+    }
+
+    void StringTable::save(Buffer& blob) const
+    {
+        using namespace string_table_internal;
+
+        Header h;
+        h.magic = MAGIC;
+        h.version = VERSION;
+        h.size = _size;
+        h.capacity = _capacity;
+        h.data_size = _data_size;
+        h.byte_order = BYTE_ORDER;
+
+        array::reserve(blob, array::size(blob) + sizeof(h) + h.capacity * sizeof(Entry) + _data_size);
+        array::push(blob, (const char*)&h, sizeof(h));
+        array::push(blob, (const char*)_index, h.capacity * sizeof(Entry));
+
+        for (u32 i = 0; i < array::size(_pages); ++i)
+        {
+            const u32 start = i << PAGE_SHIFT;
+            array::push(blob, _pages[i].data, min(PAGE_SIZE, _data_size - start));
+        }
+    }
+
+    StringTableBlob::StringTableBlob()
+        : _index(NULL)
+        , _data(NULL)
+        , _capacity(0)
+        , _size(0)
+        , _data_size(0)
+    {
+    }
+
+    bool StringTableBlob::open(const void* data, u32 size)
+    {
+        using namespace string_table_internal;
+        CE_ASSERT(((uintptr_t)data & 7) == 0, "Blob must be 8-byte aligned");
+
+        if (size < sizeof(Header))
+            return false;
+
+        const Header* h = (const Header*)data;
+        if (h->magic != MAGIC
+            || h->version != VERSION
+            || h->byte_order != BYTE_ORDER
+            || (h->capacity & (h->capacity - 1)) != 0
+            || h->size * 2 > h->capacity
+            || (h->capacity == 0) != (h->size == 0)
+            || u64(sizeof(Header)) + u64(h->capacity) * sizeof(StringTable::Entry) + h->data_size != size
+            )
+            return false;
+
+        const StringTable::Entry* index = (const StringTable::Entry*)(h + 1);
+        const char* strings = (const char*)(index + h->capacity);
+
+        // The strings must be NUL terminated inside the data, and the index
+        // must have empty slots left for find() to stop at.
+        if (h->data_size != 0 && strings[h->data_size - 1] != '\0')
+            return false;
+
+        u32 num = 0;
+        for (u32 i = 0; i < h->capacity; ++i)
+        {
+            const StringTable::Entry& e = index[i];
+            if (e.offset == StringTable::NO_OFFSET)
+                continue;
+
+            if (u64(e.offset) + e.length >= h->data_size || strings[e.offset + e.length] != '\0')
+                return false;
+            ++num;
+        }
+
+        if (num != h->size)
+            return false;
+
+        _index = index;
+        _data = strings;
+        _capacity = h->capacity;
+        _size = h->size;
+        _data_size = h->data_size;
+        return true;
+    }
+
+    u32 StringTableBlob::find(const StringView& str) const
+    {
+        using namespace string_table_internal;
+
+        if (_size == 0)
+            return StringTable::NO_OFFSET;
+
+        const u64 id = murmur64(str._data, str._length, 0);
+        const u32 i = find_slot(_index, _capacity, id, str, [&](u32 o) { return _data + o; });
+        return _index[i].offset;
+    }
+
+    const char* StringTableBlob::c_str(u32 offset) const
+    {
+        CE_ASSERT(offset < _data_size, "Index out of bounds");
+        return _data + offset;
+    }
+
+    StringView StringTableBlob::view(u32 offset) const
+    {
+        return StringView(c_str(offset));
+    }
+
+    u32 StringTableBlob::size() const
+    {
+        return _size;
+    }
+
+} // namespace crown
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/containers/types.h"
+#include "core/strings/string_view.h"
+#include "core/types.h"
+
+namespace crown
+{
+    // Append-only set of strings packed into large pages.
+    //
+    // Each distinct string is stored once, NUL terminated, and identified
+    // by its 32-bit offset from the start of the table. Strings never move,
+    // so offsets and the pointers returned by c_str() stay valid until the
+    // table is destroyed. Strings are deduplicated through an open
+    // addressing index keyed by their StringId64.
+    //
+    // Strings do not straddle pages, the unused tail of a page is zeroed.
+    // Strings longer than a page get a run of pages of their own.
+    //
+    // save() writes the table to a single blob that StringTableBlob reads
+    // in place, e.g. from a mapped file. Blob layout, in the byte order of
+    // the host that saved it (open() rejects blobs from the other one):
+    //   u32 magic ('STRT'), u32 version, u32 num strings,
+    //   u32 index capacity, u32 data size, u32 byte order (0x01020304)
+    //   capacity * { u64 id, u32 offset, u32 length }   Index, 0xffffffff offset if empty
+    //   data size * char                              Strings, at their offsets
+    struct StringTable
+    {
+        ALLOCATOR_AWARE;
+
+        struct Entry
+        {
+            u64 id;
+            u32 offset;
+            u32 length;
+        };
+
+        struct Page
+        {
+            char* data;
+            bool owner; // Start of an allocation.
+        };
+
+        Allocator* _allocator;
+        Array<Page> _pages;
+        Entry* _index;
+        u32 _capacity;  // Of _index, a power of two.
+        u32 _size;
+        u32 _data_size;
+
+        static const u32 NO_OFFSET = 0xffffffffu;
+
+        explicit StringTable(Allocator& a);
+        ~StringTable();
+
+        StringTable(const StringTable&) = delete;
+        StringTable& operator=(const StringTable&) = delete;
+
+        // Adds `str` to the table if it is not there already.
+        // Returns its offset, or NO_OFFSET if the table is full (4 GB).
+        u32 add(const StringView& str);
+
+        // Returns the offset of `str` or NO_OFFSET if it is not in the table.
+        u32 find(const StringView& str) const;
+
+        // Returns the string at `offset`.
+        const char* c_str(u32 offset) const;
+
+        // Returns the string at `offset`. Its length is recomputed.
+        StringView view(u32 offset) const;
+
+        // Returns the number of strings.
+        u32 size() const;
+
+        // Returns the number of bytes the strings take, page tails included.
+        u32 data_size() const;
+
+        // Removes all the strings and frees the pages.
+        void clear();
+
+        // Appends the blob of the table to `blob`.
+        void save(Buffer& blob) const;
+    };
+
+    // Read-only view of a blob written by StringTable::save(). Nothing is
+    // copied or patched: offsets are valid in both.
+    struct StringTableBlob
+    {
+        const StringTable::Entry* _index;
+        const char* _data;
+        u32 _capacity;
+        u32 _size;
+        u32 _data_size;
+
+        StringTableBlob();
+
+        // Uses the `size` bytes at `data` as the table. `data` must be 8-byte
+        // aligned and outlive this object.
+        // Returns false if it does not hold a valid blob. Every index entry
+        // is checked, so a corrupt blob can not make find() or c_str() read
+        // out of bounds.
+        bool open(const void* data, u32 size);
+
+        // Returns the offset of `str` or StringTable::NO_OFFSET if it is
+        // not in the table.
+        u32 find(const StringView& str) const;
+
+        // Returns the string at `offset`.
+        const char* c_str(u32 offset) const;
+
+        // Returns the string at `offset`. Its length is recomputed.
+        StringView view(u32 offset) const;
+
+        // Returns the number of strings.
+        u32 size() const;
+    };
+
+} // namespace crown
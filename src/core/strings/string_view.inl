@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "core/functional.h"
+#include "core/murmur.h"
 #include "core/strings/string.inl"
 #include "core/strings/string_view.h"
 
@@ -71,4 +73,15 @@ namespace crown
         return (cmp < 0) || (cmp == 0 && a._length < b._length);
     }
 
+    // Same value as the StringId32 of the string, so a view can be looked up
+    // in maps keyed by StringId32 or by owned strings without building one.
+    template <>
+    struct hash<StringView>
+    {
+        u32 operator()(const StringView& s) const
+        {
+            return murmur32(s._data, s._length, 0);
+        }
+    };
+
 } // namespace crown
@@ -15,6 +15,7 @@ namespace crown
     struct StringView;
     struct StringId32;
     struct StringId64;
+    struct StringTable;
     struct Guid;
 
 } // namespace crown
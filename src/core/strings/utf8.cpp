@@ -0,0 +1,500 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/bits.inl"
+#include "core/containers/array.inl"
+#include "core/strings/string_view.inl"
+#include "core/strings/utf8.h"
+#include <string.h> // memcpy
+
+#if CROWN_SIMD_AVX2
+#  include <immintrin.h>
+#elif CROWN_SIMD_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace crown
+{
+
+namespace utf8_internal
+{
+    // Decodes the sequence that starts at s[i] into `cp`.
+    // Returns its length or 0 if it is not valid.
+    static inline u32 decode(const u8* s, u32 i, u32 n, u32& cp)
+    {
+        const u32 c = s[i];
+        if (c < 0x80)
+        {
+            cp = c;
+            return 1;
+        }
+
+        if (c < 0xc2) // Continuation or overlong 2-byte lead.
+            return 0;
+
+        if (c < 0xe0)
+        {
+            if (n - i < 2 || (s[i + 1] & 0xc0) != 0x80)
+                return 0;
+            cp = (c & 0x1f) << 6 | (s[i + 1] & 0x3f);
+            return 2;
+        }
+
+        if (c < 0xf0)
+        {
+            if (n - i < 3 || (s[i + 1] & 0xc0) != 0x80 || (s[i + 2] & 0xc0) != 0x80)
+                return 0;
+            cp = (c & 0x0f) << 12 | (s[i + 1] & 0x3f) << 6 | (s[i + 2] & 0x3f);
+            if (cp < 0x800 || (cp >= 0xd800 && cp <= 0xdfff))
+                return 0;
+            return 3;
+        }
+
+        if (c < 0xf5)
+        {
+            if (n - i < 4 || (s[i + 1] & 0xc0) != 0x80 || (s[i + 2] & 0xc0) != 0x80 || (s[i + 3] & 0xc0) != 0x80)
+                return 0;
+            cp = (c & 0x07) << 18 | (s[i + 1] & 0x3f) << 12 | (s[i + 2] & 0x3f) << 6 | (s[i + 3] & 0x3f);
+            if (cp < 0x10000 || cp > 0x10ffff)
+                return 0;
+            return 4;
+        }
+
+        return 0;
+    }
+
+    // Encodes the valid code point `cp` at `dst`. Returns its length.
+    static inline u32 encode(u32 cp, char* dst)
+    {
+        if (cp < 0x80)
+        {
+            dst[0] = char(cp);
+            return 1;
+        }
+        if (cp < 0x800)
+        {
+            dst[0] = char(0xc0 | cp >> 6);
+            dst[1] = char(0x80 | (cp & 0x3f));
+            return 2;
+        }
+        if (cp < 0x10000)
+        {
+            dst[0] = char(0xe0 | cp >> 12);
+            dst[1] = char(0x80 | (cp >> 6 & 0x3f));
+            dst[2] = char(0x80 | (cp & 0x3f));
+            return 3;
+        }
+        dst[0] = char(0xf0 | cp >> 18);
+        dst[1] = char(0x80 | (cp >> 12 & 0x3f));
+        dst[2] = char(0x80 | (cp >> 6 & 0x3f));
+        dst[3] = char(0x80 | (cp & 0x3f));
+        return 4;
+    }
+
+#if CROWN_SIMD_SSE2
+    // Number of bytes of ASCII widened or narrowed at a time.
+    const u32 ASCII_BLOCK = 16;
+
+    static inline bool is_ascii(const u8* s)
+    {
+        return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)s)) == 0;
+    }
+
+    // Widens 16 ASCII bytes to 16-bit units.
+    static inline void widen_ascii(const u8* s, u16* dst)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)s);
+        const __m128i z = _mm_setzero_si128();
+        _mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi8(v, z));
+        _mm_storeu_si128((__m128i*)(dst + 8), _mm_unpackhi_epi8(v, z));
+    }
+
+    // Widens 16 ASCII bytes to 32-bit units.
+    static inline void widen_ascii(const u8* s, u32* dst)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)s);
+        const __m128i z = _mm_setzero_si128();
+        const __m128i lo = _mm_unpacklo_epi8(v, z);
+        const __m128i hi = _mm_unpackhi_epi8(v, z);
+        _mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi16(lo, z));
+        _mm_storeu_si128((__m128i*)(dst + 4), _mm_unpackhi_epi16(lo, z));
+        _mm_storeu_si128((__m128i*)(dst + 8), _mm_unpacklo_epi16(hi, z));
+        _mm_storeu_si128((__m128i*)(dst + 12), _mm_unpackhi_epi16(hi, z));
+    }
+
+    // Narrows 16 units to bytes if they are all ASCII.
+    static inline bool narrow_ascii(const u16* s, char* dst)
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i*)s);
+        const __m128i b = _mm_loadu_si128((const __m128i*)(s + 8));
+        const __m128i high = _mm_set1_epi16(s16(0xff80));
+        const __m128i any = _mm_and_si128(_mm_or_si128(a, b), high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(any, _mm_setzero_si128())) != 0xffff)
+            return false;
+        _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(a, b));
+        return true;
+    }
+
+    // Narrows 16 code points to bytes if they are all ASCII.
+    static inline bool narrow_ascii(const u32* s, char* dst)
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i*)s);
+        const __m128i b = _mm_loadu_si128((const __m128i*)(s + 4));
+        const __m128i c = _mm_loadu_si128((const __m128i*)(s + 8));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(s + 12));
+        const __m128i high = _mm_set1_epi32(s32(0xffffff80));
+        const __m128i any = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(any, _mm_setzero_si128())) != 0xffff)
+            return false;
+        const __m128i ab = _mm_packs_epi32(a, b);
+        const __m128i cd = _mm_packs_epi32(c, d);
+        _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(ab, cd));
+        return true;
+    }
+#endif // CROWN_SIMD_SSE2
+
+#if CROWN_SIMD_AVX2
+    // Validation with vector table lookups, after Keiser and Lemire,
+    // "Validating UTF-8 In Less Than One Instruction Per Byte" (2021).
+    // The error class of each pair of adjacent bytes is the AND of three
+    // 16-entry tables indexed by the high and low nibbles of the first byte
+    // and the high nibble of the second one. The third and fourth bytes of
+    // a sequence are checked separately against the leads two and three
+    // bytes before.
+    const u8 TOO_SHORT = 1 << 0;     // 11______ 0_______, 11______ 11______
+    const u8 TOO_LONG = 1 << 1;      // 0_______ 10______
+    const u8 OVERLONG_3 = 1 << 2;    // 11100000 100_____
+    const u8 TOO_LARGE = 1 << 3;     // 11110100 1001____ and above
+    const u8 SURROGATE = 1 << 4;     // 11101101 101_____
+    const u8 OVERLONG_2 = 1 << 5;    // 1100000_ 10______
+    const u8 TOO_LARGE_1000 = 1 << 6; // 11110101 1000____ and above
+    const u8 OVERLONG_4 = 1 << 6;    // 11110000 1000____
+    const u8 TWO_CONTS = 1 << 7;     // 10______ 10______
+    const u8 CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    static inline __m256i table(u8 t0, u8 t1, u8 t2, u8 t3, u8 t4, u8 t5, u8 t6, u8 t7
+        , u8 t8, u8 t9, u8 t10, u8 t11, u8 t12, u8 t13, u8 t14, u8 t15
+        )
+    {
+        return _mm256_setr_epi8(t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15
+            , t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15
+            );
+    }
+
+    static inline __m256i high_nibbles(__m256i v)
+    {
+        return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f));
+    }
+
+    // Returns `input` shifted N bytes later, after the last N bytes of `last`.
+    template <int N>
+    static inline __m256i prev(__m256i input, __m256i last)
+    {
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(last, input, 0x21), 16 - N);
+    }
+
+    struct Validator
+    {
+        __m256i error;
+        __m256i prev_input;
+        __m256i prev_incomplete;
+        __m256i byte_1_high;
+        __m256i byte_1_low;
+        __m256i byte_2_high;
+
+        Validator()
+        {
+            error = _mm256_setzero_si256();
+            prev_input = _mm256_setzero_si256();
+            prev_incomplete = _mm256_setzero_si256();
+
+            byte_1_high = table(TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG
+                , TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG
+                , TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS
+                , TOO_SHORT | OVERLONG_2
+                , TOO_SHORT
+                , TOO_SHORT | OVERLONG_3 | SURROGATE
+                , TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+                );
+            byte_1_low = table(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4
+                , CARRY | OVERLONG_2
+                , CARRY
+                , CARRY
+                , CARRY | TOO_LARGE
+                , CARRY | TOO_LARGE | TOO_LARGE_1000
+                , CARRY | TOO_LARGE | TOO_LARGE_1000
+                , CARRY | TOO_LARGE | TOO_LARGE_1000
+                , CARRY | TOO_LARGE | TOO_LARGE_1000
+                , CARRY | TOO_LARGE | TOO_LARGE_1000
+                , CARRY | TOO_LARGE | TOO_LARGE_1000
+                , CARRY | TOO_LARGE | TOO_LARGE_1000
+                , CARRY | TOO_LARGE | TOO_LARGE_1000
+                , CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE
+                , CARRY | TOO_LARGE | TOO_LARGE_1000
+                , CARRY | TOO_LARGE | TOO_LARGE_1000
+                );
+            byte_2_high = table(TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+                , TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+                , TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4
+                , TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE
+                , TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE
+                , TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE
+                , TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+                );
+        }
+
+        void check(__m256i input)
+        {
+            if (_mm256_movemask_epi8(input) == 0)
+            {
+                // ASCII: only a sequence cut at the end of the previous
+                // block can be wrong.
+                error = _mm256_or_si256(error, prev_incomplete);
+                prev_input = input;
+                return;
+            }
+
+            const __m256i prev1 = prev<1>(input, prev_input);
+            const __m256i special = _mm256_and_si256(_mm256_and_si256(
+                  _mm256_shuffle_epi8(byte_1_high, high_nibbles(prev1))
+                , _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, _mm256_set1_epi8(0x0f))))
+                , _mm256_shuffle_epi8(byte_2_high, high_nibbles(input))
+                );
+
+            // Bytes 2 and 3 after a 3 or 4-byte lead must be continuations,
+            // which the tables report as TWO_CONTS: the XOR clears it there
+            // and flags it everywhere else.
+            const __m256i third = _mm256_subs_epu8(prev<2>(input, prev_input), _mm256_set1_epi8(char(0xe0 - 0x80)));
+            const __m256i fourth = _mm256_subs_epu8(prev<3>(input, prev_input), _mm256_set1_epi8(char(0xf0 - 0x80)));
+            const __m256i must_be_cont = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+            error = _mm256_or_si256(error, _mm256_xor_si256(must_be_cont, special));
+
+            // Leads in the last three bytes that need more bytes than left.
+            const __m256i max_value = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1
+                , -1, -1, -1, -1, -1, -1, -1, -1
+                , -1, -1, -1, -1, -1, -1, -1, -1
+                , -1, -1, -1, -1, -1, char(0xf0 - 1), char(0xe0 - 1), char(0xc0 - 1)
+                );
+            prev_incomplete = _mm256_subs_epu8(input, max_value);
+            prev_input = input;
+        }
+
+        bool finish()
+        {
+            error = _mm256_or_si256(error, prev_incomplete);
+            return _mm256_testz_si256(error, error) != 0;
+        }
+    };
+#endif // CROWN_SIMD_AVX2
+
+    // Converts `s` to `out` one code point at a time, with `emit(cp, dst)`
+    // writing the units of `cp` at `dst` and returning their number.
+    // `max_units` is the maximum number of units per byte of `s`.
+    template <typename T, typename F>
+    static bool transcode(const StringView& s, Array<T>& out, u32 max_units, F emit)
+    {
+        const u8* src = (const u8*)s._data;
+        const u32 n = s._length;
+        const u32 old_size = array::size(out);
+        array::resize(out, old_size + n * max_units);
+        T* dst = out._data + old_size;
+
+        u32 i = 0;
+        while (i < n)
+        {
+#if CROWN_SIMD_SSE2
+            if (n - i >= ASCII_BLOCK && is_ascii(src + i))
+            {
+                widen_ascii(src + i, dst);
+                i += ASCII_BLOCK;
+                dst += ASCII_BLOCK;
+                continue;
+            }
+#endif
+            u32 cp;
+            const u32 len = decode(src, i, n, cp);
+            if (len == 0)
+            {
+                array::resize(out, old_size);
+                return false;
+            }
+            i += len;
+            dst += emit(cp, dst);
+        }
+
+        array::resize(out, u32(dst - out._data));
+        return true;
+    }
+
+} // namespace utf8_internal
+
+namespace utf8
+{
+    using namespace utf8_internal;
+
+    bool validate(const StringView& s)
+    {
+        const u8* src = (const u8*)s._data;
+        const u32 n = s._length;
+
+#if CROWN_SIMD_AVX2
+        Validator v;
+        u32 i = 0;
+        for (; i + 32 <= n; i += 32)
+            v.check(_mm256_loadu_si256((const __m256i*)(src + i)));
+
+        if (i < n)
+        {
+            // Zero padding is ASCII, so a sequence cut by the end of the
+            // text is reported as too short.
+            u8 buf[32] = { 0 };
+            memcpy(buf, src + i, n - i);
+            v.check(_mm256_loadu_si256((const __m256i*)buf));
+        }
+
+        return v.finish();
+#else
+        u32 i = 0;
+        while (i < n)
+        {
+#  if CROWN_SIMD_SSE2
+            if (n - i >= ASCII_BLOCK && is_ascii(src + i))
+            {
+                i += ASCII_BLOCK;
+                continue;
+            }
+#  endif
+            u32 cp;
+            const u32 len = decode(src, i, n, cp);
+            if (len == 0)
+                return false;
+            i += len;
+        }
+
+        return true;
+#endif
+    }
+
+    u32 count_code_points(const StringView& s)
+    {
+        const char* data = s._data;
+        const u32 n = s._length;
+        u32 i = 0;
+        u64 total = 0;
+
+#if CROWN_SIMD_SSE2
+        // Count the bytes that are not continuations: as signed bytes,
+        // continuations are the ones in [-128, -65].
+        const __m128i cont = _mm_set1_epi8(-65);
+        while (i + 16 <= n)
+        {
+            // Byte counters overflow after 255 blocks.
+            const u32 end = i + min((n - i) / 16, 255u) * 16;
+            __m128i acc = _mm_setzero_si128();
+            for (; i < end; i += 16)
+                acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(_mm_loadu_si128((const __m128i*)(data + i)), cont));
+            const __m128i sum = _mm_sad_epu8(acc, _mm_setzero_si128());
+            total += u64(_mm_cvtsi128_si32(sum)) + u64(_mm_cvtsi128_si32(_mm_srli_si128(sum, 8)));
+        }
+#endif
+        for (; i < n; ++i)
+            total += (data[i] & 0xc0) != 0x80;
+
+        return u32(total);
+    }
+
+    bool to_utf16(const StringView& s, Array<u16>& out)
+    {
+        return transcode(s, out, 1, [](u32 cp, u16* dst) -> u32 {
+            if (cp < 0x10000)
+            {
+                dst[0] = u16(cp);
+                return 1;
+            }
+            cp -= 0x10000;
+            dst[0] = u16(0xd800 | cp >> 10);
+            dst[1] = u16(0xdc00 | (cp & 0x3ff));
+            return 2;
+        });
+    }
+
+    bool to_utf32(const StringView& s, Array<u32>& out)
+    {
+        return transcode(s, out, 1, [](u32 cp, u32* dst) -> u32 {
+            dst[0] = cp;
+            return 1;
+        });
+    }
+
+    bool from_utf16(const u16* s, u32 len, Array<char>& out)
+    {
+        const u32 old_size = array::size(out);
+        array::resize(out, old_size + len * 3);
+        char* dst = out._data + old_size;
+
+        u32 i = 0;
+        while (i < len)
+        {
+#if CROWN_SIMD_SSE2
+            if (len - i >= ASCII_BLOCK && narrow_ascii(s + i, dst))
+            {
+                i += ASCII_BLOCK;
+                dst += ASCII_BLOCK;
+                continue;
+            }
+#endif
+            u32 cp = s[i++];
+            if (cp >= 0xd800 && cp <= 0xdfff)
+            {
+                if (cp >= 0xdc00 || i == len || s[i] < 0xdc00 || s[i] > 0xdfff)
+                {
+                    array::resize(out, old_size);
+                    return false;
+                }
+                cp = 0x10000 + ((cp - 0xd800) << 10 | (s[i++] - 0xdc00));
+            }
+            dst += encode(cp, dst);
+        }
+
+        array::resize(out, u32(dst - out._data));
+        return true;
+    }
+
+    bool from_utf32(const u32* s, u32 len, Array<char>& out)
+    {
+        const u32 old_size = array::size(out);
+        array::resize(out, old_size + len * 4);
+        char* dst = out._data + old_size;
+
+        u32 i = 0;
+        while (i < len)
+        {
+#if CROWN_SIMD_SSE2
+            if (len - i >= ASCII_BLOCK && narrow_ascii(s + i, dst))
+            {
+                i += ASCII_BLOCK;
+                dst += ASCII_BLOCK;
+                continue;
+            }
+#endif
+            const u32 cp = s[i++];
+            if (cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+            {
+                array::resize(out, old_size);
+                return false;
+            }
+            dst += encode(cp, dst);
+        }
+
+        array::resize(out, u32(dst - out._data));
+        return true;
+    }
+
+} // namespace utf8
+
+} // namespace crown
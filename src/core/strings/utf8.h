@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/containers/types.h"
+#include "core/strings/string_view.h"
+#include "core/types.h"
+
+namespace crown
+{
+    // UTF-8 validation and conversion to and from UTF-16 and UTF-32.
+    //
+    // Valid UTF-8 is as defined by RFC 3629: no overlong encodings, no
+    // surrogates (U+D800 to U+DFFF) and nothing above U+10FFFF. Runs of
+    // ASCII are handled 16 or 32 bytes at a time when SSE2/AVX2 are enabled
+    // (see CROWN_SIMD_*); with AVX2, validate() checks every block in
+    // vectors, multi-byte sequences included.
+    //
+    // The conversion functions append to `out`. If the input is not valid
+    // they return false and leave `out` as it was.
+    namespace utf8
+    {
+        // Returns whether `s` is valid UTF-8.
+        bool validate(const StringView& s);
+
+        // Returns the number of code points in `s`, which must be valid.
+        u32 count_code_points(const StringView& s);
+
+        // Converts the UTF-8 `s` to UTF-16, with surrogate pairs for the
+        // code points above U+FFFF.
+        bool to_utf16(const StringView& s, Array<u16>& out);
+
+        // Converts the UTF-8 `s` to UTF-32.
+        bool to_utf32(const StringView& s, Array<u32>& out);
+
+        // Converts the `len` UTF-16 units at `s` to UTF-8. Fails on unpaired
+        // surrogates.
+        bool from_utf16(const u16* s, u32 len, Array<char>& out);
+
+        // Converts the `len` code points at `s` to UTF-8. Fails on
+        // surrogates and values above U+10FFFF.
+        bool from_utf32(const u32* s, u32 len, Array<char>& out);
+
+    } // namespace utf8
+
+} // namespace crown
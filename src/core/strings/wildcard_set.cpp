@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/containers/array.inl"
+#include "core/containers/bit_array.inl"
+#include "core/error/error.inl"
+#include "core/strings/string.inl"
+#include "core/strings/string_view.inl"
+#include "core/strings/wildcard_set.h"
+#include <string.h> // memchr
+
+namespace crown
+{
+    namespace wildcard_set_internal
+    {
+        const u32 NONE = 0xffffffffu;
+        const u32 PREFIX_ROOT = 0;
+        const u32 SUFFIX_ROOT = 1;
+
+        // Compares `len` characters of `pat` and `str`, '?' matches anything.
+        static inline bool equal(const char* pat, const char* str, u32 len)
+        {
+            for (u32 i = 0; i < len; ++i)
+            {
+                if (pat[i] != str[i] && pat[i] != '?')
+                    return false;
+            }
+            return true;
+        }
+
+        // Returns the first position in [from, end) where the `len`
+        // characters of `pat` match `str`, or NONE.
+        static inline u32 search(const char* pat, u32 len, const char* str, u32 from, u32 end)
+        {
+            if (len > end - from)
+                return NONE;
+
+            const u32 last = end - len;
+            for (u32 i = from; i <= last; ++i)
+            {
+                if (pat[0] != '?')
+                {
+                    const char* p = (const char*)memchr(str + i, pat[0], last - i + 1);
+                    if (p == NULL)
+                        return NONE;
+                    i = u32(p - str);
+                }
+
+                if (equal(pat + 1, str + i + 1, len - 1))
+                    return i;
+            }
+
+            return NONE;
+        }
+
+        // Returns whether pattern `p` matches `str`, knowing that the first
+        // `known` characters of both are equal.
+        static bool matches(const WildcardSet& ws, const WildcardSet::Pattern& p, const StringView& str, u32 known)
+        {
+            const char* pat = ws._text._data + p.offset;
+            const char* s = str._data;
+            const u32 n = str._length;
+
+            if (!p.has_star)
+                return n == p.length && equal(pat + known, s + known, n - known);
+
+            if (n < p.min_length
+                || !equal(pat + p.length - p.tail, s + n - p.tail, p.tail)
+                || !equal(pat + known, s + known, p.head - known)
+                )
+                return false;
+
+            // Match the parts between the first and the last '*' as early as
+            // possible, each one after the previous.
+            u32 pos = p.head;
+            const u32 end = n - p.tail;
+            const u32 last_star = p.length - p.tail - 1;
+
+            for (u32 i = p.head + 1; i < last_star; )
+            {
+                if (pat[i] == '*')
+                {
+                    ++i;
+                    continue;
+                }
+
+                u32 len = 0;
+                while (pat[i + len] != '*')
+                    ++len;
+
+                const u32 found = search(pat + i, len, s, pos, end);
+                if (found == NONE)
+                    return false;
+
+                pos = found + len;
+                i += len;
+            }
+
+            return true;
+        }
+
+        static u32 find_child(const WildcardSet& ws, u32 node, char ch)
+        {
+            for (u32 c = ws._nodes[node].first_child; c != NONE; c = ws._nodes[c].next_sibling)
+            {
+                if (ws._nodes[c].ch == ch)
+                    return c;
+            }
+            return NONE;
+        }
+
+        static u32 add_node(WildcardSet& ws, char ch)
+        {
+            WildcardSet::Node node;
+            node.first_child = NONE;
+            node.next_sibling = NONE;
+            node.first_pattern = NONE;
+            node.ch = ch;
+            return array::push_back(ws._nodes, node);
+        }
+
+        // Adds the pattern `i` to the trie starting at `root`, following the
+        // `len` characters of `key` in the direction `step`.
+        static void insert(WildcardSet& ws, u32 root, u32 i, const char* key, u32 len, s32 step)
+        {
+            u32 node = root;
+            for (u32 j = 0; j < len; ++j, key += step)
+            {
+                u32 child = find_child(ws, node, *key);
+                if (child == NONE)
+                {
+                    child = add_node(ws, *key);
+                    ws._nodes[child].next_sibling = ws._nodes[node].first_child;
+                    ws._nodes[node].first_child = child;
+                }
+                node = child;
+            }
+
+            WildcardSet::Pattern& p = ws._patterns[i];
+            p.next = ws._nodes[node].first_pattern;
+            ws._nodes[node].first_pattern = i;
+        }
+
+        // Calls `fn(index)` for each pattern that matches `str` until it
+        // returns false.
+        template <typename F>
+        static void for_each_match(const WildcardSet& ws, const StringView& str, F fn)
+        {
+            CE_ASSERT(ws._compiled, "Not compiled");
+
+            // Patterns by literal prefix, the root holds the patterns that
+            // have neither a literal prefix nor a literal suffix.
+            u32 node = PREFIX_ROOT;
+            for (u32 depth = 0; ; ++depth)
+            {
+                for (u32 i = ws._nodes[node].first_pattern; i != NONE; i = ws._patterns[i].next)
+                {
+                    if (matches(ws, ws._patterns[i], str, depth) && !fn(i))
+                        return;
+                }
+
+                if (depth == str._length)
+                    break;
+
+                node = find_child(ws, node, str._data[depth]);
+                if (node == NONE)
+                    break;
+            }
+
+            // Patterns by literal suffix, read backwards.
+            node = SUFFIX_ROOT;
+            for (u32 depth = 0; depth < str._length; ++depth)
+            {
+                node = find_child(ws, node, str._data[str._length - 1 - depth]);
+                if (node == NONE)
+                    return;
+
+                for (u32 i = ws._nodes[node].first_pattern; i != NONE; i = ws._patterns[i].next)
+                {
+                    if (matches(ws, ws._patterns[i], str, 0) && !fn(i))
+                        return;
+                }
+            }
+        }
+
+    } // namespace wildcard_set_internal
+
+    WildcardSet::WildcardSet(Allocator& a)
+        : _text(a)
+        , _patterns(a)
+        , _nodes(a)
+        , _compiled(false)
+    {
+    }
+
+    u32 WildcardSet::add(const char* pattern)
+    {
+        Pattern p;
+        p.offset = array::size(_text);
+        p.length = strlen32(pattern);
+        p.min_length = 0;
+        p.head = p.length;
+        p.tail = 0;
+        p.next = wildcard_set_internal::NONE;
+        p.has_star = false;
+
+        for (u32 i = 0; i < p.length; ++i)
+        {
+            if (pattern[i] != '*')
+            {
+                ++p.min_length;
+                continue;
+            }
+
+            if (!p.has_star)
+                p.head = i;
+            p.tail = p.length - i - 1;
+            p.has_star = true;
+        }
+
+        array::push(_text, pattern, p.length);
+        _compiled = false;
+        return array::push_back(_patterns, p);
+    }
+
+    void WildcardSet::compile()
+    {
+        using namespace wildcard_set_internal;
+
+        array::clear(_nodes);
+        add_node(*this, '\0'); // PREFIX_ROOT
+        add_node(*this, '\0'); // SUFFIX_ROOT
+
+        for (u32 i = 0; i < array::size(_patterns); ++i)
+        {
+            const Pattern& p = _patterns[i];
+            const char* pat = _text._data + p.offset;
+
+            u32 prefix = 0;
+            while (prefix < p.head && pat[prefix] != '?')
+                ++prefix;
+
+            // Patterns without '*' are anchored at both ends.
+            const u32 tail = p.has_star ? p.tail : p.length;
+            u32 suffix = 0;
+            while (suffix < tail && pat[p.length - 1 - suffix] != '?')
+                ++suffix;
+
+            if (prefix > 0 || suffix == 0)
+                insert(*this, PREFIX_ROOT, i, pat, prefix, 1);
+            else
+                insert(*this, SUFFIX_ROOT, i, pat + p.length - 1, suffix, -1);
+        }
+
+        _compiled = true;
+    }
+
+    u32 WildcardSet::size() const
+    {
+        return array::size(_patterns);
+    }
+
+    u32 WildcardSet::match(const StringView& str, BitArray& matched) const
+    {
+        bit_array::resize(matched, size());
+        bit_array::clear_all(matched);
+
+        u32 num = 0;
+        wildcard_set_internal::for_each_match(*this, str, [&](u32 i) {
+            bit_array::set(matched, i);
+            ++num;
+            return true;
+        });
+        return num;
+    }
+
+    bool WildcardSet::match_any(const StringView& str) const
+    {
+        bool any = false;
+        wildcard_set_internal::for_each_match(*this, str, [&](u32) {
+            any = true;
+            return false;
+        });
+        return any;
+    }
+
+} // namespace crown
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/containers/types.h"
+#include "core/strings/string_view.h"
+#include "core/types.h"
+
+namespace crown
+{
+    // Set of wildcard patterns matched together against many strings.
+    //
+    // Patterns use the same syntax as wildcmp(): '*' matches any sequence
+    // of characters, '/' included, and '?' matches any single character.
+    //
+    // compile() shares the literal prefixes of all the patterns in a trie
+    // (and the literal suffixes of the patterns that start with a wildcard
+    // in a second one), so matching a string only visits the patterns it
+    // could match. Each candidate is then checked against its length and
+    // suffix before the parts between '*' are searched left to right,
+    // without backtracking.
+    struct WildcardSet
+    {
+        ALLOCATOR_AWARE;
+
+        struct Pattern
+        {
+            u32 offset;     // Into _text.
+            u32 length;
+            u32 min_length; // Of a matching string.
+            u32 head;       // Characters before the first '*'.
+            u32 tail;       // Characters after the last '*'.
+            u32 next;       // Next pattern in the same trie node.
+            bool has_star;
+        };
+
+        struct Node
+        {
+            u32 first_child;
+            u32 next_sibling;
+            u32 first_pattern;
+            char ch;
+        };
+
+        Array<char> _text;
+        Array<Pattern> _patterns;
+        Array<Node> _nodes;
+        bool _compiled;
+
+        explicit WildcardSet(Allocator& a);
+
+        // Adds `pattern` to the set and returns its index. Invalidates the
+        // compiled trie.
+        u32 add(const char* pattern);
+
+        // Builds the trie of the patterns. Must be called after the last
+        // add() and before match().
+        void compile();
+
+        // Returns the number of patterns.
+        u32 size() const;
+
+        // Resizes `matched` to size() and sets the bit of each pattern that
+        // matches `str`. Returns the number of matching patterns.
+        u32 match(const StringView& str, BitArray& matched) const;
+
+        // Returns whether any pattern matches `str`.
+        bool match_any(const StringView& str) const;
+    };
+
+} // namespace crown
@@ -0,0 +1,627 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/error/error.inl"
+#include "core/functional.inl"
+#include "core/memory/allocator.h"
+#include "core/memory/types.h"
+#include "core/thread/futex.inl"
+#include "core/thread/mutex.h"
+#include "core/thread/scoped_mutex.inl"
+#include <atomic>
+#include <string.h> // memset
+#include <type_traits>
+#include <utility> // declval
+
+namespace crown
+{
+
+    // Hash map of POD keys and values that can be read and written from
+    // many threads at once.
+    //
+    // Keys are spread over NUM_SHARDS shards, each an open addressing table
+    // with linear probing. Writers take the shard's mutex; readers never
+    // lock and use the shard's sequence counter instead (a seqlock): they
+    // retry if a writer touched the shard while they were probing it.
+    //
+    // Growing a shard allocates a new table and moves MIGRATE_STEP slots
+    // from the old table on every following write, so no single write pays
+    // for the whole rehash. The new table is twice as large when live items
+    // fill the old one, and just as large when deleted slots do. Readers
+    // look in both tables while a migration is in progress.
+    //
+    // A reader may still be probing a table after the migration is over, so
+    // old tables are only freed once no reader can see them: readers count
+    // themselves in one of two counters per shard, chosen by the shard's
+    // phase. Writers flip the phase after retiring tables, and free them
+    // once the counters of the previous phase drop to zero. The counters
+    // are striped over NUM_READER_SLOTS cache lines, each thread using its
+    // own, so readers of the same shard do not fight over one line.
+    template <typename K, typename V, typename Hash = hash<K>, typename KeyEqual = equal_to<K> >
+    struct ConcurrentHashMap
+    {
+        ALLOCATOR_AWARE;
+
+        enum
+        {
+            NUM_SHARDS = 16,
+            MIGRATE_STEP = 16,
+            MIN_CAPACITY = 16,
+            NUM_READER_SLOTS = 16
+        };
+
+        struct Entry
+        {
+            K key;
+            V value;
+        };
+
+        struct Table
+        {
+            Table* next_retired;
+            u32 capacity;
+            u32 num_used;    // Live and deleted slots.
+            u32* hashes;     // 0 = empty, 1 = deleted, hash otherwise.
+            Entry* entries;
+        };
+
+        struct Shard
+        {
+            CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<u32> version);
+            std::atomic<Table*> table;
+            std::atomic<Table*> old_table;
+            std::atomic<u32> size;
+            std::atomic<u32> phase;
+            u32 migrate_pos;
+            Table* retired;  // Retired since the last phase flip.
+            Table* draining; // Retired before the last phase flip.
+            Mutex mutex;
+        };
+
+        struct ReaderSlot
+        {
+            CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<u32> readers[NUM_SHARDS][2]);
+        };
+
+        Allocator* _allocator;
+        Shard _shards[NUM_SHARDS];
+        mutable ReaderSlot _reader_slots[NUM_READER_SLOTS];
+
+        ConcurrentHashMap(Allocator& a);
+        ~ConcurrentHashMap();
+
+        ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+        ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+        // Returns whether the given `key` exists in the map.
+        bool has(const K& key) const;
+
+        // Copies the value for the given `key` to `value`.
+        // Returns false if the `key` does not exist.
+        bool get(const K& key, V& value) const;
+
+        // Versions of has() and get() for a `key` of another type, e.g. a
+        // StringView when K is a StringId32. Only available if Hash has a
+        // to_key() for the `key`, which turns it into a K once, e.g. hashes
+        // the view into an id without registering it in the string id
+        // table.
+        template <typename KEY, typename H = Hash, typename = decltype(H().to_key(std::declval<const KEY&>()))>
+        bool has(const KEY& key) const;
+
+        template <typename KEY, typename H = Hash, typename = decltype(H().to_key(std::declval<const KEY&>()))>
+        bool get(const KEY& key, V& value) const;
+
+        // Sets the `value` for the `key` in the map.
+        void set(const K& key, const V& value);
+
+        // Removes the `key` from the map if it exists.
+        // Returns whether the `key` was removed.
+        bool remove(const K& key);
+
+        // Returns the number of items in the map. The value is only a
+        // snapshot when other threads are writing.
+        u32 size() const;
+
+        // Removes all the items in the map.
+        void clear();
+    };
+
+    namespace concurrent_hash_map_internal
+    {
+        const u32 EMPTY = 0;
+        const u32 DELETED = 1;
+        const u32 NOT_FOUND = 0xffffffffu;
+
+        // Spreads the bits of `h`, since hash<T> of integers is the identity,
+        // and makes sure the result is never EMPTY or DELETED.
+        inline u32 mix(u32 h)
+        {
+            h ^= h >> 16;
+            h *= 0x85ebca6b;
+            h ^= h >> 13;
+            h *= 0xc2b2ae35;
+            h ^= h >> 16;
+            return h | 0x80000000u;
+        }
+
+        // Top bits pick the shard, bottom bits the slot.
+        inline u32 shard_index(u32 h)
+        {
+            return (h >> 27) & 0xf;
+        }
+
+        // Returns the reader slot of the calling thread. Threads get slots
+        // round-robin the first time they read from any map.
+        inline u32 reader_slot(u32 num_slots)
+        {
+            static std::atomic<u32> s_next(0);
+            static CE_THREAD u32 t_slot = 0; // 1 + slot, 0 if not picked yet.
+            if (CE_UNLIKELY(t_slot == 0))
+                t_slot = 1 + s_next.fetch_add(1, std::memory_order_relaxed);
+            return (t_slot - 1) % num_slots;
+        }
+
+        template <typename TABLE, typename K, typename KeyEqual>
+        inline u32 find(const TABLE* t, u32 h, const K& key, KeyEqual equal)
+        {
+            const u32 mask = t->capacity - 1;
+            u32 i = h & mask;
+
+            for (u32 n = 0; n < t->capacity; ++n, i = (i + 1) & mask)
+            {
+                const u32 s = t->hashes[i];
+                if (s == EMPTY)
+                    break;
+                if (s == h && equal(t->entries[i].key, key))
+                    return i;
+            }
+
+            return NOT_FOUND;
+        }
+
+        // Stores `key` in the first free slot of its probe sequence.
+        // The `key` must not be in the table already.
+        template <typename TABLE, typename K, typename V>
+        inline void insert(TABLE* t, u32 h, const K& key, const V& value)
+        {
+            const u32 mask = t->capacity - 1;
+            u32 i = h & mask;
+
+            while (t->hashes[i] > DELETED)
+                i = (i + 1) & mask;
+
+            if (t->hashes[i] == EMPTY)
+                ++t->num_used;
+
+            t->entries[i].key = key;
+            t->entries[i].value = value;
+            t->hashes[i] = h;
+        }
+
+        template <typename MAP, typename TABLE>
+        inline void free_tables(MAP& m, TABLE* t)
+        {
+            while (t != NULL)
+            {
+                TABLE* next = t->next_retired;
+                m._allocator->deallocate(t);
+                t = next;
+            }
+        }
+
+    } // namespace concurrent_hash_map_internal
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    inline ConcurrentHashMap<K, V, Hash, KeyEqual>::ConcurrentHashMap(Allocator& a)
+        : _allocator(&a)
+    {
+        CE_STATIC_ASSERT(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value, "Keys and values must be POD");
+
+        for (u32 i = 0; i < NUM_SHARDS; ++i)
+        {
+            Shard& s = _shards[i];
+            s.version.store(0, std::memory_order_relaxed);
+            s.table.store(NULL, std::memory_order_relaxed);
+            s.old_table.store(NULL, std::memory_order_relaxed);
+            s.size.store(0, std::memory_order_relaxed);
+            s.phase.store(0, std::memory_order_relaxed);
+            s.migrate_pos = 0;
+            s.retired = NULL;
+            s.draining = NULL;
+        }
+
+        for (u32 i = 0; i < NUM_READER_SLOTS; ++i)
+        {
+            for (u32 j = 0; j < NUM_SHARDS; ++j)
+            {
+                _reader_slots[i].readers[j][0].store(0, std::memory_order_relaxed);
+                _reader_slots[i].readers[j][1].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    inline ConcurrentHashMap<K, V, Hash, KeyEqual>::~ConcurrentHashMap()
+    {
+        for (u32 i = 0; i < NUM_SHARDS; ++i)
+        {
+            Shard& s = _shards[i];
+            _allocator->deallocate(s.table.load(std::memory_order_relaxed));
+            _allocator->deallocate(s.old_table.load(std::memory_order_relaxed));
+            concurrent_hash_map_internal::free_tables(*this, s.retired);
+            concurrent_hash_map_internal::free_tables(*this, s.draining);
+        }
+    }
+
+    namespace concurrent_hash_map_internal
+    {
+        // Returns whether any reader of the shard `si` is counted in
+        // `phase`. Each reader stays in one slot from begin_read() to
+        // end_read(), so a slot never counts below zero and checking them
+        // one by one cannot miss a reader counted before the phase flip.
+        template <typename MAP>
+        inline bool has_readers(const MAP& m, u32 si, u32 phase)
+        {
+            for (u32 i = 0; i < MAP::NUM_READER_SLOTS; ++i)
+            {
+                if (m._reader_slots[i].readers[si][phase].load(std::memory_order_seq_cst) != 0)
+                    return true;
+            }
+
+            return false;
+        }
+
+        // Frees the tables that no reader of the shard `si` can see
+        // anymore. Called by writers only.
+        template <typename MAP>
+        inline void reclaim(MAP& m, u32 si)
+        {
+            auto& s = m._shards[si];
+            const u32 p = s.phase.load(std::memory_order_relaxed);
+
+            if (s.draining != NULL)
+            {
+                // Readers of the previous phase may still be probing them.
+                if (has_readers(m, si, p ^ 1))
+                    return;
+
+                free_tables(m, s.draining);
+                s.draining = NULL;
+            }
+
+            if (s.retired == NULL)
+                return;
+
+            // Readers counted in the new phase will not find the retired
+            // tables, since they were unlinked before the flip.
+            s.draining = s.retired;
+            s.retired = NULL;
+            s.phase.store(p ^ 1, std::memory_order_seq_cst);
+
+            if (!has_readers(m, si, p))
+            {
+                free_tables(m, s.draining);
+                s.draining = NULL;
+            }
+        }
+
+        // Counts the caller among the readers of the shard `si` and returns
+        // the counter it has been counted in.
+        template <typename MAP>
+        inline std::atomic<u32>& begin_read(const MAP& m, u32 si)
+        {
+            const auto& s = m._shards[si];
+            auto& slot = m._reader_slots[reader_slot(MAP::NUM_READER_SLOTS)];
+
+            for (;;)
+            {
+                const u32 p = s.phase.load(std::memory_order_seq_cst);
+                slot.readers[si][p].fetch_add(1, std::memory_order_seq_cst);
+
+                // The phase must not have flipped before the caller was
+                // counted, or a writer could miss it.
+                if (s.phase.load(std::memory_order_seq_cst) == p)
+                    return slot.readers[si][p];
+
+                slot.readers[si][p].fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        inline void end_read(std::atomic<u32>& counter)
+        {
+            counter.fetch_sub(1, std::memory_order_release);
+        }
+
+        template <typename MAP>
+        inline typename MAP::Table* create_table(MAP& m, u32 capacity)
+        {
+            typedef typename MAP::Table Table;
+            typedef typename MAP::Entry Entry;
+
+            const u32 hashes_offset = sizeof(Table);
+            const u32 entries_offset = (hashes_offset + capacity * sizeof(u32) + alignof(Entry) - 1) & ~u32(alignof(Entry) - 1);
+            const u32 size = entries_offset + capacity * sizeof(Entry);
+            const u32 align = alignof(Entry) > alignof(Table) ? alignof(Entry) : alignof(Table);
+
+            char* mem = (char*)m._allocator->allocate(size, align);
+            Table* t = (Table*)mem;
+            t->next_retired = NULL;
+            t->capacity = capacity;
+            t->num_used = 0;
+            t->hashes = (u32*)(mem + hashes_offset);
+            t->entries = (Entry*)(mem + entries_offset);
+            memset(t->hashes, 0, capacity * sizeof(u32));
+            return t;
+        }
+
+        template <typename SHARD>
+        inline void begin_write(SHARD& s)
+        {
+            const u32 v = s.version.load(std::memory_order_relaxed);
+            s.version.store(v + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        template <typename SHARD>
+        inline void end_write(SHARD& s)
+        {
+            const u32 v = s.version.load(std::memory_order_relaxed);
+            s.version.store(v + 1, std::memory_order_release);
+        }
+
+        // Moves up to `num` slots from the old table to the new one and
+        // retires the old table once it is empty.
+        template <typename SHARD>
+        inline void migrate(SHARD& s, u32 num)
+        {
+            auto* o = s.old_table.load(std::memory_order_relaxed);
+            if (o == NULL)
+                return;
+
+            auto* t = s.table.load(std::memory_order_relaxed);
+            const u32 end = o->capacity - s.migrate_pos < num ? o->capacity : s.migrate_pos + num;
+
+            for (u32 i = s.migrate_pos; i < end; ++i)
+            {
+                const u32 h = o->hashes[i];
+                if (h > DELETED)
+                {
+                    insert(t, h, o->entries[i].key, o->entries[i].value);
+                    o->hashes[i] = DELETED;
+                }
+            }
+
+            s.migrate_pos = end;
+            if (end == o->capacity)
+            {
+                s.old_table.store(NULL, std::memory_order_release);
+                o->next_retired = s.retired;
+                s.retired = o;
+            }
+        }
+
+        // Makes room for one more item in the shard's table.
+        template <typename MAP, typename SHARD>
+        inline void grow(MAP& m, SHARD& s)
+        {
+            auto* t = s.table.load(std::memory_order_relaxed);
+            if (t != NULL && (t->num_used + 1) * 4 <= t->capacity * 3)
+                return;
+
+            // Finish the previous migration before starting a new one.
+            migrate(s, 0xffffffffu);
+
+            // Keep the capacity if deleted slots, not live items, fill the
+            // table: the migration leaves them behind.
+            u32 capacity = t != NULL ? t->capacity : u32(MAP::MIN_CAPACITY);
+            while (capacity < (s.size.load(std::memory_order_relaxed) + 1) * 2)
+                capacity *= 2;
+
+            s.table.store(create_table(m, capacity), std::memory_order_release);
+            s.old_table.store(t, std::memory_order_release);
+            s.migrate_pos = 0;
+        }
+
+        // Copies the value for `key` to `value`, without locking.
+        template <typename HASH, typename KEY_EQUAL, typename MAP, typename KEY, typename V>
+        inline bool lookup(const MAP& m, const KEY& key, V& value)
+        {
+            const u32 h = mix(HASH()(key));
+            const u32 si = shard_index(h);
+            const auto& s = m._shards[si];
+            std::atomic<u32>& counter = begin_read(m, si);
+
+            for (;;)
+            {
+                const u32 v = s.version.load(std::memory_order_acquire);
+                if (v & 1)
+                {
+                    cpu_pause();
+                    continue;
+                }
+
+                bool found = false;
+                const auto* t = s.table.load(std::memory_order_acquire);
+                if (t != NULL)
+                {
+                    const u32 i = find(t, h, key, KEY_EQUAL());
+                    if (i != NOT_FOUND)
+                    {
+                        value = t->entries[i].value;
+                        found = true;
+                    }
+                }
+
+                const auto* o = s.old_table.load(std::memory_order_acquire);
+                if (!found && o != NULL)
+                {
+                    const u32 i = find(o, h, key, KEY_EQUAL());
+                    if (i != NOT_FOUND)
+                    {
+                        value = o->entries[i].value;
+                        found = true;
+                    }
+                }
+
+                // Retry if a writer touched the shard while probing.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.version.load(std::memory_order_relaxed) == v)
+                {
+                    end_read(counter);
+                    return found;
+                }
+            }
+        }
+
+    } // namespace concurrent_hash_map_internal
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    inline bool ConcurrentHashMap<K, V, Hash, KeyEqual>::has(const K& key) const
+    {
+        V value;
+        return get(key, value);
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    inline bool ConcurrentHashMap<K, V, Hash, KeyEqual>::get(const K& key, V& value) const
+    {
+        return concurrent_hash_map_internal::lookup<Hash, KeyEqual>(*this, key, value);
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename KEY, typename H, typename>
+    inline bool ConcurrentHashMap<K, V, Hash, KeyEqual>::has(const KEY& key) const
+    {
+        V value;
+        return get(key, value);
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    template <typename KEY, typename H, typename>
+    inline bool ConcurrentHashMap<K, V, Hash, KeyEqual>::get(const KEY& key, V& value) const
+    {
+        return get(Hash().to_key(key), value);
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    inline void ConcurrentHashMap<K, V, Hash, KeyEqual>::set(const K& key, const V& value)
+    {
+        using namespace concurrent_hash_map_internal;
+
+        const u32 h = mix(Hash()(key));
+        const u32 si = shard_index(h);
+        Shard& s = _shards[si];
+        ScopedMutex sm(s.mutex);
+        begin_write(s);
+
+        migrate(s, MIGRATE_STEP);
+        grow(*this, s);
+        reclaim(*this, si);
+
+        Table* t = s.table.load(std::memory_order_relaxed);
+        const u32 i = find(t, h, key, KeyEqual());
+        if (i != NOT_FOUND)
+        {
+            t->entries[i].value = value;
+        }
+        else
+        {
+            // Not migrated yet: move it over now.
+            Table* o = s.old_table.load(std::memory_order_relaxed);
+            const u32 j = o != NULL ? find(o, h, key, KeyEqual()) : NOT_FOUND;
+            if (j != NOT_FOUND)
+                o->hashes[j] = DELETED;
+            else
+                s.size.store(s.size.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            insert(t, h, key, value);
+        }
+
+        end_write(s);
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    inline bool ConcurrentHashMap<K, V, Hash, KeyEqual>::remove(const K& key)
+    {
+        using namespace concurrent_hash_map_internal;
+
+        const u32 h = mix(Hash()(key));
+        const u32 si = shard_index(h);
+        Shard& s = _shards[si];
+        ScopedMutex sm(s.mutex);
+
+        Table* t = s.table.load(std::memory_order_relaxed);
+        if (t == NULL)
+            return false;
+
+        begin_write(s);
+        migrate(s, MIGRATE_STEP);
+        reclaim(*this, si);
+
+        Table* o = s.old_table.load(std::memory_order_relaxed);
+        Table* tables[] = { t, o };
+        bool removed = false;
+
+        for (u32 k = 0; k < 2 && !removed && tables[k] != NULL; ++k)
+        {
+            const u32 i = find(tables[k], h, key, KeyEqual());
+            if (i != NOT_FOUND)
+            {
+                tables[k]->hashes[i] = DELETED;
+                s.size.store(s.size.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+                removed = true;
+            }
+        }
+
+        end_write(s);
+        return removed;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    inline u32 ConcurrentHashMap<K, V, Hash, KeyEqual>::size() const
+    {
+        u32 num = 0;
+        for (u32 i = 0; i < NUM_SHARDS; ++i)
+            num += _shards[i].size.load(std::memory_order_relaxed);
+        return num;
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual>
+    inline void ConcurrentHashMap<K, V, Hash, KeyEqual>::clear()
+    {
+        using namespace concurrent_hash_map_internal;
+
+        for (u32 i = 0; i < NUM_SHARDS; ++i)
+        {
+            Shard& s = _shards[i];
+            ScopedMutex sm(s.mutex);
+
+            Table* t = s.table.load(std::memory_order_relaxed);
+            if (t == NULL)
+                continue;
+
+            begin_write(s);
+
+            // Empty the old table so the migration retires it right away.
+            Table* o = s.old_table.load(std::memory_order_relaxed);
+            if (o != NULL)
+                memset(o->hashes, 0, o->capacity * sizeof(u32));
+            migrate(s, 0xffffffffu);
+            reclaim(*this, i);
+
+            memset(t->hashes, 0, t->capacity * sizeof(u32));
+            t->num_used = 0;
+            s.size.store(0, std::memory_order_relaxed);
+
+            end_write(s);
+        }
+    }
+
+} // namespace crown
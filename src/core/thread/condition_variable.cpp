@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/error/error.inl"
+#include "core/thread/condition_variable.h"
+#include "core/thread/futex.inl"
+#include "core/thread/mutex.h"
+#include <new>
+
+#if CROWN_PLATFORM_WINDOWS
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+namespace crown
+{
+
+struct ConditionVariable::Private
+{
+    CONDITION_VARIABLE cv;
+};
+
+ConditionVariable::ConditionVariable()
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+
+    InitializeConditionVariable(&_priv->cv);
+}
+
+ConditionVariable::~ConditionVariable()
+{
+    _priv->~Private();
+}
+
+void ConditionVariable::wait(Mutex& m)
+{
+    BOOL err = SleepConditionVariableCS(&_priv->cv, (CRITICAL_SECTION*)m.native_handle(), INFINITE);
+    CE_ASSERT(err != 0, "SleepConditionVariableCS: GetLastError = %d", GetLastError());
+    CE_UNUSED(err);
+}
+
+void ConditionVariable::signal()
+{
+    WakeConditionVariable(&_priv->cv);
+}
+
+void ConditionVariable::broadcast()
+{
+    WakeAllConditionVariable(&_priv->cv);
+}
+
+} // namespace crown
+
+#elif CROWN_FUTEX
+
+namespace crown
+{
+
+struct ConditionVariable::Private
+{
+    std::atomic<u32> seq;     // Bumped by every signal.
+    std::atomic<u32> waiters; // Threads about to sleep or sleeping.
+};
+
+ConditionVariable::ConditionVariable()
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+    _priv->seq.store(0, std::memory_order_relaxed);
+    _priv->waiters.store(0, std::memory_order_relaxed);
+}
+
+ConditionVariable::~ConditionVariable()
+{
+    CE_ASSERT(_priv->waiters.load(std::memory_order_relaxed) == 0, "ConditionVariable has waiters");
+    _priv->~Private();
+}
+
+void ConditionVariable::wait(Mutex& m)
+{
+    // The sequence is read before unlocking, so a signal sent after that
+    // makes futex::wait() return at once instead of being lost.
+    _priv->waiters.fetch_add(1, std::memory_order_seq_cst);
+    const u32 seq = _priv->seq.load(std::memory_order_seq_cst);
+    m.unlock();
+    futex::wait(_priv->seq, seq);
+    _priv->waiters.fetch_sub(1, std::memory_order_relaxed);
+    m.lock();
+}
+
+void ConditionVariable::signal()
+{
+    _priv->seq.fetch_add(1, std::memory_order_seq_cst);
+    if (_priv->waiters.load(std::memory_order_seq_cst) != 0)
+        futex::wake(_priv->seq, 1);
+}
+
+void ConditionVariable::broadcast()
+{
+    _priv->seq.fetch_add(1, std::memory_order_seq_cst);
+    if (_priv->waiters.load(std::memory_order_seq_cst) != 0)
+        futex::wake(_priv->seq, UINT32_MAX);
+}
+
+} // namespace crown
+
+#else
+
+#include <pthread.h>
+
+namespace crown
+{
+
+struct ConditionVariable::Private
+{
+    pthread_cond_t cond;
+};
+
+ConditionVariable::ConditionVariable()
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+
+    int err = pthread_cond_init(&_priv->cond, NULL);
+    CE_ASSERT(err == 0, "pthread_cond_init: errno = %d", err);
+    CE_UNUSED(err);
+}
+
+ConditionVariable::~ConditionVariable()
+{
+    int err = pthread_cond_destroy(&_priv->cond);
+    CE_ASSERT(err == 0, "pthread_cond_destroy: errno = %d", err);
+    CE_UNUSED(err);
+
+    _priv->~Private();
+}
+
+void ConditionVariable::wait(Mutex& m)
+{
+    int err = pthread_cond_wait(&_priv->cond, (pthread_mutex_t*)m.native_handle());
+    CE_ASSERT(err == 0, "pthread_cond_wait: errno = %d", err);
+    CE_UNUSED(err);
+}
+
+void ConditionVariable::signal()
+{
+    int err = pthread_cond_signal(&_priv->cond);
+    CE_ASSERT(err == 0, "pthread_cond_signal: errno = %d", err);
+    CE_UNUSED(err);
+}
+
+void ConditionVariable::broadcast()
+{
+    int err = pthread_cond_broadcast(&_priv->cond);
+    CE_ASSERT(err == 0, "pthread_cond_broadcast: errno = %d", err);
+    CE_UNUSED(err);
+}
+
+} // namespace crown
+
+#endif
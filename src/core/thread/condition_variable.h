@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/thread/types.h"
+#include "core/types.h"
+
+namespace crown
+{
+    // Condition variable, to be used with Mutex.
+    //
+    // As with any condition variable, wait() can return spuriously: always
+    // check the condition in a loop.
+    struct ConditionVariable
+    {
+        struct Private;
+        Private* _priv;
+        CE_ALIGN_DECL(16, u8 _data[64]);
+
+        ConditionVariable();
+        ~ConditionVariable();
+
+        ConditionVariable(const ConditionVariable&) = delete;
+        ConditionVariable& operator=(const ConditionVariable&) = delete;
+
+        // Unlocks `m`, which must be locked by the caller, waits to be
+        // signaled and locks `m` again.
+        void wait(Mutex& m);
+
+        // Wakes up one waiting thread.
+        void signal();
+
+        // Wakes up all waiting threads.
+        void broadcast();
+    };
+
+} // namespace crown
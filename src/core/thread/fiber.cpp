@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/error/error.inl"
+#include "core/thread/fiber.h"
+
+#if CROWN_PLATFORM_WINDOWS
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+namespace crown
+{
+
+static VOID WINAPI fiber_proc(LPVOID arg)
+{
+    Fiber* f = (Fiber*)arg;
+    f->_func(f->_user_data);
+}
+
+namespace fiber
+{
+    void init_thread(Fiber& f)
+    {
+        f._func = NULL;
+        f._user_data = NULL;
+        f._context = ConvertThreadToFiberEx(NULL, FIBER_FLAG_FLOAT_SWITCH);
+        f._sanitizer = NULL;
+        CE_ASSERT(f._context != NULL, "ConvertThreadToFiberEx: GetLastError = %d", GetLastError());
+    }
+
+    void shutdown_thread(Fiber& f)
+    {
+        BOOL err = ConvertFiberToThread();
+        CE_ASSERT(err != 0, "ConvertFiberToThread: GetLastError = %d", GetLastError());
+        CE_UNUSED(err);
+        f._context = NULL;
+    }
+
+    void create(Fiber& f, void* stack, u32 stack_size, FiberFunction func, void* user_data)
+    {
+        CE_UNUSED(stack);
+        f._func = func;
+        f._user_data = user_data;
+        f._context = CreateFiberEx(stack_size, stack_size, FIBER_FLAG_FLOAT_SWITCH, fiber_proc, &f);
+        f._sanitizer = NULL;
+        CE_ASSERT(f._context != NULL, "CreateFiberEx: GetLastError = %d", GetLastError());
+    }
+
+    void destroy(Fiber& f)
+    {
+        DeleteFiber(f._context);
+        f._context = NULL;
+    }
+
+    void switch_to(Fiber& from, Fiber& to)
+    {
+        CE_ASSERT(GetCurrentFiber() == from._context, "Not running `from`");
+        CE_UNUSED(from);
+        SwitchToFiber(to._context);
+    }
+
+} // namespace fiber
+
+} // namespace crown
+
+#elif CROWN_FIBERS
+
+#if defined(__SANITIZE_THREAD__)
+#  define CROWN_TSAN 1
+#elif defined(__has_feature)
+#  if __has_feature(thread_sanitizer)
+#    define CROWN_TSAN 1
+#  endif
+#endif
+
+#if CROWN_TSAN
+extern "C"
+{
+    void* __tsan_get_current_fiber();
+    void* __tsan_create_fiber(unsigned flags);
+    void __tsan_destroy_fiber(void* fiber);
+    void __tsan_switch_to_fiber(void* fiber, unsigned flags);
+}
+#endif
+
+#if CROWN_PLATFORM_OSX
+#  define CROWN_ASM_FUNCTION(name) ".globl _" #name "\n" "_" #name ":\n"
+#else
+#  define CROWN_ASM_FUNCTION(name) ".globl " #name "\n" ".type " #name ", @function\n" #name ":\n"
+#endif
+
+extern "C"
+{
+    // Pushes the callee-saved registers on the current stack, stores the
+    // stack pointer to `*from_sp`, then pops the registers saved on `to_sp`
+    // and returns there.
+    void crown_fiber_switch(void** from_sp, void* to_sp);
+
+    // First frame of a new fiber: calls r12(r13).
+    void crown_fiber_start();
+}
+
+// System V x86-64: rbx, rbp and r12-r15 are callee-saved, as are the
+// control bits of MXCSR and of the x87 control word.
+__asm__(
+    ".text\n"
+    ".p2align 4\n"
+    CROWN_ASM_FUNCTION(crown_fiber_switch)
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".p2align 4\n"
+    CROWN_ASM_FUNCTION(crown_fiber_start)
+    "    movq %r13, %rdi\n"
+    "    callq *%r12\n"
+    "    ud2\n"
+    );
+
+namespace crown
+{
+
+namespace fiber
+{
+    void init_thread(Fiber& f)
+    {
+        f._context = NULL;
+        f._func = NULL;
+        f._user_data = NULL;
+#if CROWN_TSAN
+        f._sanitizer = __tsan_get_current_fiber();
+#else
+        f._sanitizer = NULL;
+#endif
+    }
+
+    void shutdown_thread(Fiber& f)
+    {
+        f._context = NULL;
+        f._sanitizer = NULL;
+    }
+
+    void create(Fiber& f, void* stack, u32 stack_size, FiberFunction func, void* user_data)
+    {
+        CE_ASSERT(stack_size >= 1024, "Stack too small");
+
+        // The frame crown_fiber_switch() pops, returning to
+        // crown_fiber_start() with a 16-byte aligned stack.
+        u64* top = (u64*)(((uintptr_t)stack + stack_size) & ~uintptr_t(15));
+        u64* sp = top - 8;
+        sp[0] = 0x1f80 | (u64(0x037f) << 32); // Default MXCSR and x87 control word
+        sp[1] = 0;                            // r15
+        sp[2] = 0;                            // r14
+        sp[3] = (u64)(uintptr_t)user_data;    // r13
+        sp[4] = (u64)(uintptr_t)func;         // r12
+        sp[5] = 0;                            // rbx
+        sp[6] = 0;                            // rbp
+        sp[7] = (u64)(uintptr_t)crown_fiber_start;
+
+        f._context = sp;
+        f._func = func;
+        f._user_data = user_data;
+#if CROWN_TSAN
+        f._sanitizer = __tsan_create_fiber(0);
+#else
+        f._sanitizer = NULL;
+#endif
+    }
+
+    void destroy(Fiber& f)
+    {
+#if CROWN_TSAN
+        __tsan_destroy_fiber(f._sanitizer);
+#endif
+        f._context = NULL;
+        f._sanitizer = NULL;
+    }
+
+    void switch_to(Fiber& from, Fiber& to)
+    {
+#if CROWN_TSAN
+        __tsan_switch_to_fiber(to._sanitizer, 0);
+#endif
+        crown_fiber_switch(&from._context, to._context);
+    }
+
+} // namespace fiber
+
+} // namespace crown
+
+#endif // CROWN_FIBERS
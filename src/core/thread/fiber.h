@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/platform.h"
+#include "core/types.h"
+
+// Whether fibers are available: Windows fibers, or hand-written context
+// switching on x86-64 System V (Linux, macOS).
+#if CROWN_PLATFORM_WINDOWS || (CROWN_PLATFORM_POSIX && CROWN_CPU_X86 && CROWN_CPU_64BIT)
+#  define CROWN_FIBERS 1
+#else
+#  define CROWN_FIBERS 0
+#endif
+
+namespace crown
+{
+    typedef void (*FiberFunction)(void* user_data);
+
+    // Execution context with a stack of its own, resumed explicitly with
+    // fiber::switch_to() on any thread.
+    //
+    // Only the registers the ABI preserves across calls are switched, so
+    // a switch costs about as much as a function call.
+    struct Fiber
+    {
+        void* _context; // Stack pointer while suspended, the fiber handle on Windows.
+        FiberFunction _func;
+        void* _user_data;
+        void* _sanitizer;
+    };
+
+    namespace fiber
+    {
+        // Makes the calling thread able to switch to fibers, and `f` the
+        // context it runs in.
+        void init_thread(Fiber& f);
+
+        // Undoes init_thread(). The calling thread must be running `f`.
+        void shutdown_thread(Fiber& f);
+
+        // Makes `f` a fiber running `func(user_data)` on the `stack_size`
+        // bytes at `stack` once switched to. `func` must never return: it
+        // must switch to another fiber instead. The stack has no guard page.
+        // `f` must not move. On Windows the system allocates the stack and
+        // `stack` is unused.
+        void create(Fiber& f, void* stack, u32 stack_size, FiberFunction func, void* user_data);
+
+        // Destroys the fiber `f`, which must not be running.
+        void destroy(Fiber& f);
+
+        // Saves the context of the calling thread to `from`, the fiber it
+        // is running, and resumes `to`.
+        void switch_to(Fiber& from, Fiber& to);
+
+    } // namespace fiber
+
+} // namespace crown
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/platform.h"
+#include "core/types.h"
+#include <atomic>
+
+#if CROWN_CPU_X86
+#  include <immintrin.h> // _mm_pause
+#endif
+
+#if CROWN_PLATFORM_LINUX || CROWN_PLATFORM_ANDROID
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define CROWN_FUTEX 1
+#else
+#  define CROWN_FUTEX 0
+#endif
+
+namespace crown
+{
+    // Tells the CPU the caller is busy waiting, so that it can save power
+    // and give more resources to the other hardware thread of the core.
+    inline void cpu_pause()
+    {
+#if CROWN_CPU_X86
+        _mm_pause();
+#elif CROWN_CPU_ARM
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+#if CROWN_FUTEX
+    // Waiting on a 32-bit word, private to the process.
+    namespace futex
+    {
+        CE_STATIC_ASSERT(sizeof(std::atomic<u32>) == sizeof(u32));
+
+        // Sleeps until woken by wake() if `word` still holds `expected`.
+        // Can return spuriously.
+        inline void wait(std::atomic<u32>& word, u32 expected)
+        {
+            syscall(SYS_futex, (u32*)&word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+        }
+
+        // Wakes up to `num` threads waiting on `word`.
+        // Returns the number of threads woken up.
+        inline u32 wake(std::atomic<u32>& word, u32 num)
+        {
+            const long n = syscall(SYS_futex, (u32*)&word, FUTEX_WAKE_PRIVATE, num > 0x7fffffffu ? 0x7fffffff : s32(num), NULL, NULL, 0);
+            return n > 0 ? u32(n) : 0u;
+        }
+
+    } // namespace futex
+#endif // CROWN_FUTEX
+
+} // namespace crown
@@ -0,0 +1,498 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/containers/array.inl"
+#include "core/error/error.inl"
+#include "core/memory/allocator.h"
+#include "core/memory/memory.inl"
+#include "core/thread/fiber.h"
+#include "core/thread/futex.inl"
+#include "core/thread/job_system.h"
+#include "core/thread/mutex.h"
+#include "core/thread/thread.h"
+#include "core/thread/work_stealing_deque.inl"
+#include <stdio.h> // snprintf
+
+namespace crown
+{
+    struct JobSystem::JobFiber
+    {
+        Fiber fiber;
+        void* stack;
+        JobSystem* system;
+        Job* job;                 // The job to run next, or being run.
+        JobCounter* wait_counter; // What the fiber waits for while suspended.
+    };
+
+    struct JobSystem::FiberPool
+    {
+        JobFiber* fibers;
+        u32 num;
+        MpmcQueue<JobFiber*> free;
+        Mutex waiting_mutex;
+        Array<JobFiber*> waiting; // Fibers suspended in wait().
+        std::atomic<u32> num_waiting;
+
+        FiberPool(Allocator& a, u32 n)
+            : fibers(NULL)
+            , num(n)
+            , free(a, max(2u, n))
+            , waiting(a)
+            , num_waiting(0)
+        {
+        }
+    };
+
+    struct JobSystem::Worker
+    {
+        JobSystem* system;
+        u32 index;
+        WorkStealingDeque<Job*> deque;
+        Thread thread;
+        Fiber home;       // The worker's own stack, in fiber mode.
+        JobFiber* current; // The fiber running on the worker, if any.
+
+        Worker(JobSystem& js, u32 i, u32 capacity)
+            : system(&js)
+            , index(i)
+            , deque(*js._allocator, capacity)
+            , current(NULL)
+        {
+        }
+    };
+
+    namespace job_system_internal
+    {
+        const u32 DEQUE_CAPACITY = 4096;
+        const u32 QUEUE_CAPACITY = 4096;
+        const u32 NUM_SPINS = 256; // Idle spins before sleeping or yielding.
+        const u32 NO_WORKER = UINT32_MAX;
+
+        // The job system and worker the calling thread belongs to.
+        static CE_THREAD JobSystem* t_system;
+        static CE_THREAD JobSystem::Worker* t_worker;
+        static CE_THREAD u32 t_random;
+
+        // Not inlined: a fiber can be resumed on another thread, so the
+        // address of the thread-locals must not be kept across a switch.
+        static CE_NOINLINE JobSystem::Worker* self(JobSystem& js)
+        {
+            return t_system == &js ? t_worker : NULL;
+        }
+
+        static inline u32 random()
+        {
+            // xorshift32
+            u32 x = t_random != 0 ? t_random : u32(uintptr_t(&t_random)) | 1;
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            t_random = x;
+            return x;
+        }
+
+        static void wake(JobSystem& js, u32 num);
+
+        static inline void execute(JobSystem& js, Job* job)
+        {
+            // The job may be freed as soon as the counter drops to 0.
+            JobCounter* counter = job->counter;
+            job->func(job->user_data);
+            if (counter == NULL)
+                return;
+
+            // Pairs with park(): either we see the suspended fiber or the
+            // worker that suspended it sees the counter at 0.
+            if (counter->_value.fetch_sub(1, std::memory_order_seq_cst) == 1
+                && js._fibers != NULL
+                && js._fibers->num_waiting.load(std::memory_order_seq_cst) != 0
+                )
+                wake(js, 1);
+        }
+
+        static void fiber_main(void* user_data)
+        {
+            JobSystem::JobFiber* f = (JobSystem::JobFiber*)user_data;
+            for (;;)
+            {
+                execute(*f->system, f->job);
+
+                // Back to the worker the fiber is on now, to be reused for
+                // another job.
+                fiber::switch_to(f->fiber, self(*f->system)->home);
+            }
+        }
+
+        // Makes the suspended fiber `f` resumable.
+        static void park(JobSystem& js, JobSystem::JobFiber* f)
+        {
+            JobSystem::FiberPool& p = *js._fibers;
+            p.waiting_mutex.lock();
+            array::push_back(p.waiting, f);
+            p.num_waiting.fetch_add(1, std::memory_order_seq_cst);
+            p.waiting_mutex.unlock();
+        }
+
+        // Finds a suspended fiber whose counter dropped to 0.
+        static bool resume_ready(JobSystem& js, JobSystem::JobFiber*& f)
+        {
+            JobSystem::FiberPool& p = *js._fibers;
+            if (p.num_waiting.load(std::memory_order_seq_cst) == 0)
+                return false;
+
+            p.waiting_mutex.lock();
+            for (u32 i = 0; i < array::size(p.waiting); ++i)
+            {
+                if (p.waiting[i]->wait_counter->_value.load(std::memory_order_seq_cst) != 0)
+                    continue;
+
+                f = p.waiting[i];
+                f->wait_counter = NULL;
+                p.waiting[i] = array::back(p.waiting);
+                array::pop_back(p.waiting);
+                p.num_waiting.fetch_sub(1, std::memory_order_relaxed);
+                p.waiting_mutex.unlock();
+                return true;
+            }
+            p.waiting_mutex.unlock();
+            return false;
+        }
+
+        // Runs the fiber `f` on `w` until it finishes its job or suspends.
+        static void run_fiber(JobSystem& js, JobSystem::Worker& w, JobSystem::JobFiber* f)
+        {
+            w.current = f;
+            fiber::switch_to(w.home, f->fiber);
+            w.current = NULL;
+
+            // Only now is the context of the fiber saved.
+            if (f->wait_counter != NULL)
+                park(js, f);
+            else
+                js._fibers->free.push(f);
+        }
+
+        // Finds a job for `w`, NULL if the calling thread is not a worker.
+        static bool next_job(JobSystem& js, JobSystem::Worker* w, Job*& job)
+        {
+            if (w != NULL && w->deque.pop(job))
+                return true;
+
+            if (js._queue.pop(job))
+                return true;
+
+            // Steal, starting from a random victim to spread the thieves.
+            const u32 n = js._num_workers;
+            const u32 skip = w != NULL ? w->index : NO_WORKER;
+            const u32 start = random() % n;
+            for (u32 i = 0; i < n; ++i)
+            {
+                const u32 victim = (start + i) % n;
+                if (victim != skip && js._workers[victim].deque.steal(job))
+                    return true;
+            }
+
+            return false;
+        }
+
+        // Wakes up to `num` sleeping workers after jobs have been pushed.
+        static void wake(JobSystem& js, u32 num)
+        {
+            // Pairs with the increment of _num_sleeping in worker_main():
+            // either we see the sleeper or it sees the jobs.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // Take the workers woken off the count, or every wake() until
+            // they are up would post for them again and the extra posts
+            // would keep them from sleeping later.
+            u32 num_sleeping = js._num_sleeping.load(std::memory_order_relaxed);
+            while (num_sleeping != 0)
+            {
+                const u32 n = min(num, num_sleeping);
+                if (js._num_sleeping.compare_exchange_weak(num_sleeping, num_sleeping - n, std::memory_order_relaxed))
+                {
+                    js._wake.post(n);
+                    return;
+                }
+            }
+        }
+
+        // Takes a worker that found work before sleeping off the count.
+        // Returns false if wake() already took all the sleepers off: one
+        // of its posts is then for the caller.
+        static bool cancel_sleep(JobSystem& js)
+        {
+            u32 num_sleeping = js._num_sleeping.load(std::memory_order_relaxed);
+            while (num_sleeping != 0)
+            {
+                if (js._num_sleeping.compare_exchange_weak(num_sleeping, num_sleeping - 1, std::memory_order_relaxed))
+                    return true;
+            }
+
+            return false;
+        }
+
+        // Finds something for `w` to do: a suspended fiber to resume, in
+        // `f`, or else a job, in `job`.
+        static bool next_work(JobSystem& js, JobSystem::Worker& w, JobSystem::JobFiber*& f, Job*& job)
+        {
+            f = NULL;
+            if (js._fibers != NULL && resume_ready(js, f))
+                return true;
+
+            return next_job(js, &w, job);
+        }
+
+        static void do_work(JobSystem& js, JobSystem::Worker& w, JobSystem::JobFiber* f, Job* job)
+        {
+            if (f == NULL && js._fibers != NULL && js._fibers->free.pop(f))
+                f->job = job;
+
+            if (f != NULL)
+                run_fiber(js, w, f);
+            else
+                execute(js, job);
+        }
+
+        // Queues `job` for run(), on the deque of `w` if not NULL.
+        static void push(JobSystem& js, JobSystem::Worker* w, Job* job, JobCounter* counter)
+        {
+            job->counter = counter;
+
+            if (w != NULL)
+            {
+                if (!w->deque.push(job))
+                    execute(js, job);
+                return;
+            }
+
+            while (!js._queue.push(job))
+            {
+                // Make room by running jobs ourselves.
+                wake(js, js._num_workers);
+                Job* other;
+                if (next_job(js, NULL, other))
+                    execute(js, other);
+            }
+        }
+
+        static s32 worker_main(void* user_data)
+        {
+            JobSystem::Worker& w = *(JobSystem::Worker*)user_data;
+            JobSystem& js = *w.system;
+            t_system = &js;
+            t_worker = &w;
+            t_random = w.index * 0x9e3779b9u + 1;
+
+            if (js._fibers != NULL)
+                fiber::init_thread(w.home);
+
+            u32 idle = 0;
+            while (!js._quit.load(std::memory_order_acquire))
+            {
+                JobSystem::JobFiber* f;
+                Job* job;
+                if (next_work(js, w, f, job))
+                {
+                    do_work(js, w, f, job);
+                    idle = 0;
+                    continue;
+                }
+
+                if (++idle < NUM_SPINS)
+                {
+                    cpu_pause();
+                    continue;
+                }
+
+                idle = 0;
+                js._num_sleeping.fetch_add(1, std::memory_order_seq_cst);
+                if (next_work(js, w, f, job))
+                {
+                    // Consume the post wake() is making for us, if any,
+                    // so that it does not wake us up for nothing later.
+                    if (!cancel_sleep(js))
+                        js._wake.wait();
+                    do_work(js, w, f, job);
+                    continue;
+                }
+
+                // wake() takes us off the count.
+                js._wake.wait();
+            }
+
+            if (js._fibers != NULL)
+                fiber::shutdown_thread(w.home);
+
+            return 0;
+        }
+
+    } // namespace job_system_internal
+
+    JobSystem::JobSystem(Allocator& a, u32 num_workers, u32 num_fibers)
+        : _allocator(&a)
+        , _workers(NULL)
+        , _num_workers(num_workers)
+        , _fibers(NULL)
+        , _queue(a, job_system_internal::QUEUE_CAPACITY)
+        , _num_sleeping(0)
+        , _quit(false)
+    {
+        using namespace job_system_internal;
+
+        if (_num_workers == 0)
+        {
+            u32 cpus[256];
+            const u32 num_cores = thread::physical_cores(cpus, countof(cpus));
+            _num_workers = num_cores > 1 ? num_cores - 1 : 1;
+        }
+
+        _workers = (Worker*)a.allocate(_num_workers * sizeof(Worker), alignof(Worker));
+        for (u32 i = 0; i < _num_workers; ++i)
+            new (&_workers[i]) Worker(*this, i, DEQUE_CAPACITY);
+
+#if CROWN_FIBERS
+        if (num_fibers != 0)
+        {
+            _fibers = CE_NEW(a, FiberPool)(a, num_fibers);
+            _fibers->fibers = (JobFiber*)a.allocate(num_fibers * sizeof(JobFiber), alignof(JobFiber));
+            array::reserve(_fibers->waiting, num_fibers);
+
+            for (u32 i = 0; i < num_fibers; ++i)
+            {
+                JobFiber& f = _fibers->fibers[i];
+#if CROWN_PLATFORM_WINDOWS
+                f.stack = NULL; // Allocated by the system.
+#else
+                f.stack = a.allocate(FIBER_STACK_SIZE, 16);
+#endif
+                f.system = this;
+                f.job = NULL;
+                f.wait_counter = NULL;
+                fiber::create(f.fiber, f.stack, FIBER_STACK_SIZE, fiber_main, &f);
+                _fibers->free.push(&f);
+            }
+        }
+#else
+        CE_UNUSED(num_fibers);
+#endif
+
+        for (u32 i = 0; i < _num_workers; ++i)
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "job worker %u", i);
+            const bool started = _workers[i].thread.start(worker_main, &_workers[i]);
+            CE_ASSERT(started, "Cannot start %s", name);
+            CE_UNUSED(started);
+            _workers[i].thread.set_name(name);
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        CE_ASSERT(_queue.size() == 0, "Jobs are pending");
+
+        _quit.store(true, std::memory_order_release);
+        _wake.post(_num_workers);
+        for (u32 i = 0; i < _num_workers; ++i)
+            _workers[i].thread.join();
+
+        for (u32 i = 0; i < _num_workers; ++i)
+            _workers[i].~Worker();
+        _allocator->deallocate(_workers);
+
+        if (_fibers != NULL)
+        {
+            CE_ASSERT(_fibers->num_waiting.load(std::memory_order_relaxed) == 0, "Jobs are pending");
+            for (u32 i = 0; i < _fibers->num; ++i)
+            {
+                fiber::destroy(_fibers->fibers[i].fiber);
+                _allocator->deallocate(_fibers->fibers[i].stack);
+            }
+            _allocator->deallocate(_fibers->fibers);
+            CE_DELETE(*_allocator, _fibers);
+        }
+    }
+
+    void JobSystem::run(Job* jobs, u32 num, JobCounter* counter)
+    {
+        using namespace job_system_internal;
+
+        if (counter != NULL)
+            counter->_value.fetch_add(num, std::memory_order_relaxed);
+
+        // A worker's deque runs the newest job first, the shared queue
+        // the oldest: start jobs[0] first either way.
+        Worker* w = self(*this);
+        for (u32 i = 0; i < num; ++i)
+            push(*this, w, w != NULL ? &jobs[num - 1 - i] : &jobs[i], counter);
+
+        wake(*this, num);
+    }
+
+    void JobSystem::run(Job** jobs, u32 num, JobCounter* counter)
+    {
+        using namespace job_system_internal;
+
+        if (counter != NULL)
+            counter->_value.fetch_add(num, std::memory_order_relaxed);
+
+        // A worker's deque runs the newest job first, the shared queue
+        // the oldest: start jobs[0] first either way.
+        Worker* w = self(*this);
+        for (u32 i = 0; i < num; ++i)
+            push(*this, w, w != NULL ? jobs[num - 1 - i] : jobs[i], counter);
+
+        wake(*this, num);
+    }
+
+    void JobSystem::wait(JobCounter& counter)
+    {
+        using namespace job_system_internal;
+
+        Worker* w = self(*this);
+        if (w != NULL && w->current != NULL)
+        {
+            // On a fiber: suspend it, the worker will go on with other
+            // jobs. run_fiber() makes it resumable.
+            if (counter._value.load(std::memory_order_acquire) != 0)
+            {
+                JobFiber* f = w->current;
+                f->wait_counter = &counter;
+                fiber::switch_to(f->fiber, w->home);
+            }
+            return;
+        }
+
+        u32 idle = 0;
+        while (counter._value.load(std::memory_order_acquire) != 0)
+        {
+            Job* job;
+            if (next_job(*this, w, job))
+            {
+                execute(*this, job);
+                idle = 0;
+            }
+            else if (++idle < NUM_SPINS)
+            {
+                cpu_pause();
+            }
+            else
+            {
+                // The jobs left run on other threads.
+                thread::yield();
+            }
+        }
+    }
+
+    u32 JobSystem::num_workers() const
+    {
+        return _num_workers;
+    }
+
+} // namespace crown
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/memory/types.h"
+#include "core/thread/mpmc_queue.inl"
+#include "core/thread/semaphore.h"
+#include "core/types.h"
+#include <atomic>
+
+namespace crown
+{
+    typedef void (*JobFunction)(void* user_data);
+
+    // Number of unfinished jobs of the batches run with it.
+    struct JobCounter
+    {
+        std::atomic<u32> _value;
+
+        JobCounter() : _value(0) {}
+
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+    };
+
+    struct Job
+    {
+        JobFunction func;
+        void* user_data;
+        JobCounter* counter; // Set by JobSystem::run().
+    };
+
+    // Runs jobs on a pool of worker threads, one per physical core.
+    //
+    // Each worker owns a work-stealing deque. Jobs run from a worker go to
+    // its own deque, which it empties newest first; idle workers steal the
+    // oldest jobs of the others. Jobs run from other threads (e.g. the main
+    // and render threads) go through a shared queue.
+    //
+    // Waiting for a counter never blocks: the waiting thread runs other
+    // jobs until the counter drops to 0, so jobs can wait for jobs they
+    // started. Workers with nothing to do spin for a while, then sleep
+    // until new jobs are run.
+    //
+    // In fiber mode, workers run jobs on a pool of fibers whose stacks come
+    // from the allocator. A job waiting for a counter on a worker suspends
+    // its fiber instead of helping, and the worker goes on with other jobs;
+    // any worker resumes the fiber once the counter drops to 0. Such a job
+    // may thus wait on one thread and wake up on another: it must not hold
+    // a Mutex or rely on thread-local state across a wait. When all the
+    // fibers are in use, jobs run on the worker's stack and wait by helping.
+    struct JobSystem
+    {
+        struct Worker;
+        struct JobFiber;
+        struct FiberPool;
+
+        Allocator* _allocator;
+        Worker* _workers;
+        u32 _num_workers;
+        FiberPool* _fibers; // NULL unless in fiber mode.
+        MpmcQueue<Job*> _queue; // Jobs run by threads that are not workers.
+        Semaphore _wake;
+        CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<u32> _num_sleeping);
+        std::atomic<bool> _quit;
+
+        static const u32 FIBER_STACK_SIZE = 64*1024;
+
+        // Starts `num_workers` workers, or one per physical core but the
+        // one of the calling thread if 0. Runs in fiber mode with a pool of
+        // `num_fibers` fibers if not 0 and fibers are available (see
+        // CROWN_FIBERS).
+        explicit JobSystem(Allocator& a, u32 num_workers = 0, u32 num_fibers = 0);
+
+        // Stops the workers. No jobs must be pending.
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // Runs the `num` jobs at `jobs` and adds them to `counter`, if not
+        // NULL. Jobs earlier in the array are started first, unless other
+        // threads steal them. The jobs must stay valid until they finish,
+        // i.e. until wait(counter) returns.
+        void run(Job* jobs, u32 num, JobCounter* counter);
+
+        // Same as above, for the `num` jobs pointed to by `jobs`.
+        void run(Job** jobs, u32 num, JobCounter* counter);
+
+        // Runs other jobs until all the jobs added to `counter` finish.
+        void wait(JobCounter& counter);
+
+        // Returns the number of worker threads.
+        u32 num_workers() const;
+    };
+
+} // namespace crown
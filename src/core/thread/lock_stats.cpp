@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/thread/lock_stats.h"
+#include "core/thread/thread.h"
+#include <chrono>
+#include <string.h> // strcmp
+
+namespace crown
+{
+    namespace lock_stats_internal
+    {
+        const u32 MAX_NAMES = 256;
+
+        // Zero-initialized before any constructor runs, so that locks with
+        // static storage can be named.
+        static LockCounters s_counters[MAX_NAMES];
+        static std::atomic<u32> s_num(0);
+        static std::atomic<u32> s_adding(0);
+
+    } // namespace lock_stats_internal
+
+    namespace lock_stats
+    {
+        LockCounters* counters(const char* name)
+        {
+            using namespace lock_stats_internal;
+
+            while (s_adding.exchange(1, std::memory_order_acquire) != 0)
+                thread::yield();
+
+            LockCounters* c = NULL;
+            const u32 num = s_num.load(std::memory_order_relaxed);
+            for (u32 i = 0; i < num && c == NULL; ++i)
+            {
+                if (strcmp(s_counters[i].name, name) == 0)
+                    c = &s_counters[i];
+            }
+
+            if (c == NULL && num < MAX_NAMES)
+            {
+                c = &s_counters[num];
+                c->name = name;
+                s_num.store(num + 1, std::memory_order_release);
+            }
+
+            s_adding.store(0, std::memory_order_release);
+            return c;
+        }
+
+        u64 now()
+        {
+            using namespace std::chrono;
+            return u64(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+        }
+
+        u32 get(LockStats* stats, u32 max)
+        {
+            using namespace lock_stats_internal;
+
+            const u32 num = s_num.load(std::memory_order_acquire);
+            for (u32 i = 0; i < num && i < max; ++i)
+            {
+                const LockCounters& c = s_counters[i];
+                stats[i].name = c.name;
+                stats[i].num_acquires = c.num_acquires.load(std::memory_order_relaxed);
+                stats[i].num_contended = c.num_contended.load(std::memory_order_relaxed);
+                stats[i].wait_ns = c.wait_ns.load(std::memory_order_relaxed);
+            }
+
+            return num;
+        }
+
+        void reset()
+        {
+            using namespace lock_stats_internal;
+
+            const u32 num = s_num.load(std::memory_order_acquire);
+            for (u32 i = 0; i < num; ++i)
+            {
+                s_counters[i].num_acquires.store(0, std::memory_order_relaxed);
+                s_counters[i].num_contended.store(0, std::memory_order_relaxed);
+                s_counters[i].wait_ns.store(0, std::memory_order_relaxed);
+            }
+        }
+
+    } // namespace lock_stats
+
+} // namespace crown
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/types.h"
+#include <atomic>
+
+namespace crown
+{
+    // Contention counters of the locks with a given name.
+    struct LockStats
+    {
+        const char* name;
+        u64 num_acquires;   // Including the contended ones.
+        u64 num_contended;  // Acquisitions that had to wait.
+        u64 wait_ns;        // Time spent waiting, in nanoseconds.
+    };
+
+    // Counters updated by the locks, shared by all the locks with the same
+    // name.
+    struct LockCounters
+    {
+        const char* name;
+        std::atomic<u64> num_acquires;
+        std::atomic<u64> num_contended;
+        std::atomic<u64> wait_ns;
+    };
+
+    // Lock instrumentation.
+    //
+    // When CROWN_LOCK_STATS is enabled, Mutex, ReadWriteLock and SpinLock
+    // constructed with a name count their acquisitions here. Unnamed locks
+    // are never counted. Only contended acquisitions read the clock, so the
+    // cost of an uncontended one is a relaxed increment.
+    namespace lock_stats
+    {
+        // Returns the counters for `name`, created the first time. `name`
+        // must outlive the program, e.g. a string literal. Returns NULL if
+        // too many names are used.
+        LockCounters* counters(const char* name);
+
+        // Returns the time in nanoseconds from an arbitrary epoch.
+        u64 now();
+
+        // Counts an acquisition that did not wait.
+        inline void acquired(LockCounters* c)
+        {
+            if (c != NULL)
+                c->num_acquires.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Counts an acquisition that started to wait at `start`, see now().
+        inline void acquired(LockCounters* c, u64 start)
+        {
+            if (c != NULL)
+            {
+                c->num_acquires.fetch_add(1, std::memory_order_relaxed);
+                c->num_contended.fetch_add(1, std::memory_order_relaxed);
+                c->wait_ns.fetch_add(now() - start, std::memory_order_relaxed);
+            }
+        }
+
+        // Copies the stats of up to `max` names to `stats`.
+        // Returns the number of names.
+        u32 get(LockStats* stats, u32 max);
+
+        // Sets all the counters to zero.
+        void reset();
+
+    } // namespace lock_stats
+
+} // namespace crown
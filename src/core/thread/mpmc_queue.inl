@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/error/error.inl"
+#include "core/memory/allocator.h"
+#include "core/thread/queue_stats.h"
+#include <atomic>
+#include <new>
+
+namespace crown
+{
+
+    // Bounded multi-producer/multi-consumer queue of POD items.
+    //
+    // Dmitry Vyukov's bounded MPMC queue:
+    // http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+    //
+    // Each cell carries a sequence number telling whether it is ready to be
+    // written (sequence == position) or read (sequence == position + 1), so
+    // producers and consumers only contend on their own position counter
+    // with a single CAS and never block each other.
+    template <typename T>
+    struct MpmcQueue
+    {
+        struct Cell
+        {
+            std::atomic<u32> sequence;
+            T item;
+        };
+
+        Allocator* _allocator;
+        Cell* _cells;
+        u32 _mask;
+
+        // Producers and consumers live on separate cache lines.
+        CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<u32> _enqueue_pos);
+        CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<u32> _dequeue_pos);
+        CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<u32> _num_full);
+        std::atomic<u32> _num_empty;
+
+        // Creates a queue holding up to `capacity` items, rounded up to the
+        // next power of two.
+        MpmcQueue(Allocator& a, u32 capacity);
+        ~MpmcQueue();
+
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        // Appends `item` to the queue.
+        // Returns false if the queue is full.
+        bool push(const T& item);
+
+        // Removes the oldest item from the queue and copies it to `item`.
+        // Returns false if the queue is empty.
+        bool pop(T& item);
+
+        // Returns the maximum number of items the queue can hold.
+        u32 capacity() const;
+
+        // Returns the number of items in the queue. The value is only a
+        // snapshot when other threads are pushing or popping.
+        u32 size() const;
+
+        // Returns the number of failed pushes and pops so far.
+        QueueStats stats() const;
+    };
+
+    namespace queue_internal
+    {
+        inline u32 next_pow2(u32 x)
+        {
+            x -= 1;
+            x |= x >> 1;
+            x |= x >> 2;
+            x |= x >> 4;
+            x |= x >> 8;
+            x |= x >> 16;
+            return x + 1;
+        }
+
+    } // namespace queue_internal
+
+    template <typename T>
+    inline MpmcQueue<T>::MpmcQueue(Allocator& a, u32 capacity)
+        : _allocator(&a)
+        , _cells(NULL)
+        , _mask(0)
+        , _enqueue_pos(0)
+        , _dequeue_pos(0)
+        , _num_full(0)
+        , _num_empty(0)
+    {
+        CE_ASSERT(capacity >= 2, "Capacity must be >= 2");
+        capacity = queue_internal::next_pow2(capacity);
+
+        _cells = (Cell*)a.allocate(capacity * sizeof(Cell), alignof(Cell));
+        _mask = capacity - 1;
+
+        for (u32 i = 0; i < capacity; ++i)
+        {
+            new (&_cells[i]) Cell();
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    inline MpmcQueue<T>::~MpmcQueue()
+    {
+        _allocator->deallocate(_cells);
+    }
+
+    template <typename T>
+    inline bool MpmcQueue<T>::push(const T& item)
+    {
+        Cell* cell;
+        u32 pos = _enqueue_pos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &_cells[pos & _mask];
+            const u32 seq = cell->sequence.load(std::memory_order_acquire);
+            const s32 diff = s32(seq - pos);
+
+            if (diff == 0)
+            {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // The cell still holds the item from the previous lap.
+                _num_full.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    inline bool MpmcQueue<T>::pop(T& item)
+    {
+        Cell* cell;
+        u32 pos = _dequeue_pos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &_cells[pos & _mask];
+            const u32 seq = cell->sequence.load(std::memory_order_acquire);
+            const s32 diff = s32(seq - (pos + 1));
+
+            if (diff == 0)
+            {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // The cell has not been written in this lap yet.
+                _num_empty.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = cell->item;
+        cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    inline u32 MpmcQueue<T>::capacity() const
+    {
+        return _mask + 1;
+    }
+
+    template <typename T>
+    inline u32 MpmcQueue<T>::size() const
+    {
+        const u32 tail = _dequeue_pos.load(std::memory_order_relaxed);
+        const u32 head = _enqueue_pos.load(std::memory_order_relaxed);
+        const s32 size = s32(head - tail);
+        return size < 0 ? 0 : min(u32(size), _mask + 1);
+    }
+
+    template <typename T>
+    inline QueueStats MpmcQueue<T>::stats() const
+    {
+        QueueStats qs;
+        qs.num_full = _num_full.load(std::memory_order_relaxed);
+        qs.num_empty = _num_empty.load(std::memory_order_relaxed);
+        return qs;
+    }
+
+} // namespace crown
@@ -6,7 +6,10 @@
  * @date     2021-03-30
  */
 
+#include "config.h"
 #include "core/error/error.inl"
+#include "core/thread/futex.inl"
+#include "core/thread/lock_stats.h"
 #include "core/thread/mutex.h"
 #include <new>
 
@@ -22,12 +25,20 @@ namespace crown
 struct Private
 {
     CRITICAL_SECTION cs;
+#if CROWN_LOCK_STATS
+    LockCounters* stats;
+#endif
 };
 
-Mutex::Mutex()
+Mutex::Mutex(const char* name)
 {
     CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
     _priv = new (_data) Private();
+#if CROWN_LOCK_STATS
+    _priv->stats = name != NULL ? lock_stats::counters(name) : NULL;
+#else
+    CE_UNUSED(name);
+#endif
 
     InitializeCriticalSection(&_priv->cs);
 }
@@ -41,7 +52,30 @@ Mutex::~Mutex()
 
 void Mutex::lock()
 {
+#if CROWN_LOCK_STATS
+    if (TryEnterCriticalSection(&_priv->cs) != 0)
+    {
+        lock_stats::acquired(_priv->stats);
+        return;
+    }
+
+    const u64 start = _priv->stats != NULL ? lock_stats::now() : 0;
+    EnterCriticalSection(&_priv->cs);
+    lock_stats::acquired(_priv->stats, start);
+#else
     EnterCriticalSection(&_priv->cs);
+#endif
+}
+
+bool Mutex::try_lock()
+{
+    if (TryEnterCriticalSection(&_priv->cs) == 0)
+        return false;
+
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+    return true;
 }
 
 void Mutex::unlock()
@@ -56,6 +90,150 @@ void* Mutex::native_handle()
 
 } // namespacr crown
 
+#elif CROWN_FUTEX
+
+namespace crown
+{
+
+// States of the futex word.
+static const u32 UNLOCKED = 0;
+static const u32 LOCKED = 1;
+static const u32 CONTENDED = 2; // Locked, maybe with sleeping waiters.
+
+// Bounds the number of spins. The same as glibc's adaptive mutexes.
+static const s32 MAX_SPINS = 100;
+
+struct Private
+{
+    std::atomic<u32> state;
+    std::atomic<s32> spins; // Moving average of the spins that lock() needed.
+#if CROWN_DEBUG
+    std::atomic<u32> owner;
+#endif
+#if CROWN_LOCK_STATS
+    LockCounters* stats;
+#endif
+};
+
+#if CROWN_DEBUG
+static u32 current_tid()
+{
+    static CE_THREAD u32 tid = 0;
+    if (tid == 0)
+        tid = u32(syscall(SYS_gettid));
+    return tid;
+}
+#endif
+
+Mutex::Mutex(const char* name)
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+#if CROWN_LOCK_STATS
+    _priv->stats = name != NULL ? lock_stats::counters(name) : NULL;
+#else
+    CE_UNUSED(name);
+#endif
+    _priv->state.store(UNLOCKED, std::memory_order_relaxed);
+    _priv->spins.store(0, std::memory_order_relaxed);
+#if CROWN_DEBUG
+    _priv->owner.store(0, std::memory_order_relaxed);
+#endif
+}
+
+Mutex::~Mutex()
+{
+    CE_ASSERT(_priv->state.load(std::memory_order_relaxed) == UNLOCKED, "Mutex is locked");
+    _priv->~Private();
+}
+
+void Mutex::lock()
+{
+#if CROWN_DEBUG
+    CE_ASSERT(_priv->owner.load(std::memory_order_relaxed) != current_tid(), "Mutex is already locked by this thread");
+#endif
+
+    u32 c = UNLOCKED;
+    if (CE_UNLIKELY(!_priv->state.compare_exchange_strong(c, LOCKED, std::memory_order_acquire, std::memory_order_relaxed)))
+    {
+#if CROWN_LOCK_STATS
+        const u64 start = _priv->stats != NULL ? lock_stats::now() : 0;
+#endif
+        // Spin in case the owner is about to unlock, but do not bother if
+        // sleepers are queued already.
+        const s32 spins = _priv->spins.load(std::memory_order_relaxed);
+        const s32 max_spins = min(MAX_SPINS, spins * 2 + 10);
+        bool locked = false;
+        s32 n = 0;
+        for (; n < max_spins && c != CONTENDED; ++n)
+        {
+            cpu_pause();
+            c = _priv->state.load(std::memory_order_relaxed);
+            if (c == UNLOCKED && _priv->state.compare_exchange_weak(c, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                locked = true;
+                break;
+            }
+        }
+
+        if (!locked)
+        {
+            // Mark the mutex contended so that unlock() wakes us up.
+            while (_priv->state.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED)
+                futex::wait(_priv->state, CONTENDED);
+        }
+
+        // Only the owner writes it, others read it before spinning.
+        _priv->spins.store(spins + (n - spins) / 8, std::memory_order_relaxed);
+#if CROWN_LOCK_STATS
+        lock_stats::acquired(_priv->stats, start);
+#endif
+    }
+#if CROWN_LOCK_STATS
+    else
+    {
+        lock_stats::acquired(_priv->stats);
+    }
+#endif
+
+#if CROWN_DEBUG
+    _priv->owner.store(current_tid(), std::memory_order_relaxed);
+#endif
+}
+
+bool Mutex::try_lock()
+{
+    u32 c = UNLOCKED;
+    if (!_priv->state.compare_exchange_strong(c, LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+        return false;
+
+#if CROWN_DEBUG
+    _priv->owner.store(current_tid(), std::memory_order_relaxed);
+#endif
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+    return true;
+}
+
+void Mutex::unlock()
+{
+#if CROWN_DEBUG
+    CE_ASSERT(_priv->owner.load(std::memory_order_relaxed) == current_tid(), "Mutex is not locked by this thread");
+    _priv->owner.store(0, std::memory_order_relaxed);
+#endif
+
+    if (_priv->state.exchange(UNLOCKED, std::memory_order_release) == CONTENDED)
+        futex::wake(_priv->state, 1);
+}
+
+void* Mutex::native_handle()
+{
+    return &_priv->state;
+}
+
+} // namespacr crown
+
 #else
 
 #include <pthread.h>
@@ -66,18 +244,28 @@ namespace crown
 struct Private
 {
     pthread_mutex_t mutex;
+#if CROWN_LOCK_STATS
+    LockCounters* stats;
+#endif
 };
 
-Mutex::Mutex()
+Mutex::Mutex(const char* name)
 {
     CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
     _priv = new (_data) Private();
+#if CROWN_LOCK_STATS
+    _priv->stats = name != NULL ? lock_stats::counters(name) : NULL;
+#else
+    CE_UNUSED(name);
+#endif
 
     pthread_mutexattr_t attr;
     int err = pthread_mutexattr_init(&attr);
     CE_ASSERT(err == 0, "pthread_mutexattr_init: errno = %d", err);
+#if CROWN_DEBUG
     err = pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ERRORCHECK);
     CE_ASSERT(err == 0, "pthread_mutexattr_settype: errno = %d", err);
+#endif
     err = pthread_mutex_init(&_priv->mutex, &attr);
     CE_ASSERT(err == 0, "pthread_mutex_init: errno = %d", err);
     err = pthread_mutexattr_destroy(&attr);
@@ -96,9 +284,32 @@ Mutex::~Mutex()
 
 void Mutex::lock()
 {
+#if CROWN_LOCK_STATS
+    if (pthread_mutex_trylock(&_priv->mutex) == 0)
+    {
+        lock_stats::acquired(_priv->stats);
+        return;
+    }
+
+    const u64 start = _priv->stats != NULL ? lock_stats::now() : 0;
+#endif
     int err = pthread_mutex_lock(&_priv->mutex);
     CE_ASSERT(err == 0, "pthread_mutex_lock: errno = %d", err);
     CE_UNUSED(err);
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats, start);
+#endif
+}
+
+bool Mutex::try_lock()
+{
+    if (pthread_mutex_trylock(&_priv->mutex) != 0)
+        return false;
+
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+    return true;
 }
 
 void Mutex::unlock()
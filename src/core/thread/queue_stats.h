@@ -0,0 +1,22 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/types.h"
+
+namespace crown
+{
+    // Contention counters reported by the lock-free queues.
+    struct QueueStats
+    {
+        u32 num_full;  // Number of pushes that failed because the queue was full.
+        u32 num_empty; // Number of pops that failed because the queue was empty.
+    };
+
+} // namespace crown
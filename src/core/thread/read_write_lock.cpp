@@ -0,0 +1,517 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "config.h"
+#include "core/error/error.inl"
+#include "core/thread/futex.inl"
+#include "core/thread/lock_stats.h"
+#include "core/thread/read_write_lock.h"
+#include <new>
+
+#if CROWN_PLATFORM_WINDOWS
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+namespace crown
+{
+
+// SRW locks do not say whether they prefer writers, but in practice a
+// waiting writer blocks new readers.
+struct ReadWriteLock::Private
+{
+    SRWLOCK lock;
+#if CROWN_LOCK_STATS
+    LockCounters* stats;
+#endif
+};
+
+ReadWriteLock::ReadWriteLock(const char* name)
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+    InitializeSRWLock(&_priv->lock);
+#if CROWN_LOCK_STATS
+    _priv->stats = name != NULL ? lock_stats::counters(name) : NULL;
+#else
+    CE_UNUSED(name);
+#endif
+}
+
+ReadWriteLock::~ReadWriteLock()
+{
+    _priv->~Private();
+}
+
+void ReadWriteLock::lock_read()
+{
+#if CROWN_LOCK_STATS
+    if (TryAcquireSRWLockShared(&_priv->lock) != 0)
+    {
+        lock_stats::acquired(_priv->stats);
+        return;
+    }
+
+    const u64 start = _priv->stats != NULL ? lock_stats::now() : 0;
+    AcquireSRWLockShared(&_priv->lock);
+    lock_stats::acquired(_priv->stats, start);
+#else
+    AcquireSRWLockShared(&_priv->lock);
+#endif
+}
+
+bool ReadWriteLock::try_lock_read()
+{
+    if (TryAcquireSRWLockShared(&_priv->lock) == 0)
+        return false;
+
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+    return true;
+}
+
+void ReadWriteLock::unlock_read()
+{
+    ReleaseSRWLockShared(&_priv->lock);
+}
+
+void ReadWriteLock::lock_write()
+{
+#if CROWN_LOCK_STATS
+    if (TryAcquireSRWLockExclusive(&_priv->lock) != 0)
+    {
+        lock_stats::acquired(_priv->stats);
+        return;
+    }
+
+    const u64 start = _priv->stats != NULL ? lock_stats::now() : 0;
+    AcquireSRWLockExclusive(&_priv->lock);
+    lock_stats::acquired(_priv->stats, start);
+#else
+    AcquireSRWLockExclusive(&_priv->lock);
+#endif
+}
+
+bool ReadWriteLock::try_lock_write()
+{
+    if (TryAcquireSRWLockExclusive(&_priv->lock) == 0)
+        return false;
+
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+    return true;
+}
+
+void ReadWriteLock::unlock_write()
+{
+    ReleaseSRWLockExclusive(&_priv->lock);
+}
+
+} // namespace crown
+
+#elif CROWN_FUTEX
+
+namespace crown
+{
+
+// The low 30 bits of the state count the readers, all ones when a writer
+// holds the lock. The two high bits tell whether readers or writers sleep.
+// Writers sleep on a separate word so that unlocking can wake one writer
+// without waking all the readers.
+static const u32 MASK = (1u << 30) - 1;
+static const u32 WRITE_LOCKED = MASK;
+static const u32 MAX_READERS = MASK - 1;
+static const u32 READERS_WAITING = 1u << 30;
+static const u32 WRITERS_WAITING = 1u << 31;
+
+static const u32 MAX_SPINS = 100;
+
+static inline bool is_unlocked(u32 s)
+{
+    return (s & MASK) == 0;
+}
+
+static inline bool is_write_locked(u32 s)
+{
+    return (s & MASK) == WRITE_LOCKED;
+}
+
+static inline bool is_read_lockable(u32 s)
+{
+    // Waiting writers and readers go first.
+    return (s & MASK) < MAX_READERS && (s & (READERS_WAITING | WRITERS_WAITING)) == 0;
+}
+
+struct ReadWriteLock::Private
+{
+    std::atomic<u32> state;
+    std::atomic<u32> writer_notify; // Incremented to wake up a writer.
+#if CROWN_LOCK_STATS
+    LockCounters* stats;
+#endif
+};
+
+// Spins while the lock is held but nobody sleeps. Returns the last state.
+template <typename F>
+static u32 spin_until(std::atomic<u32>& state, F done)
+{
+    u32 s = state.load(std::memory_order_relaxed);
+    for (u32 n = 0; n < MAX_SPINS && !done(s); ++n)
+    {
+        cpu_pause();
+        s = state.load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+static u32 spin_read(ReadWriteLock::Private& p)
+{
+    return spin_until(p.state, [](u32 s) { return !is_write_locked(s) || (s & (READERS_WAITING | WRITERS_WAITING)) != 0; });
+}
+
+static u32 spin_write(ReadWriteLock::Private& p)
+{
+    return spin_until(p.state, [](u32 s) { return is_unlocked(s) || (s & WRITERS_WAITING) != 0; });
+}
+
+static bool wake_writer(ReadWriteLock::Private& p)
+{
+    p.writer_notify.fetch_add(1, std::memory_order_release);
+    return futex::wake(p.writer_notify, 1) != 0;
+}
+
+// Wakes a writer if any, the readers otherwise. `s` is the state of the
+// unlocked lock, with some waiters.
+static void wake_writer_or_readers(ReadWriteLock::Private& p, u32 s)
+{
+    CE_ASSERT(is_unlocked(s), "Lock is held");
+
+    if (s == WRITERS_WAITING)
+    {
+        if (p.state.compare_exchange_strong(s, 0, std::memory_order_relaxed))
+        {
+            wake_writer(p);
+            return;
+        }
+    }
+
+    if (s == (READERS_WAITING | WRITERS_WAITING))
+    {
+        // Someone took the lock in the meantime, they will wake us up.
+        if (!p.state.compare_exchange_strong(s, READERS_WAITING, std::memory_order_relaxed))
+            return;
+        if (wake_writer(p))
+            return;
+
+        // No writer was actually asleep, the readers must not stay stuck.
+        s = READERS_WAITING;
+    }
+
+    if (s == READERS_WAITING)
+    {
+        if (p.state.compare_exchange_strong(s, 0, std::memory_order_relaxed))
+            futex::wake(p.state, 0xffffffffu);
+    }
+}
+
+static void lock_read_contended(ReadWriteLock::Private& p)
+{
+    u32 s = spin_read(p);
+    for (;;)
+    {
+        if (is_read_lockable(s))
+        {
+            if (p.state.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return;
+            continue;
+        }
+
+        CE_ASSERT((s & MASK) != MAX_READERS, "Too many readers");
+
+        // Tell the unlocker to wake us up before going to sleep.
+        if ((s & READERS_WAITING) == 0)
+        {
+            if (!p.state.compare_exchange_weak(s, s | READERS_WAITING, std::memory_order_relaxed))
+                continue;
+        }
+
+        futex::wait(p.state, s | READERS_WAITING);
+        s = spin_read(p);
+    }
+}
+
+static void lock_write_contended(ReadWriteLock::Private& p)
+{
+    u32 s = spin_write(p);
+
+    // Once this writer has slept, others may be asleep too: keep the bit
+    // set when taking the lock so that they get woken up eventually.
+    u32 other_writers_waiting = 0;
+
+    for (;;)
+    {
+        if (is_unlocked(s))
+        {
+            if (p.state.compare_exchange_weak(s, s | WRITE_LOCKED | other_writers_waiting, std::memory_order_acquire, std::memory_order_relaxed))
+                return;
+            continue;
+        }
+
+        if ((s & WRITERS_WAITING) == 0)
+        {
+            if (!p.state.compare_exchange_weak(s, s | WRITERS_WAITING, std::memory_order_relaxed))
+                continue;
+        }
+
+        other_writers_waiting = WRITERS_WAITING;
+
+        // Do not sleep if the lock became free or the bit was cleared by an
+        // unlock() that woke a writer already.
+        const u32 seq = p.writer_notify.load(std::memory_order_acquire);
+        s = p.state.load(std::memory_order_relaxed);
+        if (is_unlocked(s) || (s & WRITERS_WAITING) == 0)
+            continue;
+
+        futex::wait(p.writer_notify, seq);
+        s = spin_write(p);
+    }
+}
+
+ReadWriteLock::ReadWriteLock(const char* name)
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+    _priv->state.store(0, std::memory_order_relaxed);
+    _priv->writer_notify.store(0, std::memory_order_relaxed);
+#if CROWN_LOCK_STATS
+    _priv->stats = name != NULL ? lock_stats::counters(name) : NULL;
+#else
+    CE_UNUSED(name);
+#endif
+}
+
+ReadWriteLock::~ReadWriteLock()
+{
+    CE_ASSERT(is_unlocked(_priv->state.load(std::memory_order_relaxed)), "ReadWriteLock is locked");
+    _priv->~Private();
+}
+
+void ReadWriteLock::lock_read()
+{
+    u32 s = _priv->state.load(std::memory_order_relaxed);
+    if (CE_UNLIKELY(!is_read_lockable(s) || !_priv->state.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed)))
+    {
+#if CROWN_LOCK_STATS
+        const u64 start = _priv->stats != NULL ? lock_stats::now() : 0;
+        lock_read_contended(*_priv);
+        lock_stats::acquired(_priv->stats, start);
+#else
+        lock_read_contended(*_priv);
+#endif
+        return;
+    }
+
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+}
+
+bool ReadWriteLock::try_lock_read()
+{
+    u32 s = _priv->state.load(std::memory_order_relaxed);
+    do
+    {
+        if (!is_read_lockable(s))
+            return false;
+    }
+    while (!_priv->state.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed));
+
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+    return true;
+}
+
+void ReadWriteLock::unlock_read()
+{
+    const u32 prev = _priv->state.fetch_sub(1, std::memory_order_release);
+    CE_ASSERT(!is_unlocked(prev) && !is_write_locked(prev), "ReadWriteLock is not locked for reading");
+    const u32 s = prev - 1;
+
+    // Readers never wait while there are other readers, so the last one
+    // only has writers to wake up.
+    if (is_unlocked(s) && (s & WRITERS_WAITING) != 0)
+        wake_writer_or_readers(*_priv, s);
+}
+
+void ReadWriteLock::lock_write()
+{
+    u32 s = 0;
+    if (CE_UNLIKELY(!_priv->state.compare_exchange_strong(s, WRITE_LOCKED, std::memory_order_acquire, std::memory_order_relaxed)))
+    {
+#if CROWN_LOCK_STATS
+        const u64 start = _priv->stats != NULL ? lock_stats::now() : 0;
+        lock_write_contended(*_priv);
+        lock_stats::acquired(_priv->stats, start);
+#else
+        lock_write_contended(*_priv);
+#endif
+        return;
+    }
+
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+}
+
+bool ReadWriteLock::try_lock_write()
+{
+    u32 s = _priv->state.load(std::memory_order_relaxed);
+    do
+    {
+        if (!is_unlocked(s))
+            return false;
+    }
+    while (!_priv->state.compare_exchange_weak(s, s | WRITE_LOCKED, std::memory_order_acquire, std::memory_order_relaxed));
+
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+    return true;
+}
+
+void ReadWriteLock::unlock_write()
+{
+    CE_ASSERT(is_write_locked(_priv->state.load(std::memory_order_relaxed)), "ReadWriteLock is not locked for writing");
+
+    const u32 s = _priv->state.fetch_sub(WRITE_LOCKED, std::memory_order_release) - WRITE_LOCKED;
+    if ((s & (READERS_WAITING | WRITERS_WAITING)) != 0)
+        wake_writer_or_readers(*_priv, s);
+}
+
+} // namespace crown
+
+#else
+
+#include <pthread.h>
+
+namespace crown
+{
+
+struct ReadWriteLock::Private
+{
+    pthread_rwlock_t lock;
+#if CROWN_LOCK_STATS
+    LockCounters* stats;
+#endif
+};
+
+ReadWriteLock::ReadWriteLock(const char* name)
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+
+    int err = pthread_rwlock_init(&_priv->lock, NULL);
+    CE_ASSERT(err == 0, "pthread_rwlock_init: errno = %d", err);
+    CE_UNUSED(err);
+#if CROWN_LOCK_STATS
+    _priv->stats = name != NULL ? lock_stats::counters(name) : NULL;
+#else
+    CE_UNUSED(name);
+#endif
+}
+
+ReadWriteLock::~ReadWriteLock()
+{
+    int err = pthread_rwlock_destroy(&_priv->lock);
+    CE_ASSERT(err == 0, "pthread_rwlock_destroy: errno = %d", err);
+    CE_UNUSED(err);
+
+    _priv->~Private();
+}
+
+void ReadWriteLock::lock_read()
+{
+#if CROWN_LOCK_STATS
+    if (pthread_rwlock_tryrdlock(&_priv->lock) == 0)
+    {
+        lock_stats::acquired(_priv->stats);
+        return;
+    }
+
+    const u64 start = _priv->stats != NULL ? lock_stats::now() : 0;
+#endif
+    int err = pthread_rwlock_rdlock(&_priv->lock);
+    CE_ASSERT(err == 0, "pthread_rwlock_rdlock: errno = %d", err);
+    CE_UNUSED(err);
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats, start);
+#endif
+}
+
+bool ReadWriteLock::try_lock_read()
+{
+    if (pthread_rwlock_tryrdlock(&_priv->lock) != 0)
+        return false;
+
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+    return true;
+}
+
+void ReadWriteLock::unlock_read()
+{
+    int err = pthread_rwlock_unlock(&_priv->lock);
+    CE_ASSERT(err == 0, "pthread_rwlock_unlock: errno = %d", err);
+    CE_UNUSED(err);
+}
+
+void ReadWriteLock::lock_write()
+{
+#if CROWN_LOCK_STATS
+    if (pthread_rwlock_trywrlock(&_priv->lock) == 0)
+    {
+        lock_stats::acquired(_priv->stats);
+        return;
+    }
+
+    const u64 start = _priv->stats != NULL ? lock_stats::now() : 0;
+#endif
+    int err = pthread_rwlock_wrlock(&_priv->lock);
+    CE_ASSERT(err == 0, "pthread_rwlock_wrlock: errno = %d", err);
+    CE_UNUSED(err);
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats, start);
+#endif
+}
+
+bool ReadWriteLock::try_lock_write()
+{
+    if (pthread_rwlock_trywrlock(&_priv->lock) != 0)
+        return false;
+
+#if CROWN_LOCK_STATS
+    lock_stats::acquired(_priv->stats);
+#endif
+    return true;
+}
+
+void ReadWriteLock::unlock_write()
+{
+    int err = pthread_rwlock_unlock(&_priv->lock);
+    CE_ASSERT(err == 0, "pthread_rwlock_unlock: errno = %d", err);
+    CE_UNUSED(err);
+}
+
+} // namespace crown
+
+#endif
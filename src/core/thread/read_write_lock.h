@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/types.h"
+
+namespace crown
+{
+    // Lock held by any number of readers or by a single writer.
+    //
+    // Writers are preferred: once a writer waits, new readers wait too, so
+    // a steady stream of readers cannot starve it. Neither side is
+    // recursive, and a reader cannot upgrade to a writer.
+    //
+    // With CROWN_LOCK_STATS, locks with a name count their acquisitions
+    // and waits, read and write alike, see lock_stats.h.
+    struct ReadWriteLock
+    {
+        struct Private;
+        Private* _priv;
+        CE_ALIGN_DECL(16, u8 _data[64]);
+
+        explicit ReadWriteLock(const char* name = NULL);
+        ~ReadWriteLock();
+
+        ReadWriteLock(const ReadWriteLock&) = delete;
+        ReadWriteLock& operator=(const ReadWriteLock&) = delete;
+
+        void lock_read();
+
+        // Returns false instead of waiting if a writer holds or waits for
+        // the lock.
+        bool try_lock_read();
+
+        void unlock_read();
+
+        void lock_write();
+
+        // Returns false instead of waiting if the lock is held.
+        bool try_lock_write();
+
+        void unlock_write();
+    };
+
+} // namespace crown
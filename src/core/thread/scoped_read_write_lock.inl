@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/thread/read_write_lock.h"
+
+namespace crown
+{
+
+    // Automatically locks a read-write lock for reading when created and
+    // unlocks when destroyed.
+    struct ScopedReadLock
+    {
+        ReadWriteLock& _lock;
+
+        ScopedReadLock(ReadWriteLock& l) : _lock(l)
+        {
+            _lock.lock_read();
+        }
+
+        ~ScopedReadLock()
+        {
+            _lock.unlock_read();
+        }
+
+        ScopedReadLock(const ScopedReadLock&) = delete;
+        ScopedReadLock& operator=(const ScopedReadLock&) = delete;
+    };
+
+    // Automatically locks a read-write lock for writing when created and
+    // unlocks when destroyed.
+    struct ScopedWriteLock
+    {
+        ReadWriteLock& _lock;
+
+        ScopedWriteLock(ReadWriteLock& l) : _lock(l)
+        {
+            _lock.lock_write();
+        }
+
+        ~ScopedWriteLock()
+        {
+            _lock.unlock_write();
+        }
+
+        ScopedWriteLock(const ScopedWriteLock&) = delete;
+        ScopedWriteLock& operator=(const ScopedWriteLock&) = delete;
+    };
+
+} // namespace crown
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/error/error.inl"
+#include "core/thread/futex.inl"
+#include "core/thread/semaphore.h"
+#include <new>
+
+#if CROWN_PLATFORM_WINDOWS
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+namespace crown
+{
+
+struct Semaphore::Private
+{
+    HANDLE handle;
+};
+
+Semaphore::Semaphore()
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+
+    _priv->handle = CreateSemaphoreA(NULL, 0, LONG_MAX, NULL);
+    CE_ASSERT(_priv->handle != NULL, "CreateSemaphore: GetLastError = %d", GetLastError());
+}
+
+Semaphore::~Semaphore()
+{
+    BOOL err = CloseHandle(_priv->handle);
+    CE_ASSERT(err != 0, "CloseHandle: GetLastError = %d", GetLastError());
+    CE_UNUSED(err);
+
+    _priv->~Private();
+}
+
+void Semaphore::post(u32 count)
+{
+    BOOL err = ReleaseSemaphore(_priv->handle, count, NULL);
+    CE_ASSERT(err != 0, "ReleaseSemaphore: GetLastError = %d", GetLastError());
+    CE_UNUSED(err);
+}
+
+void Semaphore::wait()
+{
+    DWORD err = WaitForSingleObject(_priv->handle, INFINITE);
+    CE_ASSERT(err == WAIT_OBJECT_0, "WaitForSingleObject: GetLastError = %d", GetLastError());
+    CE_UNUSED(err);
+}
+
+bool Semaphore::try_wait()
+{
+    return WaitForSingleObject(_priv->handle, 0) == WAIT_OBJECT_0;
+}
+
+} // namespace crown
+
+#elif CROWN_FUTEX
+
+namespace crown
+{
+
+static const u32 NUM_SPINS = 64;
+
+struct Semaphore::Private
+{
+    std::atomic<u32> count;
+    std::atomic<u32> waiters; // Threads about to sleep or sleeping.
+};
+
+Semaphore::Semaphore()
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+    _priv->count.store(0, std::memory_order_relaxed);
+    _priv->waiters.store(0, std::memory_order_relaxed);
+}
+
+Semaphore::~Semaphore()
+{
+    CE_ASSERT(_priv->waiters.load(std::memory_order_relaxed) == 0, "Semaphore has waiters");
+    _priv->~Private();
+}
+
+void Semaphore::post(u32 count)
+{
+    // Pairs with wait(): either post() sees the waiter or the waiter's
+    // futex::wait() sees the new count.
+    _priv->count.fetch_add(count, std::memory_order_seq_cst);
+    if (_priv->waiters.load(std::memory_order_seq_cst) != 0)
+        futex::wake(_priv->count, count);
+}
+
+void Semaphore::wait()
+{
+    for (u32 i = 0; i < NUM_SPINS; ++i)
+    {
+        if (try_wait())
+            return;
+        cpu_pause();
+    }
+
+    while (!try_wait())
+    {
+        _priv->waiters.fetch_add(1, std::memory_order_seq_cst);
+        futex::wait(_priv->count, 0);
+        _priv->waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+bool Semaphore::try_wait()
+{
+    u32 c = _priv->count.load(std::memory_order_relaxed);
+    while (c != 0)
+    {
+        if (_priv->count.compare_exchange_weak(c, c - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return true;
+    }
+
+    return false;
+}
+
+} // namespace crown
+
+#else
+
+#include <pthread.h>
+
+namespace crown
+{
+
+struct Semaphore::Private
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    u32 count;
+};
+
+Semaphore::Semaphore()
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+    _priv->count = 0;
+
+    int err = pthread_mutex_init(&_priv->mutex, NULL);
+    CE_ASSERT(err == 0, "pthread_mutex_init: errno = %d", err);
+    err = pthread_cond_init(&_priv->cond, NULL);
+    CE_ASSERT(err == 0, "pthread_cond_init: errno = %d", err);
+    CE_UNUSED(err);
+}
+
+Semaphore::~Semaphore()
+{
+    int err = pthread_cond_destroy(&_priv->cond);
+    CE_ASSERT(err == 0, "pthread_cond_destroy: errno = %d", err);
+    err = pthread_mutex_destroy(&_priv->mutex);
+    CE_ASSERT(err == 0, "pthread_mutex_destroy: errno = %d", err);
+    CE_UNUSED(err);
+
+    _priv->~Private();
+}
+
+void Semaphore::post(u32 count)
+{
+    pthread_mutex_lock(&_priv->mutex);
+    _priv->count += count;
+    pthread_mutex_unlock(&_priv->mutex);
+
+    if (count == 1)
+        pthread_cond_signal(&_priv->cond);
+    else
+        pthread_cond_broadcast(&_priv->cond);
+}
+
+void Semaphore::wait()
+{
+    pthread_mutex_lock(&_priv->mutex);
+    while (_priv->count == 0)
+        pthread_cond_wait(&_priv->cond, &_priv->mutex);
+    --_priv->count;
+    pthread_mutex_unlock(&_priv->mutex);
+}
+
+bool Semaphore::try_wait()
+{
+    pthread_mutex_lock(&_priv->mutex);
+    const bool ok = _priv->count != 0;
+    if (ok)
+        --_priv->count;
+    pthread_mutex_unlock(&_priv->mutex);
+    return ok;
+}
+
+} // namespace crown
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/types.h"
+
+namespace crown
+{
+    // Counting semaphore, initially 0.
+    //
+    // On Linux wait() spins briefly before sleeping on a futex, and post()
+    // only enters the kernel when a thread is sleeping.
+    struct Semaphore
+    {
+        struct Private;
+        Private* _priv;
+        CE_ALIGN_DECL(16, u8 _data[128]); // Fits a pthread mutex and condition.
+
+        Semaphore();
+        ~Semaphore();
+
+        Semaphore(const Semaphore&) = delete;
+        Semaphore& operator=(const Semaphore&) = delete;
+
+        // Adds `count` to the semaphore, waking up as many waiting threads.
+        void post(u32 count = 1);
+
+        // Waits until the semaphore is not 0, then decrements it.
+        void wait();
+
+        // Decrements the semaphore if it is not 0.
+        // Returns false instead of waiting if it is 0.
+        bool try_wait();
+    };
+
+} // namespace crown
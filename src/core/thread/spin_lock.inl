@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "config.h"
+#include "core/error/error.inl"
+#include "core/thread/futex.inl"
+#include "core/thread/lock_stats.h"
+#include "core/thread/thread.h"
+
+namespace crown
+{
+    // Non-recursive lock that never sleeps in the kernel, for critical
+    // sections of a few instructions.
+    //
+    // Waiters only read the lock until it looks free, pausing for twice as
+    // long after each look, then yield their time slice. A SpinLock fills
+    // a cache line so that neighbouring data is not slowed down by the
+    // waiters.
+    struct SpinLock
+    {
+        CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<u32> _locked);
+        LockCounters* _stats;
+
+        // See lock_stats.h for `name`.
+        explicit SpinLock(const char* name = NULL);
+
+        SpinLock(const SpinLock&) = delete;
+        SpinLock& operator=(const SpinLock&) = delete;
+
+        void lock();
+
+        // Returns false instead of waiting if the lock is taken.
+        bool try_lock();
+
+        void unlock();
+    };
+
+    // Automatically locks a spin lock when created and unlocks when
+    // destroyed.
+    struct ScopedSpinLock
+    {
+        SpinLock& _lock;
+
+        ScopedSpinLock(SpinLock& l) : _lock(l)
+        {
+            _lock.lock();
+        }
+
+        ~ScopedSpinLock()
+        {
+            _lock.unlock();
+        }
+
+        ScopedSpinLock(const ScopedSpinLock&) = delete;
+        ScopedSpinLock& operator=(const ScopedSpinLock&) = delete;
+    };
+
+    namespace spin_lock_internal
+    {
+        // Longest pause between two looks at the lock, before yielding.
+        const u32 MAX_PAUSES = 64;
+
+        inline CE_NOINLINE void lock_contended(SpinLock& sl)
+        {
+#if CROWN_LOCK_STATS
+            const u64 start = sl._stats != NULL ? lock_stats::now() : 0;
+#endif
+            u32 pauses = 1;
+            do
+            {
+                while (sl._locked.load(std::memory_order_relaxed) != 0)
+                {
+                    if (pauses <= MAX_PAUSES)
+                    {
+                        for (u32 i = 0; i < pauses; ++i)
+                            cpu_pause();
+                        pauses *= 2;
+                    }
+                    else
+                    {
+                        // The owner may not be running.
+                        thread::yield();
+                    }
+                }
+            }
+            while (sl._locked.exchange(1, std::memory_order_acquire) != 0);
+
+#if CROWN_LOCK_STATS
+            lock_stats::acquired(sl._stats, start);
+#endif
+        }
+
+    } // namespace spin_lock_internal
+
+    inline SpinLock::SpinLock(const char* name)
+        : _locked(0)
+        , _stats(CROWN_LOCK_STATS && name != NULL ? lock_stats::counters(name) : NULL)
+    {
+        CE_STATIC_ASSERT(sizeof(SpinLock) == CROWN_CACHE_LINE_SIZE);
+    }
+
+    inline void SpinLock::lock()
+    {
+        if (CE_UNLIKELY(_locked.exchange(1, std::memory_order_acquire) != 0))
+        {
+            spin_lock_internal::lock_contended(*this);
+            return;
+        }
+
+#if CROWN_LOCK_STATS
+        lock_stats::acquired(_stats);
+#endif
+    }
+
+    inline bool SpinLock::try_lock()
+    {
+        if (_locked.load(std::memory_order_relaxed) != 0 || _locked.exchange(1, std::memory_order_acquire) != 0)
+            return false;
+
+#if CROWN_LOCK_STATS
+        lock_stats::acquired(_stats);
+#endif
+        return true;
+    }
+
+    inline void SpinLock::unlock()
+    {
+        CE_ASSERT(_locked.load(std::memory_order_relaxed) != 0, "SpinLock is not locked");
+        _locked.store(0, std::memory_order_release);
+    }
+
+} // namespace crown
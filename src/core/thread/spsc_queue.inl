@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/error/error.inl"
+#include "core/memory/allocator.h"
+#include "core/thread/mpmc_queue.inl"
+#include "core/thread/queue_stats.h"
+#include <atomic>
+#include <string.h> // memcpy
+
+namespace crown
+{
+
+    // Wait-free single-producer/single-consumer ring buffer of POD items.
+    //
+    // Exactly one thread may push and exactly one thread may pop. Each side
+    // keeps a cached copy of the other side's index and only reloads it
+    // when the cached value says the ring is full (or empty), so in the
+    // common case push and pop touch no shared cache line but the slot.
+    // The batch versions publish many items with a single release store.
+    template <typename T>
+    struct SpscQueue
+    {
+        Allocator* _allocator;
+        T* _data;
+        u32 _mask;
+
+        // Consumer side.
+        CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<u32> _head);
+        u32 _cached_tail;
+        std::atomic<u32> _num_empty;
+
+        // Producer side.
+        CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<u32> _tail);
+        u32 _cached_head;
+        std::atomic<u32> _num_full;
+
+        // Creates a queue holding up to `capacity` items, rounded up to the
+        // next power of two.
+        SpscQueue(Allocator& a, u32 capacity);
+        ~SpscQueue();
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // Appends `item` to the queue.
+        // Returns false if the queue is full. Producer only.
+        bool push(const T& item);
+
+        // Appends up to `count` `items` to the queue and makes them visible
+        // to the consumer at once. Returns the number of items appended.
+        // Producer only.
+        u32 push(const T* items, u32 count);
+
+        // Removes the oldest item from the queue and copies it to `item`.
+        // Returns false if the queue is empty. Consumer only.
+        bool pop(T& item);
+
+        // Removes up to `count` of the oldest items from the queue, copies
+        // them to `items` and returns how many were removed. Consumer only.
+        u32 pop(T* items, u32 count);
+
+        // Returns the maximum number of items the queue can hold.
+        u32 capacity() const;
+
+        // Returns the number of items in the queue. The value is only a
+        // snapshot when the other side is running.
+        u32 size() const;
+
+        // Returns the number of failed pushes and pops so far.
+        QueueStats stats() const;
+    };
+
+    template <typename T>
+    inline SpscQueue<T>::SpscQueue(Allocator& a, u32 capacity)
+        : _allocator(&a)
+        , _data(NULL)
+        , _mask(0)
+        , _head(0)
+        , _cached_tail(0)
+        , _num_empty(0)
+        , _tail(0)
+        , _cached_head(0)
+        , _num_full(0)
+    {
+        CE_ASSERT(capacity >= 2, "Capacity must be >= 2");
+        capacity = queue_internal::next_pow2(capacity);
+
+        _data = (T*)a.allocate(capacity * sizeof(T), alignof(T));
+        _mask = capacity - 1;
+    }
+
+    template <typename T>
+    inline SpscQueue<T>::~SpscQueue()
+    {
+        _allocator->deallocate(_data);
+    }
+
+    template <typename T>
+    inline bool SpscQueue<T>::push(const T& item)
+    {
+        return push(&item, 1) == 1;
+    }
+
+    template <typename T>
+    inline u32 SpscQueue<T>::push(const T* items, u32 count)
+    {
+        const u32 tail = _tail.load(std::memory_order_relaxed);
+        const u32 capacity = _mask + 1;
+
+        u32 free = capacity - (tail - _cached_head);
+        if (free < count)
+        {
+            _cached_head = _head.load(std::memory_order_acquire);
+            free = capacity - (tail - _cached_head);
+            if (free == 0)
+            {
+                _num_full.fetch_add(1, std::memory_order_relaxed);
+                return 0;
+            }
+        }
+
+        count = min(count, free);
+
+        // Copy in up to two chunks when wrapping around the end.
+        const u32 start = tail & _mask;
+        const u32 first = min(count, capacity - start);
+        memcpy(_data + start, items, first * sizeof(T));
+        memcpy(_data, items + first, (count - first) * sizeof(T));
+
+        _tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    template <typename T>
+    inline bool SpscQueue<T>::pop(T& item)
+    {
+        return pop(&item, 1) == 1;
+    }
+
+    template <typename T>
+    inline u32 SpscQueue<T>::pop(T* items, u32 count)
+    {
+        const u32 head = _head.load(std::memory_order_relaxed);
+        const u32 capacity = _mask + 1;
+
+        u32 available = _cached_tail - head;
+        if (available < count)
+        {
+            _cached_tail = _tail.load(std::memory_order_acquire);
+            available = _cached_tail - head;
+            if (available == 0)
+            {
+                _num_empty.fetch_add(1, std::memory_order_relaxed);
+                return 0;
+            }
+        }
+
+        count = min(count, available);
+
+        const u32 start = head & _mask;
+        const u32 first = min(count, capacity - start);
+        memcpy(items, _data + start, first * sizeof(T));
+        memcpy(items + first, _data, (count - first) * sizeof(T));
+
+        _head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    template <typename T>
+    inline u32 SpscQueue<T>::capacity() const
+    {
+        return _mask + 1;
+    }
+
+    template <typename T>
+    inline u32 SpscQueue<T>::size() const
+    {
+        const u32 head = _head.load(std::memory_order_acquire);
+        const u32 tail = _tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    template <typename T>
+    inline QueueStats SpscQueue<T>::stats() const
+    {
+        QueueStats qs;
+        qs.num_full = _num_full.load(std::memory_order_relaxed);
+        qs.num_empty = _num_empty.load(std::memory_order_relaxed);
+        return qs;
+    }
+
+} // namespace crown
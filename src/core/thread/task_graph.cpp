@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/containers/array.inl"
+#include "core/containers/array_algorithms.inl"
+#include "core/error/error.inl"
+#include "core/memory/allocator.h"
+#include "core/thread/task_graph.h"
+#include <chrono>
+#include <new>
+
+namespace crown
+{
+    namespace task_graph_internal
+    {
+        const u32 MAX_BATCH = 32; // Ready successors run at once.
+
+        static u64 now()
+        {
+            using namespace std::chrono;
+            return u64(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+        }
+
+        // Runs the `num` ready `nodes` as jobs, most critical first.
+        static void run_batch(TaskGraph& g, TaskGraph::Node** nodes, u32 num)
+        {
+            for (u32 i = 1; i < num; ++i)
+            {
+                for (u32 j = i; j > 0 && nodes[j]->priority > nodes[j - 1]->priority; --j)
+                    exchange(nodes[j], nodes[j - 1]);
+            }
+
+            Job* jobs[MAX_BATCH];
+            for (u32 i = 0; i < num; ++i)
+                jobs[i] = &g._jobs[u32(nodes[i] - array::begin(g._nodes))];
+
+            g._job_system->run(jobs, num, &g._counter);
+        }
+
+        static void task_job(void* user_data)
+        {
+            TaskGraph::Node* node = (TaskGraph::Node*)user_data;
+            TaskGraph& g = *node->graph;
+            TaskGraph::Node* nodes = array::begin(g._nodes);
+
+            for (;;)
+            {
+                const u32 i = u32(node - nodes);
+                if (g._timing)
+                    g._timings[i].start = now() - g._run_start;
+
+                node->func(node->user_data);
+
+                if (g._timing)
+                    g._timings[i].end = now() - g._run_start;
+
+                // Go on with the most critical successor that is ready and
+                // leave the others to the workers.
+                TaskGraph::Node* next = NULL;
+                TaskGraph::Node* batch[MAX_BATCH];
+                u32 num_batch = 0;
+                for (u32 s = 0; s < node->num_successors; ++s)
+                {
+                    const u32 j = g._successors[node->first_successor + s];
+                    if (g._pending[j].fetch_sub(1, std::memory_order_acq_rel) != 1)
+                        continue;
+
+                    TaskGraph::Node* ready = &nodes[j];
+                    if (next == NULL)
+                    {
+                        next = ready;
+                        continue;
+                    }
+
+                    if (ready->priority > next->priority)
+                        exchange(ready, next);
+
+                    if (num_batch == MAX_BATCH)
+                    {
+                        run_batch(g, batch, num_batch);
+                        num_batch = 0;
+                    }
+                    batch[num_batch++] = ready;
+                }
+
+                if (num_batch != 0)
+                    run_batch(g, batch, num_batch);
+
+                if (next == NULL)
+                    return;
+                node = next;
+            }
+        }
+
+        // Computes the priorities from the costs, or from the durations
+        // of the last run if `measured`, and sorts the roots.
+        static void prioritize(TaskGraph& g, bool measured)
+        {
+            for (u32 k = array::size(g._order); k > 0; --k)
+            {
+                TaskGraph::Node& n = g._nodes[g._order[k - 1]];
+                u64 p = 0;
+                for (u32 s = 0; s < n.num_successors; ++s)
+                    p = max(p, g._nodes[g._successors[n.first_successor + s]].priority);
+
+                u64 cost = n.cost;
+                if (measured)
+                {
+                    const TaskTiming& t = g._timings[g._order[k - 1]];
+                    cost = max(u64(1), t.end - t.start);
+                }
+                n.priority = cost + p;
+            }
+
+            const TaskGraph::Node* nodes = array::begin(g._nodes);
+            array::merge_sort(g._roots, [nodes](u32 a, u32 b) { return nodes[a].priority > nodes[b].priority; });
+
+            array::resize(g._root_jobs, array::size(g._roots));
+            for (u32 i = 0; i < array::size(g._roots); ++i)
+                g._root_jobs[i] = &g._jobs[g._roots[i]];
+        }
+
+    } // namespace task_graph_internal
+
+    TaskGraph::TaskGraph(Allocator& a)
+        : _allocator(&a)
+        , _nodes(a)
+        , _edges(a)
+        , _successors(a)
+        , _order(a)
+        , _roots(a)
+        , _root_jobs(a)
+        , _num_predecessors(a)
+        , _jobs(a)
+        , _timings(a)
+        , _pending(NULL)
+        , _job_system(NULL)
+        , _run_start(0)
+        , _built(false)
+        , _timing(false)
+    {
+    }
+
+    TaskGraph::~TaskGraph()
+    {
+        CE_ASSERT(_job_system == NULL, "TaskGraph is running");
+        _allocator->deallocate(_pending);
+    }
+
+    u32 TaskGraph::add(JobFunction func, void* user_data, u64 cost)
+    {
+        CE_ENSURE(func != NULL);
+
+        Node n;
+        n.func = func;
+        n.user_data = user_data;
+        n.graph = this;
+        n.cost = cost;
+        n.priority = 0;
+        n.first_successor = 0;
+        n.num_successors = 0;
+        n.num_predecessors = 0;
+
+        _built = false;
+        return array::push_back(_nodes, n);
+    }
+
+    void TaskGraph::add_edge(u32 from, u32 to)
+    {
+        CE_ASSERT(from < array::size(_nodes), "Index out of bounds");
+        CE_ASSERT(to < array::size(_nodes), "Index out of bounds");
+        CE_ASSERT(from != to, "Task cannot wait for itself");
+
+        Edge e;
+        e.from = from;
+        e.to = to;
+        array::push_back(_edges, e);
+        _built = false;
+    }
+
+    void TaskGraph::build()
+    {
+        using namespace task_graph_internal;
+        CE_ASSERT(_job_system == NULL, "TaskGraph is running");
+
+        const u32 num_nodes = array::size(_nodes);
+        const u32 num_edges = array::size(_edges);
+
+        // Successor lists, one after the other in the order of the nodes.
+        for (u32 i = 0; i < num_nodes; ++i)
+        {
+            _nodes[i].num_successors = 0;
+            _nodes[i].num_predecessors = 0;
+        }
+        for (u32 i = 0; i < num_edges; ++i)
+        {
+            ++_nodes[_edges[i].from].num_successors;
+            ++_nodes[_edges[i].to].num_predecessors;
+        }
+
+        u32 first = 0;
+        for (u32 i = 0; i < num_nodes; ++i)
+        {
+            _nodes[i].first_successor = first;
+            first += _nodes[i].num_successors;
+            _nodes[i].num_successors = 0;
+        }
+
+        array::resize(_successors, num_edges);
+        for (u32 i = 0; i < num_edges; ++i)
+        {
+            Node& n = _nodes[_edges[i].from];
+            _successors[n.first_successor + n.num_successors++] = _edges[i].to;
+        }
+
+        // Topological order, with the roots first.
+        array::resize(_num_predecessors, num_nodes);
+        array::clear(_order);
+        array::clear(_roots);
+        for (u32 i = 0; i < num_nodes; ++i)
+        {
+            _num_predecessors[i] = _nodes[i].num_predecessors;
+            if (_nodes[i].num_predecessors == 0)
+            {
+                array::push_back(_order, i);
+                array::push_back(_roots, i);
+            }
+        }
+        for (u32 k = 0; k < array::size(_order); ++k)
+        {
+            const Node& n = _nodes[_order[k]];
+            for (u32 s = 0; s < n.num_successors; ++s)
+            {
+                const u32 j = _successors[n.first_successor + s];
+                if (--_num_predecessors[j] == 0)
+                    array::push_back(_order, j);
+            }
+        }
+        CE_ASSERT(array::size(_order) == num_nodes, "TaskGraph has a cycle");
+
+        for (u32 i = 0; i < num_nodes; ++i)
+            _num_predecessors[i] = _nodes[i].num_predecessors;
+
+        array::resize(_jobs, num_nodes);
+        for (u32 i = 0; i < num_nodes; ++i)
+        {
+            _jobs[i].func = task_job;
+            _jobs[i].user_data = &_nodes[i];
+            _jobs[i].counter = NULL;
+        }
+
+        _allocator->deallocate(_pending);
+        _pending = (std::atomic<u32>*)_allocator->allocate(max(1u, num_nodes) * sizeof(std::atomic<u32>), alignof(std::atomic<u32>));
+        for (u32 i = 0; i < num_nodes; ++i)
+            new (&_pending[i]) std::atomic<u32>(0);
+
+        array::resize(_timings, num_nodes);
+        prioritize(*this, false);
+
+        _built = true;
+    }
+
+    void TaskGraph::run(JobSystem& js)
+    {
+        using namespace task_graph_internal;
+        CE_ASSERT(_job_system == NULL, "TaskGraph is already running");
+
+        if (!_built)
+            build();
+
+        const u32 num_nodes = array::size(_nodes);
+        if (num_nodes == 0)
+            return;
+
+        // The counters are only touched by the tasks, which have all
+        // finished: running the roots publishes the new values.
+        for (u32 i = 0; i < num_nodes; ++i)
+            _pending[i].store(_num_predecessors[i], std::memory_order_relaxed);
+
+        _job_system = &js;
+        if (_timing)
+            _run_start = now();
+
+        js.run(array::begin(_root_jobs), array::size(_root_jobs), &_counter);
+        js.wait(_counter);
+
+        _job_system = NULL;
+        if (_timing)
+            prioritize(*this, true);
+    }
+
+    void TaskGraph::set_timing(bool enable)
+    {
+        CE_ASSERT(_job_system == NULL, "TaskGraph is running");
+        _timing = enable;
+        array::resize(_timings, array::size(_nodes));
+    }
+
+    const TaskTiming& TaskGraph::timing(u32 node) const
+    {
+        CE_ASSERT(_timing, "Timing is disabled");
+        CE_ASSERT(node < array::size(_timings), "Index out of bounds");
+        return _timings[node];
+    }
+
+    u32 TaskGraph::size() const
+    {
+        return array::size(_nodes);
+    }
+
+    void TaskGraph::clear()
+    {
+        CE_ASSERT(_job_system == NULL, "TaskGraph is running");
+
+        array::clear(_nodes);
+        array::clear(_edges);
+        array::clear(_successors);
+        array::clear(_order);
+        array::clear(_roots);
+        array::clear(_root_jobs);
+        array::clear(_num_predecessors);
+        array::clear(_jobs);
+        array::clear(_timings);
+        _allocator->deallocate(_pending);
+        _pending = NULL;
+        _built = false;
+    }
+
+} // namespace crown
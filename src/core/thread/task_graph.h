@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/containers/types.h"
+#include "core/memory/types.h"
+#include "core/thread/job_system.h"
+#include "core/types.h"
+#include <atomic>
+
+namespace crown
+{
+    // Start and end of a task in the last run, in nanoseconds since the
+    // run started.
+    struct TaskTiming
+    {
+        u64 start;
+        u64 end;
+    };
+
+    // Directed acyclic graph of tasks, declared once and run as many times
+    // as needed, e.g. the systems updated every frame.
+    //
+    // Declaring the graph does all the work that does not change between
+    // runs: successor lists, predecessor counts and priorities. A run only
+    // copies the predecessor counts into the counters its tasks decrement,
+    // then runs the tasks without predecessors on the JobSystem.
+    //
+    // Tasks on the critical path go first. The priority of a task is its
+    // cost plus the largest priority of its successors, i.e. the length of
+    // the longest chain of tasks it starts. A finishing task goes on with
+    // the ready successor of highest priority on the same thread and runs
+    // the others as jobs, by decreasing priority. With timing enabled, the
+    // measured durations of a run replace the costs for the next one.
+    struct TaskGraph
+    {
+        struct Node
+        {
+            JobFunction func;
+            void* user_data;
+            TaskGraph* graph;
+            u64 cost;
+            u64 priority;
+            u32 first_successor; // In _successors.
+            u32 num_successors;
+            u32 num_predecessors;
+        };
+
+        struct Edge
+        {
+            u32 from;
+            u32 to;
+        };
+
+        Allocator* _allocator;
+        Array<Node> _nodes;
+        Array<Edge> _edges;
+        Array<u32> _successors;  // Successors of all the nodes, by node.
+        Array<u32> _order;       // Nodes in topological order.
+        Array<u32> _roots;       // Nodes without predecessors, by priority.
+        Array<Job*> _root_jobs;  // Jobs of _roots.
+        Array<u32> _num_predecessors;
+        Array<Job> _jobs;
+        Array<TaskTiming> _timings;
+        std::atomic<u32>* _pending; // Unfinished predecessors of each node.
+        JobSystem* _job_system;     // While running.
+        JobCounter _counter;
+        u64 _run_start;
+        bool _built;
+        bool _timing;
+
+        explicit TaskGraph(Allocator& a);
+        ~TaskGraph();
+
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator=(const TaskGraph&) = delete;
+
+        // Adds a task that calls `func(user_data)`. `cost` estimates how
+        // long it runs, in any unit, for critical path scheduling.
+        // Returns the index of the task.
+        u32 add(JobFunction func, void* user_data, u64 cost = 1);
+
+        // Makes the task `to` wait for the task `from` to finish.
+        void add_edge(u32 from, u32 to);
+
+        // Computes what runs need from the tasks and edges added so far.
+        // run() calls it after changes, call it up front to keep that work
+        // out of the first run. The graph must not have cycles.
+        void build();
+
+        // Runs all the tasks and returns once they are finished. Other jobs
+        // run while waiting, see JobSystem::wait().
+        void run(JobSystem& js);
+
+        // Enables or disables capturing the start and end times of each
+        // task, see timing().
+        void set_timing(bool enable);
+
+        // Returns the times of the task `node` in the last run.
+        // Timing must be enabled.
+        const TaskTiming& timing(u32 node) const;
+
+        // Returns the number of tasks.
+        u32 size() const;
+
+        // Removes all the tasks and edges.
+        void clear();
+    };
+
+} // namespace crown
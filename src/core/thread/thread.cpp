@@ -0,0 +1,403 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/error/error.inl"
+#include "core/thread/thread.h"
+#include <atomic>
+#include <new>
+
+#if CROWN_PLATFORM_WINDOWS
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+namespace crown
+{
+
+struct Thread::Private
+{
+    HANDLE handle;
+    ThreadFunction func;
+    void* user_data;
+    std::atomic<bool> running;
+    s32 exit_code;
+};
+
+static DWORD WINAPI thread_proc(void* arg)
+{
+    Thread::Private* p = (Thread::Private*)arg;
+    p->exit_code = p->func(p->user_data);
+    p->running.store(false, std::memory_order_release);
+    return 0;
+}
+
+Thread::Thread()
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+    _priv->handle = NULL;
+    _priv->func = NULL;
+    _priv->user_data = NULL;
+    _priv->running.store(false, std::memory_order_relaxed);
+    _priv->exit_code = 0;
+}
+
+Thread::~Thread()
+{
+    if (_priv->handle != NULL)
+        join();
+
+    _priv->~Private();
+}
+
+bool Thread::start(ThreadFunction func, void* user_data, u32 stack_size)
+{
+    CE_ASSERT(_priv->handle == NULL, "Thread is already started");
+    CE_ENSURE(func != NULL);
+
+    _priv->func = func;
+    _priv->user_data = user_data;
+    _priv->running.store(true, std::memory_order_relaxed);
+    _priv->handle = CreateThread(NULL, stack_size, thread_proc, _priv, STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+    if (_priv->handle == NULL)
+    {
+        _priv->running.store(false, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+s32 Thread::join()
+{
+    CE_ASSERT(_priv->handle != NULL, "Thread is not started");
+
+    WaitForSingleObject(_priv->handle, INFINITE);
+    CloseHandle(_priv->handle);
+    _priv->handle = NULL;
+    return _priv->exit_code;
+}
+
+bool Thread::is_running()
+{
+    return _priv->running.load(std::memory_order_acquire);
+}
+
+s32 Thread::exit_code()
+{
+    return _priv->exit_code;
+}
+
+bool Thread::set_name(const char* name)
+{
+    // SetThreadDescription() is only available since Windows 10 1607.
+    typedef HRESULT (WINAPI *SetThreadDescriptionFn)(HANDLE, PCWSTR);
+    static SetThreadDescriptionFn set_description = (SetThreadDescriptionFn)GetProcAddress(GetModuleHandleA("kernel32.dll"), "SetThreadDescription");
+    if (set_description == NULL)
+        return false;
+
+    WCHAR wname[64];
+    if (MultiByteToWideChar(CP_UTF8, 0, name, -1, wname, countof(wname)) == 0)
+        return false;
+
+    return SUCCEEDED(set_description(_priv->handle, wname));
+}
+
+bool Thread::set_affinity(const u32* cpus, u32 num)
+{
+    DWORD_PTR mask = 0;
+    for (u32 i = 0; i < num; ++i)
+    {
+        if (cpus[i] >= sizeof(mask) * 8)
+            return false;
+        mask |= DWORD_PTR(1) << cpus[i];
+    }
+
+    return SetThreadAffinityMask(_priv->handle, mask) != 0;
+}
+
+bool Thread::set_priority(ThreadPriority::Enum priority)
+{
+    const int priorities[] =
+    {
+        THREAD_PRIORITY_LOWEST,
+        THREAD_PRIORITY_BELOW_NORMAL,
+        THREAD_PRIORITY_NORMAL,
+        THREAD_PRIORITY_ABOVE_NORMAL,
+        THREAD_PRIORITY_HIGHEST
+    };
+    CE_STATIC_ASSERT(countof(priorities) == ThreadPriority::COUNT);
+
+    return SetThreadPriority(_priv->handle, priorities[priority]) != 0;
+}
+
+void* Thread::native_handle()
+{
+    return &_priv->handle;
+}
+
+namespace thread
+{
+    u32 num_cpus()
+    {
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        return si.dwNumberOfProcessors;
+    }
+
+    u32 physical_cores(u32* cpus, u32 max)
+    {
+        SYSTEM_LOGICAL_PROCESSOR_INFORMATION info[256];
+        DWORD size = sizeof(info);
+        if (!GetLogicalProcessorInformation(info, &size))
+            return 0;
+
+        u32 num = 0;
+        for (u32 i = 0; i < size / sizeof(info[0]); ++i)
+        {
+            if (info[i].Relationship != RelationProcessorCore)
+                continue;
+
+            // The first logical CPU of the core.
+            u32 cpu = 0;
+            while (((info[i].ProcessorMask >> cpu) & 1) == 0)
+                ++cpu;
+
+            if (num < max)
+                cpus[num] = cpu;
+            ++num;
+        }
+
+        return num;
+    }
+
+    void yield()
+    {
+        SwitchToThread();
+    }
+
+} // namespace thread
+
+} // namespace crown
+
+#else
+
+#include <pthread.h>
+#include <sched.h>          // sched_yield, sched_setaffinity
+#include <stdio.h>          // fopen, snprintf
+#include <string.h>         // strncpy
+#include <sys/resource.h>   // setpriority
+#include <sys/syscall.h>    // SYS_gettid
+#include <unistd.h>         // syscall, sysconf
+
+namespace crown
+{
+
+struct Thread::Private
+{
+    pthread_t handle;
+    ThreadFunction func;
+    void* user_data;
+    std::atomic<s32> tid; // Kernel id, 0 until the thread runs.
+    std::atomic<bool> running;
+    bool joinable;
+    s32 exit_code;
+};
+
+static void* thread_proc(void* arg)
+{
+    Thread::Private* p = (Thread::Private*)arg;
+    p->tid.store(s32(syscall(SYS_gettid)), std::memory_order_release);
+    p->exit_code = p->func(p->user_data);
+    p->running.store(false, std::memory_order_release);
+    return NULL;
+}
+
+Thread::Thread()
+{
+    CE_STATIC_ASSERT(sizeof(_data) >= sizeof(*_priv));
+    _priv = new (_data) Private();
+    _priv->func = NULL;
+    _priv->user_data = NULL;
+    _priv->tid.store(0, std::memory_order_relaxed);
+    _priv->running.store(false, std::memory_order_relaxed);
+    _priv->joinable = false;
+    _priv->exit_code = 0;
+}
+
+Thread::~Thread()
+{
+    if (_priv->joinable)
+        join();
+
+    _priv->~Private();
+}
+
+bool Thread::start(ThreadFunction func, void* user_data, u32 stack_size)
+{
+    CE_ASSERT(!_priv->joinable, "Thread is already started");
+    CE_ENSURE(func != NULL);
+
+    _priv->func = func;
+    _priv->user_data = user_data;
+    _priv->tid.store(0, std::memory_order_relaxed);
+    _priv->running.store(true, std::memory_order_relaxed);
+
+    pthread_attr_t attr;
+    int err = pthread_attr_init(&attr);
+    CE_ASSERT(err == 0, "pthread_attr_init: errno = %d", err);
+    err = pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+    CE_ASSERT(err == 0, "pthread_attr_setdetachstate: errno = %d", err);
+
+    // Both fail at run time, e.g. on a stack size below the minimum or
+    // when the process is out of threads.
+    if (stack_size != 0)
+        err = pthread_attr_setstacksize(&attr, stack_size);
+    if (err == 0)
+        err = pthread_create(&_priv->handle, &attr, thread_proc, _priv);
+
+    const int destroy_err = pthread_attr_destroy(&attr);
+    CE_ASSERT(destroy_err == 0, "pthread_attr_destroy: errno = %d", destroy_err);
+    CE_UNUSED(destroy_err);
+
+    if (err != 0)
+    {
+        _priv->running.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    _priv->joinable = true;
+
+    // The kernel id is needed to change the thread's affinity and
+    // priority. It is known a few microseconds after creation.
+    while (_priv->tid.load(std::memory_order_acquire) == 0)
+        sched_yield();
+
+    return true;
+}
+
+s32 Thread::join()
+{
+    CE_ASSERT(_priv->joinable, "Thread is not started");
+
+    int err = pthread_join(_priv->handle, NULL);
+    CE_ASSERT(err == 0, "pthread_join: errno = %d", err);
+    CE_UNUSED(err);
+    _priv->joinable = false;
+    return _priv->exit_code;
+}
+
+bool Thread::is_running()
+{
+    return _priv->running.load(std::memory_order_acquire);
+}
+
+s32 Thread::exit_code()
+{
+    return _priv->exit_code;
+}
+
+bool Thread::set_name(const char* name)
+{
+    CE_ASSERT(_priv->joinable, "Thread is not started");
+
+    // The kernel keeps at most 15 characters.
+    char buf[16];
+    strncpy(buf, name, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    return pthread_setname_np(_priv->handle, buf) == 0;
+}
+
+bool Thread::set_affinity(const u32* cpus, u32 num)
+{
+    CE_ASSERT(_priv->joinable, "Thread is not started");
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (u32 i = 0; i < num; ++i)
+    {
+        if (cpus[i] >= CPU_SETSIZE)
+            return false;
+        CPU_SET(cpus[i], &set);
+    }
+
+    return sched_setaffinity(_priv->tid.load(std::memory_order_relaxed), sizeof(set), &set) == 0;
+}
+
+bool Thread::set_priority(ThreadPriority::Enum priority)
+{
+    CE_ASSERT(_priv->joinable, "Thread is not started");
+
+    // Normal threads all have the same static priority on Linux, the
+    // scheduler weighs them by their nice value instead.
+    const int nices[] = { 10, 5, 0, -5, -10 };
+    CE_STATIC_ASSERT(countof(nices) == ThreadPriority::COUNT);
+
+    return setpriority(PRIO_PROCESS, id_t(_priv->tid.load(std::memory_order_relaxed)), nices[priority]) == 0;
+}
+
+void* Thread::native_handle()
+{
+    return &_priv->handle;
+}
+
+namespace thread
+{
+    u32 num_cpus()
+    {
+        const long num = sysconf(_SC_NPROCESSORS_ONLN);
+        return num > 0 ? u32(num) : 1u;
+    }
+
+    u32 physical_cores(u32* cpus, u32 max)
+    {
+        const long num_conf = sysconf(_SC_NPROCESSORS_CONF);
+        u32 num = 0;
+
+        for (long cpu = 0; cpu < num_conf; ++cpu)
+        {
+            // The first of the hardware threads sharing the core stands
+            // for it. Offline CPUs have no topology.
+            char path[128];
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%ld/topology/thread_siblings_list", cpu);
+            FILE* f = fopen(path, "r");
+            if (f == NULL)
+                continue;
+
+            long first = -1;
+            const int n = fscanf(f, "%ld", &first);
+            fclose(f);
+            if (n != 1 || first != cpu)
+                continue;
+
+            if (num < max)
+                cpus[num] = u32(cpu);
+            ++num;
+        }
+
+        // No topology (e.g. restricted /sys): assume one CPU per core.
+        if (num == 0)
+        {
+            num = num_cpus();
+            for (u32 i = 0; i < num && i < max; ++i)
+                cpus[i] = i;
+        }
+
+        return num;
+    }
+
+    void yield()
+    {
+        sched_yield();
+    }
+
+} // namespace thread
+
+} // namespace crown
+
+#endif
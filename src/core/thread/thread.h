@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/types.h"
+
+namespace crown
+{
+    typedef s32 (*ThreadFunction)(void* user_data);
+
+    // Scheduling priority of a thread, relative to the other threads of
+    // the process.
+    struct ThreadPriority
+    {
+        enum Enum
+        {
+            LOWEST,
+            LOW,
+            NORMAL,
+            HIGH,
+            HIGHEST,
+
+            COUNT
+        };
+    };
+
+    struct Thread
+    {
+        struct Private;
+        Private* _priv;
+        CE_ALIGN_DECL(16, u8 _data[64]);
+
+        Thread();
+
+        // Joins the thread if it was started and not joined yet.
+        ~Thread();
+
+        Thread(const Thread&) = delete;
+        Thread& operator=(const Thread&) = delete;
+
+        // Runs `func(user_data)` on a new thread with a stack of
+        // `stack_size` bytes, or of the platform's default size if 0.
+        // Returns false if the thread could not be created.
+        bool start(ThreadFunction func, void* user_data = NULL, u32 stack_size = 0);
+
+        // Waits for the thread to finish and returns the value returned
+        // by its function.
+        s32 join();
+
+        // Returns whether the function of the thread has not returned yet.
+        bool is_running();
+
+        // Returns the value returned by the function of the thread.
+        // Only valid after join().
+        s32 exit_code();
+
+        // Sets the name of the thread as shown by debuggers, top and perf.
+        // Linux truncates it to 15 characters.
+        bool set_name(const char* name);
+
+        // Restricts the thread to run on the `num` logical CPUs `cpus`.
+        bool set_affinity(const u32* cpus, u32 num);
+
+        // Sets the scheduling priority of the thread. Raising it above
+        // NORMAL may need privileges the process does not have, in which
+        // case false is returned.
+        bool set_priority(ThreadPriority::Enum priority);
+
+        // Returns the platform handle of the thread.
+        void* native_handle();
+    };
+
+    namespace thread
+    {
+        // Returns the number of logical CPUs.
+        u32 num_cpus();
+
+        // Writes to `cpus` one logical CPU per physical core, up to `max`,
+        // e.g. to pin one worker per core with Thread::set_affinity().
+        // Returns the number of physical cores.
+        u32 physical_cores(u32* cpus, u32 max);
+
+        // Gives the rest of the calling thread's time slice to another
+        // thread ready to run, if any.
+        void yield();
+
+    } // namespace thread
+
+} // namespace crown
@@ -11,9 +11,26 @@
 namespace crown
 {
     struct ConditionVariable;
+    struct Fiber;
+    struct Job;
+    struct JobCounter;
+    struct JobSystem;
+    struct LockCounters;
+    struct LockStats;
     struct Mutex;
+    template <typename T> struct MpmcQueue;
+    struct QueueStats;
+    struct ReadWriteLock;
     struct ScopedMutex;
+    struct ScopedReadLock;
+    struct ScopedSpinLock;
+    struct ScopedWriteLock;
     struct Semaphore;
+    struct SpinLock;
+    template <typename T> struct SpscQueue;
+    struct TaskGraph;
+    struct TaskTiming;
     struct Thread;
+    template <typename T> struct WorkStealingDeque;
 
 } // namespace crown
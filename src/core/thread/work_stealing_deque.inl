@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/error/error.inl"
+#include "core/memory/allocator.h"
+#include "core/thread/mpmc_queue.inl"
+#include "core/thread/queue_stats.h"
+#include <atomic>
+#include <new>
+
+namespace crown
+{
+    // Bounded Chase-Lev work-stealing deque of pointer-sized items.
+    //
+    // "Dynamic Circular Work-Stealing Deque", Chase and Lev, SPAA 2005, with
+    // the C11 memory orderings from "Correct and Efficient Work-Stealing for
+    // Weak Memory Models", Le et al., PPoPP 2013.
+    //
+    // The owner thread pushes and pops at the bottom, LIFO, without atomic
+    // read-modify-writes unless a single item is left. Any other thread
+    // steals from the top, FIFO, with a single CAS.
+    template <typename T>
+    struct WorkStealingDeque
+    {
+        Allocator* _allocator;
+        std::atomic<T>* _items;
+        s64 _mask;
+
+        // The owner and the thieves live on separate cache lines.
+        CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<s64> _bottom);
+        CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<s64> _top);
+
+        // Written by the owner only: thieves failing to steal do not touch
+        // the victim's counters.
+        CE_ALIGN_DECL(CROWN_CACHE_LINE_SIZE, std::atomic<u32> _num_full);
+        std::atomic<u32> _num_empty;
+
+        // Creates a deque holding up to `capacity` items, rounded up to the
+        // next power of two.
+        WorkStealingDeque(Allocator& a, u32 capacity);
+        ~WorkStealingDeque();
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        // Appends `item` at the bottom. Owner only.
+        // Returns false if the deque is full.
+        bool push(const T& item);
+
+        // Removes the newest item and copies it to `item`. Owner only.
+        // Returns false if the deque is empty.
+        bool pop(T& item);
+
+        // Removes the oldest item and copies it to `item`.
+        // Returns false if the deque is empty or another thread took the
+        // item first.
+        bool steal(T& item);
+
+        // Returns the maximum number of items the deque can hold.
+        u32 capacity() const;
+
+        // Returns the number of items in the deque. The value is only a
+        // snapshot when other threads are stealing.
+        u32 size() const;
+
+        // Returns the number of pushes to a full deque and of pops from an
+        // empty one so far. Failed steals are not counted.
+        QueueStats stats() const;
+    };
+
+    template <typename T>
+    inline WorkStealingDeque<T>::WorkStealingDeque(Allocator& a, u32 capacity)
+        : _allocator(&a)
+        , _items(NULL)
+        , _mask(0)
+        , _bottom(0)
+        , _top(0)
+        , _num_full(0)
+        , _num_empty(0)
+    {
+        CE_STATIC_ASSERT(sizeof(T) <= sizeof(void*));
+        CE_ASSERT(capacity >= 2, "Capacity must be >= 2");
+        capacity = queue_internal::next_pow2(capacity);
+
+        _items = (std::atomic<T>*)a.allocate(capacity * sizeof(std::atomic<T>), alignof(std::atomic<T>));
+        _mask = capacity - 1;
+
+        for (u32 i = 0; i < capacity; ++i)
+            new (&_items[i]) std::atomic<T>();
+    }
+
+    template <typename T>
+    inline WorkStealingDeque<T>::~WorkStealingDeque()
+    {
+        _allocator->deallocate(_items);
+    }
+
+    template <typename T>
+    inline bool WorkStealingDeque<T>::push(const T& item)
+    {
+        const s64 b = _bottom.load(std::memory_order_relaxed);
+        const s64 t = _top.load(std::memory_order_acquire);
+        if (b - t > _mask)
+        {
+            _num_full.store(_num_full.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        _items[b & _mask].store(item, std::memory_order_relaxed);
+        _bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    inline bool WorkStealingDeque<T>::pop(T& item)
+    {
+        // Reserve the bottom item before looking at the top, so that a
+        // thief racing for the same item sees the reservation.
+        const s64 b = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        s64 t = _top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            _num_empty.store(_num_empty.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = _items[b & _mask].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // Last item: race the thieves for it.
+            const bool won = _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    template <typename T>
+    inline bool WorkStealingDeque<T>::steal(T& item)
+    {
+        s64 t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const s64 b = _bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+            return false;
+
+        item = _items[t & _mask].load(std::memory_order_relaxed);
+        return _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    inline u32 WorkStealingDeque<T>::capacity() const
+    {
+        return u32(_mask + 1);
+    }
+
+    template <typename T>
+    inline u32 WorkStealingDeque<T>::size() const
+    {
+        const s64 b = _bottom.load(std::memory_order_relaxed);
+        const s64 t = _top.load(std::memory_order_relaxed);
+        return b > t ? u32(b - t) : 0;
+    }
+
+    template <typename T>
+    inline QueueStats WorkStealingDeque<T>::stats() const
+    {
+        QueueStats qs;
+        qs.num_full = _num_full.load(std::memory_order_relaxed);
+        qs.num_empty = _num_empty.load(std::memory_order_relaxed);
+        return qs;
+    }
+
+} // namespace crown
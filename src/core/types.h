@@ -76,12 +76,14 @@ inline T clamp(T val, T mmin, T mmax)
 #  define CE_LIKELY(x)                __builtin_expect((x), 1)
 #  define CE_UNLIKELY(x)              __builtin_expect((x), 0)
 #  define CE_UNREACHABLE()            __builtin_unreachable()
+#  define CE_NOINLINE                 __attribute__ ((noinline))
 #  define CE_ALIGN_DECL(align_, decl) decl __attribute__ ((aligned (align_)))
 #  define CE_THREAD                   __thread
 #elif CROWN_COMPILER_MSVC
 #  define CE_LIKELY(x)                (x)
 #  define CE_UNLIKELY(x)              (x)
 #  define CE_UNREACHABLE()
+#  define CE_NOINLINE                 __declspec(noinline)
 #  define CE_ALIGN_DECL(align_, decl) __declspec(align(align_)) decl
 #  define CE_THREAD                   __declspec(thread)
 #else
@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "core/xxh3.h"
+#include <string.h> // memcpy
+
+#if CROWN_SIMD_AVX2
+#  include <immintrin.h>
+#elif CROWN_SIMD_SSE2
+#  include <emmintrin.h>
+#endif
+
+#if CROWN_COMPILER_MSVC
+#  include <intrin.h>
+#endif
+
+namespace crown
+{
+    // XXH3, by Yann Collet
+    // https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+    //
+    // Same output as XXH3_64bits_withSeed() on little-endian machines.
+    // Inputs up to 240 bytes go through dedicated short paths; longer
+    // inputs are consumed in 64-byte stripes by eight 64-bit accumulators,
+    // vectorized with SSE2 or AVX2 when available.
+
+    static const u32 PRIME32_1 = 0x9E3779B1U;
+    static const u32 PRIME32_2 = 0x85EBCA77U;
+    static const u32 PRIME32_3 = 0xC2B2AE3DU;
+    static const u64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    static const u64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    static const u64 PRIME64_3 = 0x165667B19E3779F9ULL;
+    static const u64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    static const u64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+    static const u64 PRIME_MX1 = 0x165667919E3779F9ULL;
+    static const u64 PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+    static const u32 SECRET_SIZE = 192;
+    static const u32 STRIPE_LEN = 64;
+    static const u32 SECRET_CONSUME_RATE = 8;
+    static const u32 STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+    static const u32 BLOCK_LEN = STRIPE_LEN * STRIPES_PER_BLOCK;
+
+    CE_ALIGN_DECL(64, static const u8 DEFAULT_SECRET[SECRET_SIZE]) =
+    {
+        0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+        0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+        0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+        0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+        0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+        0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+        0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+        0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+        0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+        0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+        0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+        0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+    };
+
+    static inline u32 read32(const u8* p)
+    {
+        u32 v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static inline u64 read64(const u8* p)
+    {
+        u64 v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static inline void write64(u8* p, u64 v)
+    {
+        memcpy(p, &v, sizeof(v));
+    }
+
+    static inline u32 swap32(u32 x)
+    {
+        return ((x << 24) & 0xff000000U)
+            | ((x << 8) & 0x00ff0000U)
+            | ((x >> 8) & 0x0000ff00U)
+            | ((x >> 24) & 0x000000ffU)
+            ;
+    }
+
+    static inline u64 swap64(u64 x)
+    {
+        return (u64(swap32(u32(x))) << 32) | swap32(u32(x >> 32));
+    }
+
+    static inline u64 rotl64(u64 x, u32 r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    // Returns the low and high halves of the 128-bit product, xor-ed.
+    static inline u64 mul128_fold64(u64 a, u64 b)
+    {
+#if (CROWN_COMPILER_GCC || CROWN_COMPILER_CLANG) && CROWN_CPU_64BIT
+        const __uint128_t p = (__uint128_t)a * b;
+        return u64(p) ^ u64(p >> 64);
+#elif CROWN_COMPILER_MSVC && CROWN_CPU_64BIT
+        u64 hi;
+        const u64 lo = _umul128(a, b, &hi);
+        return lo ^ hi;
+#else
+        const u64 lo_lo = u64(u32(a)) * u32(b);
+        const u64 hi_lo = (a >> 32) * u32(b);
+        const u64 lo_hi = u64(u32(a)) * (b >> 32);
+        const u64 hi_hi = (a >> 32) * (b >> 32);
+        const u64 cross = (lo_lo >> 32) + u32(hi_lo) + lo_hi;
+        const u64 upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+        const u64 lower = (cross << 32) | u32(lo_lo);
+        return lower ^ upper;
+#endif
+    }
+
+    static inline u64 xxh64_avalanche(u64 h)
+    {
+        h ^= h >> 33;
+        h *= PRIME64_2;
+        h ^= h >> 29;
+        h *= PRIME64_3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    static inline u64 avalanche(u64 h)
+    {
+        h ^= h >> 37;
+        h *= PRIME_MX1;
+        h ^= h >> 32;
+        return h;
+    }
+
+    static inline u64 rrmxmx(u64 h, u64 len)
+    {
+        h ^= rotl64(h, 49) ^ rotl64(h, 24);
+        h *= PRIME_MX2;
+        h ^= (h >> 35) + len;
+        h *= PRIME_MX2;
+        h ^= h >> 28;
+        return h;
+    }
+
+    static inline u64 mix16(const u8* in, const u8* secret, u64 seed)
+    {
+        const u64 lo = read64(in + 0);
+        const u64 hi = read64(in + 8);
+        return mul128_fold64(lo ^ (read64(secret + 0) + seed), hi ^ (read64(secret + 8) - seed));
+    }
+
+    static inline u64 hash_0to16(const u8* in, u32 len, const u8* secret, u64 seed)
+    {
+        if (len > 8)
+        {
+            const u64 bitflip1 = (read64(secret + 24) ^ read64(secret + 32)) + seed;
+            const u64 bitflip2 = (read64(secret + 40) ^ read64(secret + 48)) - seed;
+            const u64 lo = read64(in) ^ bitflip1;
+            const u64 hi = read64(in + len - 8) ^ bitflip2;
+            const u64 acc = len + swap64(lo) + hi + mul128_fold64(lo, hi);
+            return avalanche(acc);
+        }
+
+        if (len >= 4)
+        {
+            seed ^= u64(swap32(u32(seed))) << 32;
+            const u32 in1 = read32(in);
+            const u32 in2 = read32(in + len - 4);
+            const u64 bitflip = (read64(secret + 8) ^ read64(secret + 16)) - seed;
+            const u64 keyed = (in2 + (u64(in1) << 32)) ^ bitflip;
+            return rrmxmx(keyed, len);
+        }
+
+        if (len > 0)
+        {
+            const u32 c1 = in[0];
+            const u32 c2 = in[len >> 1];
+            const u32 c3 = in[len - 1];
+            const u32 combined = (c1 << 16) | (c2 << 24) | (c3 << 0) | (len << 8);
+            const u64 bitflip = (read32(secret) ^ read32(secret + 4)) + seed;
+            return xxh64_avalanche(u64(combined) ^ bitflip);
+        }
+
+        return xxh64_avalanche(seed ^ (read64(secret + 56) ^ read64(secret + 64)));
+    }
+
+    static inline u64 hash_17to128(const u8* in, u32 len, const u8* secret, u64 seed)
+    {
+        u64 acc = len * PRIME64_1;
+
+        if (len > 32)
+        {
+            if (len > 64)
+            {
+                if (len > 96)
+                {
+                    acc += mix16(in + 48, secret + 96, seed);
+                    acc += mix16(in + len - 64, secret + 112, seed);
+                }
+                acc += mix16(in + 32, secret + 64, seed);
+                acc += mix16(in + len - 48, secret + 80, seed);
+            }
+            acc += mix16(in + 16, secret + 32, seed);
+            acc += mix16(in + len - 32, secret + 48, seed);
+        }
+        acc += mix16(in + 0, secret + 0, seed);
+        acc += mix16(in + len - 16, secret + 16, seed);
+
+        return avalanche(acc);
+    }
+
+    static u64 hash_129to240(const u8* in, u32 len, const u8* secret, u64 seed)
+    {
+        const u32 num_rounds = len / 16;
+        u64 acc = len * PRIME64_1;
+
+        for (u32 i = 0; i < 8; ++i)
+            acc += mix16(in + 16*i, secret + 16*i, seed);
+        acc = avalanche(acc);
+
+        for (u32 i = 8; i < num_rounds; ++i)
+            acc += mix16(in + 16*i, secret + 16*(i - 8) + 3, seed);
+        acc += mix16(in + len - 16, secret + 136 - 17, seed);
+
+        return avalanche(acc);
+    }
+
+    // Mixes one 64-byte stripe into the accumulators.
+    static inline void accumulate_512(u64* acc, const u8* in, const u8* secret)
+    {
+#if CROWN_SIMD_AVX2
+        __m256i* a = (__m256i*)acc;
+        for (u32 i = 0; i < 2; ++i)
+        {
+            const __m256i data = _mm256_loadu_si256((const __m256i*)in + i);
+            const __m256i key = _mm256_loadu_si256((const __m256i*)secret + i);
+            const __m256i data_key = _mm256_xor_si256(data, key);
+            const __m256i data_key_hi = _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            const __m256i product = _mm256_mul_epu32(data_key, data_key_hi);
+            const __m256i data_swap = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            a[i] = _mm256_add_epi64(product, _mm256_add_epi64(a[i], data_swap));
+        }
+#elif CROWN_SIMD_SSE2
+        __m128i* a = (__m128i*)acc;
+        for (u32 i = 0; i < 4; ++i)
+        {
+            const __m128i data = _mm_loadu_si128((const __m128i*)in + i);
+            const __m128i key = _mm_loadu_si128((const __m128i*)secret + i);
+            const __m128i data_key = _mm_xor_si128(data, key);
+            const __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+            const __m128i product = _mm_mul_epu32(data_key, data_key_hi);
+            const __m128i data_swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            a[i] = _mm_add_epi64(product, _mm_add_epi64(a[i], data_swap));
+        }
+#else
+        for (u32 i = 0; i < 8; ++i)
+        {
+            const u64 data = read64(in + 8*i);
+            const u64 data_key = data ^ read64(secret + 8*i);
+            acc[i ^ 1] += data;
+            acc[i] += u64(u32(data_key)) * (data_key >> 32);
+        }
+#endif
+    }
+
+    static inline void scramble(u64* acc, const u8* secret)
+    {
+#if CROWN_SIMD_AVX2
+        __m256i* a = (__m256i*)acc;
+        const __m256i prime = _mm256_set1_epi32(int(PRIME32_1));
+        for (u32 i = 0; i < 2; ++i)
+        {
+            const __m256i key = _mm256_loadu_si256((const __m256i*)secret + i);
+            __m256i v = _mm256_xor_si256(a[i], _mm256_srli_epi64(a[i], 47));
+            v = _mm256_xor_si256(v, key);
+            const __m256i v_hi = _mm256_shuffle_epi32(v, _MM_SHUFFLE(0, 3, 0, 1));
+            const __m256i lo = _mm256_mul_epu32(v, prime);
+            const __m256i hi = _mm256_mul_epu32(v_hi, prime);
+            a[i] = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+        }
+#elif CROWN_SIMD_SSE2
+        __m128i* a = (__m128i*)acc;
+        const __m128i prime = _mm_set1_epi32(int(PRIME32_1));
+        for (u32 i = 0; i < 4; ++i)
+        {
+            const __m128i key = _mm_loadu_si128((const __m128i*)secret + i);
+            __m128i v = _mm_xor_si128(a[i], _mm_srli_epi64(a[i], 47));
+            v = _mm_xor_si128(v, key);
+            const __m128i v_hi = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 3, 0, 1));
+            const __m128i lo = _mm_mul_epu32(v, prime);
+            const __m128i hi = _mm_mul_epu32(v_hi, prime);
+            a[i] = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+        }
+#else
+        for (u32 i = 0; i < 8; ++i)
+        {
+            u64 v = acc[i];
+            v ^= v >> 47;
+            v ^= read64(secret + 8*i);
+            v *= PRIME32_1;
+            acc[i] = v;
+        }
+#endif
+    }
+
+    static u64 hash_long(const u8* in, u32 len, const u8* secret)
+    {
+        CE_ALIGN_DECL(32, u64 acc[8]) =
+        {
+            PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+            PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1
+        };
+
+        const u32 num_blocks = (len - 1) / BLOCK_LEN;
+        for (u32 n = 0; n < num_blocks; ++n)
+        {
+            const u8* block = in + n*BLOCK_LEN;
+            for (u32 s = 0; s < STRIPES_PER_BLOCK; ++s)
+                accumulate_512(acc, block + s*STRIPE_LEN, secret + s*SECRET_CONSUME_RATE);
+            scramble(acc, secret + SECRET_SIZE - STRIPE_LEN);
+        }
+
+        // Last partial block, then the last stripe, which may overlap it.
+        const u8* block = in + num_blocks*BLOCK_LEN;
+        const u32 num_stripes = ((len - 1) - num_blocks*BLOCK_LEN) / STRIPE_LEN;
+        for (u32 s = 0; s < num_stripes; ++s)
+            accumulate_512(acc, block + s*STRIPE_LEN, secret + s*SECRET_CONSUME_RATE);
+        accumulate_512(acc, in + len - STRIPE_LEN, secret + SECRET_SIZE - STRIPE_LEN - 7);
+
+        // Merge the accumulators.
+        u64 h = len * PRIME64_1;
+        for (u32 i = 0; i < 4; ++i)
+            h += mul128_fold64(acc[2*i] ^ read64(secret + 11 + 16*i), acc[2*i + 1] ^ read64(secret + 11 + 16*i + 8));
+
+        return avalanche(h);
+    }
+
+    u64 xxh3_64(const void* key, u32 len, u64 seed)
+    {
+        const u8* in = (const u8*)key;
+
+        if (len <= 16)
+            return hash_0to16(in, len, DEFAULT_SECRET, seed);
+        if (len <= 128)
+            return hash_17to128(in, len, DEFAULT_SECRET, seed);
+        if (len <= 240)
+            return hash_129to240(in, len, DEFAULT_SECRET, seed);
+
+        if (seed == 0)
+            return hash_long(in, len, DEFAULT_SECRET);
+
+        // Long inputs fold the seed into a copy of the secret.
+        CE_ALIGN_DECL(64, u8 secret[SECRET_SIZE]);
+        for (u32 i = 0; i < SECRET_SIZE / 16; ++i)
+        {
+            write64(secret + 16*i + 0, read64(DEFAULT_SECRET + 16*i + 0) + seed);
+            write64(secret + 16*i + 8, read64(DEFAULT_SECRET + 16*i + 8) - seed);
+        }
+
+        return hash_long(in, len, secret);
+    }
+
+} // namespace crown
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#pragma once
+
+#include "core/types.h"
+
+namespace crown
+{
+    // Returns the 64-bit XXH3 hash of `len` bytes of `key`. Several times
+    // faster than murmur64() on large inputs. Results do not match murmur,
+    // so use murmur where hashes are persisted (e.g. StringId).
+    u64 xxh3_64(const void* key, u32 len, u64 seed);
+
+    // Hashes the bytes of a POD `T` with XXH3.
+    // Can be passed in place of hash<T> to hash based containers.
+    template <typename T>
+    struct xxh3_hash
+    {
+        u32 operator()(const T& val) const
+        {
+            return u32(xxh3_64(&val, sizeof(val), 0));
+        }
+    };
+
+} // namespace crown
@@ -0,0 +1,1274 @@
+/*
+ * Copyright (C) 2021-2077 FATCROWN Team.
+ * License: https://github.com/FatGraphicsLab/fatcrown/blob/main/LICENSE
+ *
+ * @author   kasicass@gmail.com
+ * @date     2026-10-19
+ */
+
+#include "config.h"
+#include "core/containers/array.inl"
+#include "core/containers/array_algorithms.inl"
+#include "core/containers/bit_array.inl"
+#include "core/containers/parallel_algorithms.inl"
+#include "core/guid.inl"
+#include "core/memory/globals.h"
+#include "core/murmur.h"
+#include "core/strings/number_parse.h"
+#include "core/strings/string_scan.h"
+#include "core/strings/string_stream.inl"
+#include "core/strings/string_table.h"
+#include "core/strings/string_view.inl"
+#include "core/strings/utf8.h"
+#include "core/strings/wildcard_set.h"
+#include "core/thread/concurrent_hash_map.inl"
+#include "core/thread/fiber.h"
+#include "core/thread/job_system.h"
+#include "core/thread/mutex.h"
+#include "core/thread/read_write_lock.h"
+#include "core/thread/semaphore.h"
+#include "core/thread/spin_lock.inl"
+#include "core/thread/task_graph.h"
+#include "core/thread/thread.h"
+#include "core/xxh3.h"
+
+#include <algorithm> // std::sort, std::stable_sort
+#include <chrono>
+#include <inttypes.h> // PRIx64, SCNx64
+#include <stdlib.h> // EXIT_SUCCESS, strtod
+#include <stdio.h>
+
+#if CROWN_PLATFORM_POSIX
+#  include <pthread.h>
+#endif
+
+namespace crown
+{
+    // Returns the current time in seconds.
+    static f64 now()
+    {
+        using namespace std::chrono;
+        return duration<f64>(high_resolution_clock::now().time_since_epoch()).count();
+    }
+
+    // Runs `fn` `iterations` times and prints the best time in ms.
+    template <typename F>
+    static f64 measure(const char* name, u32 iterations, F fn)
+    {
+        f64 best = 1e30;
+        for (u32 i = 0; i < iterations; ++i)
+        {
+            const f64 start = now();
+            fn();
+            const f64 elapsed = now() - start;
+            best = elapsed < best ? elapsed : best;
+        }
+
+        printf("    %-40s %10.3f ms\n", name, best * 1000.0);
+        return best;
+    }
+
+    static u64 random_u64(u64& state)
+    {
+        // xorshift64*
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545f4914f6cdd1dull;
+    }
+
+    static void bench_sort()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM = 1024*1024;
+
+        Array<u32> src32(a);
+        Array<u64> src64(a);
+        u64 state = 0x0badbeef;
+        for (u32 i = 0; i < NUM; ++i)
+        {
+            const u64 r = random_u64(state);
+            array::push_back(src32, u32(r));
+            array::push_back(src64, r);
+        }
+
+        printf("sort %u keys\n", NUM);
+
+        Array<u32> v32(a);
+        const f64 std32 = measure("std::sort u32", 5, [&]() { v32 = src32; std::sort(array::begin(v32), array::end(v32)); });
+        const f64 rdx32 = measure("array::radix_sort u32", 5, [&]() { v32 = src32; array::radix_sort(v32, a); });
+        measure("array::merge_sort u32", 5, [&]() { v32 = src32; array::merge_sort(v32, less<u32>(), a); });
+        measure("std::stable_sort u32", 5, [&]() { v32 = src32; std::stable_sort(array::begin(v32), array::end(v32)); });
+
+        Array<u64> v64(a);
+        const f64 std64 = measure("std::sort u64", 5, [&]() { v64 = src64; std::sort(array::begin(v64), array::end(v64)); });
+        const f64 rdx64 = measure("array::radix_sort u64", 5, [&]() { v64 = src64; array::radix_sort(v64, a); });
+
+        Array<u32> values(a);
+        array::resize(values, NUM);
+        measure("array::radix_sort u64 -> u32", 5, [&]() { v64 = src64; array::radix_sort(v64, values, a); });
+
+        printf("    radix_sort speedup: u32 %.1fx, u64 %.1fx\n", std32 / rdx32, std64 / rdx64);
+    }
+
+    static void bench_search()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM = 1024*1024;
+
+        Array<u32> v(a);
+        for (u32 i = 0; i < NUM; ++i)
+            array::push_back(v, i);
+
+        printf("search %u u32\n", NUM);
+
+        volatile u32 sink = 0;
+        measure("std::find", 20, [&]() { sink = u32(std::find(array::begin(v), array::end(v), NUM - 1) - array::begin(v)); });
+        measure("array::find", 20, [&]() { sink = array::find(v, NUM - 1); });
+        measure("std::count", 20, [&]() { sink = u32(std::count(array::begin(v), array::end(v), 7u)); });
+        measure("array::count", 20, [&]() { sink = array::count(v, 7u); });
+        measure("std::minmax_element", 20, [&]() { sink = *std::minmax_element(array::begin(v), array::end(v)).second; });
+        measure("array::min_max", 20, [&]() { u32 mn, mx; array::min_max(v, mn, mx); sink = mx; });
+        CE_UNUSED(sink);
+    }
+
+    static void bench_bit_array()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM = 64*1024*1024;
+
+        BitArray x(a);
+        BitArray y(a);
+        bit_array::resize(x, NUM);
+        bit_array::resize(y, NUM);
+        u64 state = 0x0badbeef;
+        for (u32 i = 0; i < NUM / 64; ++i)
+        {
+            x._data[i] = random_u64(state);
+            y._data[i] = random_u64(state);
+        }
+
+        printf("bit_array %u bits\n", NUM);
+
+        volatile u32 sink = 0;
+        measure("bit_array::count", 10, [&]() { sink = bit_array::count(x); });
+        measure("bit_array::bit_and", 10, [&]() { bit_array::bit_and(x, y); });
+        measure("bit_array::bit_xor", 10, [&]() { bit_array::bit_xor(x, y); });
+
+        bit_array::clear_all(x);
+        bit_array::set(x, NUM - 1);
+        measure("bit_array::find_first_set (sparse)", 10, [&]() { sink = bit_array::find_first_set(x); });
+        CE_UNUSED(sink);
+    }
+
+    static void bench_hash()
+    {
+        Allocator& a = default_allocator();
+        const u32 TOTAL = 16*1024*1024;
+
+        Array<u8> data(a);
+        array::resize(data, TOTAL);
+        u64 state = 0x0badbeef;
+        for (u32 i = 0; i < TOTAL; ++i)
+            data[i] = u8(random_u64(state));
+
+        printf("hash %u bytes in keys of\n", TOTAL);
+
+        const u32 sizes[] = { 8, 16, 32, 64, 256, 1024, 64*1024, TOTAL };
+        volatile u64 sink = 0;
+        for (u32 i = 0; i < countof(sizes); ++i)
+        {
+            const u32 len = sizes[i];
+            const u32 num = TOTAL / len;
+            char name[64];
+
+            snprintf(name, sizeof(name), "murmur64 %u", len);
+            const f64 mm = measure(name, 5, [&]() { for (u32 k = 0; k < num; ++k) sink = murmur64(&data[k*len], len, 0); });
+            snprintf(name, sizeof(name), "xxh3_64 %u", len);
+            const f64 xx = measure(name, 5, [&]() { for (u32 k = 0; k < num; ++k) sink = xxh3_64(&data[k*len], len, 0); });
+
+            printf("    xxh3_64 speedup: %.1fx (%.2f GB/s)\n", mm / xx, TOTAL / xx / 1e9);
+        }
+        CE_UNUSED(sink);
+    }
+
+    static void bench_string_stream()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM = 256*1024;
+
+        Array<s32> ints(a);
+        Array<f64> floats(a);
+        array::resize(ints, NUM);
+        array::resize(floats, NUM);
+        u64 state = 0x0badbeef;
+        for (u32 i = 0; i < NUM; ++i)
+        {
+            const u64 r = random_u64(state);
+            ints[i] = s32(r) >> (r >> 59);
+            floats[i] = f64(s32(r)) / f64(1u << (r >> 59));
+        }
+
+        printf("stream %u numbers\n", NUM);
+
+        StringStream ss(a);
+        array::reserve(ss, NUM*32);
+
+        const f64 int_printf = measure("s32 stream_printf", 5, [&]() {
+            array::clear(ss);
+            for (u32 i = 0; i < NUM; ++i)
+                string_stream::stream_printf(ss, "%d", ints[i]);
+        });
+        const f64 int_direct = measure("s32 operator<<", 5, [&]() {
+            array::clear(ss);
+            for (u32 i = 0; i < NUM; ++i)
+                ss << ints[i];
+        });
+        printf("    s32 speedup: %.1fx\n", int_printf / int_direct);
+
+        const f64 hex_printf = measure("hex stream_printf", 5, [&]() {
+            array::clear(ss);
+            for (u32 i = 0; i < NUM; ++i)
+                string_stream::stream_printf(ss, "%08x", ints[i]);
+        });
+        const f64 hex_direct = measure("hex stream_hex", 5, [&]() {
+            array::clear(ss);
+            for (u32 i = 0; i < NUM; ++i)
+                string_stream::stream_hex(ss, u32(ints[i]), 8);
+        });
+        printf("    hex speedup: %.1fx\n", hex_printf / hex_direct);
+
+        const f64 f64_printf = measure("f64 stream_printf", 5, [&]() {
+            array::clear(ss);
+            for (u32 i = 0; i < NUM; ++i)
+                string_stream::stream_printf(ss, "%.17g", floats[i]);
+        });
+        const f64 f64_direct = measure("f64 operator<<", 5, [&]() {
+            array::clear(ss);
+            for (u32 i = 0; i < NUM; ++i)
+                ss << floats[i];
+        });
+        printf("    f64 speedup: %.1fx\n", f64_printf / f64_direct);
+    }
+
+    static void bench_string_scan()
+    {
+        Allocator& a = default_allocator();
+        const u32 SIZE = 8*1024*1024;
+
+        // Indented config-like text with nested blocks.
+        Array<char> text(a);
+        u64 state = 0x0badbeef;
+        while (array::size(text) < SIZE)
+        {
+            const u64 r = random_u64(state);
+            const char* line = (r & 3) == 0 ? "foo = {\n" : (r & 3) == 1 ? "}\n" : "bar_baz = 1234.5678\n";
+            for (u32 i = 0; i < ((r >> 8) & 15); ++i)
+                array::push_back(text, ' ');
+            array::push(text, line, strlen32(line));
+        }
+        array::push_back(text, '\0');
+        const StringView sv(array::begin(text), array::size(text) - 1);
+
+        printf("scan %u bytes\n", sv._length);
+
+        volatile u32 sink = 0;
+
+        const f64 nl_scalar = measure("count lines with strnl", 5, [&]() {
+            u32 num = 0;
+            for (const char* p = sv._data; *p != '\0'; p = strnl(p))
+                ++num;
+            sink = num;
+        });
+        const f64 nl_simd = measure("string_scan::count_newlines", 5, [&]() {
+            sink = string_scan::count_newlines(sv);
+        });
+        printf("    count_newlines speedup: %.1fx\n", nl_scalar / nl_simd);
+
+        const f64 sp_scalar = measure("tokenize with skip_spaces", 5, [&]() {
+            u32 num = 0;
+            for (const char* p = skip_spaces(sv._data); *p != '\0'; p = skip_spaces(strnl(p)))
+                ++num;
+            sink = num;
+        });
+        const f64 sp_simd = measure("tokenize with string_scan", 5, [&]() {
+            u32 num = 0;
+            for (u32 i = string_scan::skip_spaces(sv); i < sv._length; i = string_scan::skip_spaces(sv, string_scan::find(sv, '\n', i) + 1))
+                ++num;
+            sink = num;
+        });
+        printf("    skip_spaces + find speedup: %.1fx\n", sp_scalar / sp_simd);
+
+        const f64 bl_scalar = measure("skip_block", 5, [&]() {
+            sink = u32(skip_block(sv._data, '[', ']') != NULL);
+        });
+        const f64 bl_simd = measure("string_scan::find_block_end", 5, [&]() {
+            sink = string_scan::find_block_end(sv, '[', ']');
+        });
+        printf("    find_block_end speedup: %.1fx\n", bl_scalar / bl_simd);
+        CE_UNUSED(sink);
+    }
+
+    static void bench_wildcard_set()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM_PATHS = 100*1000;
+        const u32 NUM_PATTERNS = 200;
+
+        const char* dirs[] = { "units", "levels", "core", "textures", "sounds", "shaders", "scripts", "fonts" };
+        const char* exts[] = { "unit", "level", "texture", "png", "wav", "shader", "lua", "font", "material", "mesh" };
+
+        Array<char> text(a);
+        Array<u32> offsets(a);
+        u64 state = 0x0badbeef;
+        char buf[256];
+
+        for (u32 i = 0; i < NUM_PATHS; ++i)
+        {
+            const u64 r = random_u64(state);
+            const s32 len = snprintf(buf, sizeof(buf), "%s/%s_%u/item_%u.%s"
+                , dirs[r % countof(dirs)]
+                , dirs[(r >> 8) % countof(dirs)]
+                , u32(r >> 16) % 100
+                , u32(r >> 32) % 1000
+                , exts[(r >> 48) % countof(exts)]
+                );
+            array::push_back(offsets, array::size(text));
+            array::push(text, buf, u32(len) + 1);
+        }
+
+        WildcardSet ws(a);
+        Array<char> patterns(a);
+        Array<u32> pattern_offsets(a);
+        for (u32 i = 0; i < NUM_PATTERNS; ++i)
+        {
+            const u64 r = random_u64(state);
+            s32 len = 0;
+            switch (r % 4)
+            {
+            case 0: len = snprintf(buf, sizeof(buf), "%s/*.%s", dirs[(r >> 8) % countof(dirs)], exts[(r >> 16) % countof(exts)]); break;
+            case 1: len = snprintf(buf, sizeof(buf), "*.%s", exts[(r >> 16) % countof(exts)]); break;
+            case 2: len = snprintf(buf, sizeof(buf), "%s/%s_%u/*", dirs[(r >> 8) % countof(dirs)], dirs[(r >> 24) % countof(dirs)], u32(r >> 32) % 100); break;
+            case 3: len = snprintf(buf, sizeof(buf), "*/item_%u?.*", u32(r >> 32) % 100); break;
+            }
+            ws.add(buf);
+            array::push_back(pattern_offsets, array::size(patterns));
+            array::push(patterns, buf, u32(len) + 1);
+        }
+        ws.compile();
+
+        printf("wildcard match %u paths against %u patterns\n", NUM_PATHS, NUM_PATTERNS);
+
+        volatile u32 sink = 0;
+        const f64 naive = measure("wildcmp", 3, [&]() {
+            u32 num = 0;
+            for (u32 i = 0; i < NUM_PATHS; ++i)
+            {
+                for (u32 j = 0; j < NUM_PATTERNS; ++j)
+                    num += wildcmp(&patterns[pattern_offsets[j]], &text[offsets[i]]);
+            }
+            sink = num;
+        });
+
+        BitArray matched(a);
+        const f64 set = measure("WildcardSet::match", 3, [&]() {
+            u32 num = 0;
+            for (u32 i = 0; i < NUM_PATHS; ++i)
+                num += ws.match(&text[offsets[i]], matched);
+            sink = num;
+        });
+        printf("    WildcardSet speedup: %.1fx\n", naive / set);
+        CE_UNUSED(sink);
+    }
+
+    static void bench_number_parse()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM = 256*1024;
+
+        Array<char> ints(a);
+        Array<char> hexes(a);
+        Array<char> floats(a);
+        u64 state = 0x0badbeef;
+        char buf[64];
+        for (u32 i = 0; i < NUM; ++i)
+        {
+            const u64 r = random_u64(state);
+            s32 len = snprintf(buf, sizeof(buf), "%d", s32(r) >> (r >> 59));
+            array::push(ints, buf, u32(len) + 1);
+            len = snprintf(buf, sizeof(buf), "%.16llx", (unsigned long long)r);
+            array::push(hexes, buf, u32(len) + 1);
+            len = snprintf(buf, sizeof(buf), "%.*f", s32(r >> 60) % 7, f64(s32(r)) / 1024.0);
+            array::push(floats, buf, u32(len) + 1);
+        }
+
+        printf("parse %u numbers\n", NUM);
+
+        volatile u64 sink = 0;
+        volatile f64 fsink = 0.0;
+        const f64 int_sscanf = measure("s32 sscanf", 5, [&]() {
+            for (const char* p = array::begin(ints); p != array::end(ints); p += strlen(p) + 1)
+            {
+                s32 v;
+                sscanf(p, "%d", &v);
+                sink = v;
+            }
+        });
+        const f64 int_parse = measure("s32 parse_s32", 5, [&]() {
+            for (const char* p = array::begin(ints); p != array::end(ints); )
+            {
+                s32 v;
+                p += parse_s32(StringView(p, u32(array::end(ints) - p)), v).consumed + 1;
+                sink = v;
+            }
+        });
+        printf("    s32 speedup: %.1fx\n", int_sscanf / int_parse);
+
+        const f64 hex_sscanf = measure("hex sscanf", 5, [&]() {
+            for (const char* p = array::begin(hexes); p != array::end(hexes); p += 17)
+            {
+                u32 id[2];
+                sscanf(p, "%8x%8x", &id[0], &id[1]);
+                sink = id[0];
+            }
+        });
+        const f64 hex_parse = measure("hex parse_hex", 5, [&]() {
+            for (const char* p = array::begin(hexes); p != array::end(hexes); p += 17)
+            {
+                u64 v;
+                parse_hex(StringView(p, 16), v);
+                sink = v;
+            }
+        });
+        printf("    hex speedup: %.1fx\n", hex_sscanf / hex_parse);
+
+        const f64 f64_strtod = measure("f64 strtod", 5, [&]() {
+            for (const char* p = array::begin(floats); p != array::end(floats); )
+            {
+                char* end;
+                fsink = strtod(p, &end);
+                p = end + 1;
+            }
+        });
+        const f64 f64_parse = measure("f64 parse_f64", 5, [&]() {
+            for (const char* p = array::begin(floats); p != array::end(floats); )
+            {
+                f64 v;
+                p += parse_f64(StringView(p, u32(array::end(floats) - p)), v).consumed + 1;
+                fsink = v;
+            }
+        });
+        printf("    f64 speedup: %.1fx\n", f64_strtod / f64_parse);
+        CE_UNUSED(sink);
+        CE_UNUSED(fsink);
+    }
+
+    static void bench_string_table()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM = 500*1000;
+        const char* dirs[] = { "units", "levels", "core", "textures", "sounds", "shaders", "scripts", "fonts" };
+
+        // Paths with duplicates, NUL separated.
+        Array<char> text(a);
+        Array<u32> offsets(a);
+        u64 state = 0x5eed;
+        char buf[256];
+        for (u32 i = 0; i < NUM; ++i)
+        {
+            const u64 r = random_u64(state);
+            const s32 len = snprintf(buf, sizeof(buf), "%s/%s_%u/item_%u.unit"
+                , dirs[r % countof(dirs)]
+                , dirs[(r >> 8) % countof(dirs)]
+                , u32(r >> 16) % 20
+                , u32(r >> 32) % 200
+                );
+            array::push_back(offsets, array::size(text));
+            array::push(text, buf, u32(len) + 1);
+        }
+
+        printf("string table of %u paths\n", NUM);
+
+        Array<char*> heap(a);
+        array::resize(heap, NUM);
+        measure("copy each to the heap", 3, [&]() {
+            for (u32 i = 0; i < NUM; ++i)
+            {
+                const char* str = &text[offsets[i]];
+                const u32 len = strlen32(str);
+                heap[i] = (char*)a.allocate(len + 1, 1);
+                memcpy(heap[i], str, len + 1);
+            }
+            for (u32 i = 0; i < NUM; ++i)
+                a.deallocate(heap[i]);
+        });
+
+        StringTable st(a);
+        measure("StringTable::add", 3, [&]() {
+            st.clear();
+            for (u32 i = 0; i < NUM; ++i)
+                st.add(&text[offsets[i]]);
+        });
+        printf("    %u heap blocks, %u KiB -> %u unique strings in %u pages, %u KiB\n"
+            , NUM
+            , array::size(text) / 1024
+            , st.size()
+            , array::size(st._pages)
+            , st.data_size() / 1024
+            );
+
+        Buffer blob(a);
+        st.save(blob);
+        char* mem = (char*)a.allocate(array::size(blob), 8);
+        memcpy(mem, blob._data, array::size(blob));
+
+        StringTable copy(a);
+        measure("load by re-adding the strings", 3, [&]() {
+            copy.clear();
+            StringTableBlob stb;
+            stb.open(mem, array::size(blob));
+            for (u32 i = 0; i < stb._capacity; ++i)
+            {
+                if (stb._index[i].offset != StringTable::NO_OFFSET)
+                    copy.add(StringView(stb.c_str(stb._index[i].offset), stb._index[i].length));
+            }
+        });
+
+        volatile u32 sink = 0;
+        measure("load with StringTableBlob::open", 3, [&]() {
+            StringTableBlob stb;
+            sink = stb.open(mem, array::size(blob));
+        });
+
+        StringTableBlob stb;
+        stb.open(mem, array::size(blob));
+        measure("StringTableBlob::find", 3, [&]() {
+            for (u32 i = 0; i < NUM; ++i)
+                sink = stb.find(&text[offsets[i]]);
+        });
+
+        a.deallocate(mem);
+        CE_UNUSED(sink);
+    }
+
+    // Byte at a time validation, the baseline for utf8::validate().
+    static bool validate_utf8_scalar(const u8* s, u32 n)
+    {
+        for (u32 i = 0; i < n; )
+        {
+            const u32 c = s[i];
+            u32 len;
+            u32 min;
+            if (c < 0x80) { ++i; continue; }
+            else if (c >= 0xc2 && c < 0xe0) { len = 2; min = 0x80; }
+            else if (c >= 0xe0 && c < 0xf0) { len = 3; min = 0x800; }
+            else if (c >= 0xf0 && c < 0xf5) { len = 4; min = 0x10000; }
+            else return false;
+
+            if (n - i < len)
+                return false;
+            u32 cp = c & (0x7f >> len);
+            for (u32 k = 1; k < len; ++k)
+            {
+                if ((s[i + k] & 0xc0) != 0x80)
+                    return false;
+                cp = cp << 6 | (s[i + k] & 0x3f);
+            }
+            if (cp < min || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+                return false;
+            i += len;
+        }
+        return true;
+    }
+
+    static void bench_utf8()
+    {
+        Allocator& a = default_allocator();
+        const char* words[] = { "texture", "unit", "level", "\xc3\xa9t\xc3\xa9", "\xe4\xb8\xad\xe6\x96\x87", "\xf0\x9f\x98\x80", "material", "shader" };
+
+        // Mostly ASCII text and text with a word in three not ASCII.
+        Array<char> ascii(a);
+        Array<char> mixed(a);
+        u64 state = 0x77;
+        while (array::size(mixed) < 16*1024*1024)
+        {
+            const u64 r = random_u64(state);
+            const char* w = words[r % countof(words)];
+            array::push(mixed, w, strlen32(w));
+            array::push_back(mixed, ' ');
+
+            const char* aw = words[(r >> 8) % 3];
+            array::push(ascii, aw, strlen32(aw));
+            array::push_back(ascii, (r >> 16) % 64 == 0 ? '\xc3' : ' ');
+            if ((r >> 16) % 64 == 0)
+                array::push_back(ascii, '\xa9');
+        }
+
+        const StringView texts[] = { StringView(ascii._data, array::size(ascii)), StringView(mixed._data, array::size(mixed)) };
+        const char* names[] = { "mostly ascii", "mixed" };
+        Array<u16> u16s(a);
+        Array<char> back(a);
+        volatile u32 sink = 0;
+
+        for (u32 t = 0; t < countof(texts); ++t)
+        {
+            const StringView& s = texts[t];
+            const f64 mb = s._length / (1024.0 * 1024.0);
+            printf("utf8 %s, %.0f MiB\n", names[t], mb);
+
+            const f64 scalar = measure("validate byte at a time", 5, [&]() { sink = validate_utf8_scalar((const u8*)s._data, s._length); });
+            const f64 simd = measure("utf8::validate", 5, [&]() { sink = utf8::validate(s); });
+            printf("    validate speedup: %.1fx, %.2f GiB/s\n", scalar / simd, mb / 1024.0 / simd);
+            const f64 count = measure("utf8::count_code_points", 5, [&]() { sink = utf8::count_code_points(s); });
+            printf("    count: %.2f GiB/s\n", mb / 1024.0 / count);
+            measure("utf8::to_utf16", 5, [&]() { array::clear(u16s); sink = utf8::to_utf16(s, u16s); });
+            measure("utf8::from_utf16", 5, [&]() { array::clear(back); sink = utf8::from_utf16(u16s._data, array::size(u16s), back); });
+        }
+        CE_UNUSED(sink);
+    }
+
+    static void bench_guid()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM = 1000*1000;
+
+        printf("guid %u ids\n", NUM);
+
+        Array<Guid> guids(a);
+        array::resize(guids, NUM);
+        measure("guid::new_guid", 5, [&]() {
+            for (u32 i = 0; i < NUM; ++i)
+                guids[i] = guid::new_guid();
+        });
+
+        Array<char> text(a);
+        array::resize(text, NUM * GUID_BUF_LEN);
+        const f64 fmt_printf = measure("to string with snprintf", 5, [&]() {
+            for (u32 i = 0; i < NUM; ++i)
+            {
+                const Guid& g = guids[i];
+                snprintf(&text[i * GUID_BUF_LEN], GUID_BUF_LEN, "%.8x-%.4x-%.4x-%.4x-%.12" PRIx64
+                    , u32(g.hi >> 32)
+                    , u32(g.hi >> 16) & 0xffff
+                    , u32(g.hi) & 0xffff
+                    , u32(g.lo >> 48)
+                    , g.lo & 0xffffffffffffull
+                    );
+            }
+        });
+        const f64 fmt_direct = measure("guid::to_string", 5, [&]() {
+            for (u32 i = 0; i < NUM; ++i)
+                guid::to_string(&text[i * GUID_BUF_LEN], GUID_BUF_LEN, guids[i]);
+        });
+        printf("    to string speedup: %.1fx\n", fmt_printf / fmt_direct);
+
+        volatile u64 sink = 0;
+        const f64 parse_sscanf = measure("parse with sscanf", 5, [&]() {
+            for (u32 i = 0; i < NUM; ++i)
+            {
+                u32 g[5];
+                u64 last;
+                sscanf(&text[i * GUID_BUF_LEN], "%8x-%4x-%4x-%4x-%12" SCNx64, &g[0], &g[1], &g[2], &g[3], &last);
+                sink = last;
+            }
+        });
+        const f64 parse_direct = measure("guid::try_parse", 5, [&]() {
+            for (u32 i = 0; i < NUM; ++i)
+            {
+                Guid g;
+                guid::try_parse(g, StringView(&text[i * GUID_BUF_LEN], GUID_BUF_LEN - 1));
+                sink = g.lo;
+            }
+        });
+        printf("    parse speedup: %.1fx\n", parse_sscanf / parse_direct);
+        CE_UNUSED(sink);
+    }
+
+#if CROWN_PLATFORM_POSIX
+    // The POSIX Mutex before it used futexes.
+    struct ErrorCheckMutex
+    {
+        pthread_mutex_t _mutex;
+
+        ErrorCheckMutex()
+        {
+            pthread_mutexattr_t attr;
+            pthread_mutexattr_init(&attr);
+            pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ERRORCHECK);
+            pthread_mutex_init(&_mutex, &attr);
+            pthread_mutexattr_destroy(&attr);
+        }
+
+        ~ErrorCheckMutex()
+        {
+            pthread_mutex_destroy(&_mutex);
+        }
+
+        void lock() { pthread_mutex_lock(&_mutex); }
+        void unlock() { pthread_mutex_unlock(&_mutex); }
+    };
+#endif
+
+    template <typename M>
+    struct LockLoop
+    {
+        M mutex;
+        u32 num;
+        u64 counter;
+
+        static s32 run(void* user_data)
+        {
+            LockLoop& l = *(LockLoop*)user_data;
+            for (u32 i = 0; i < l.num; ++i)
+            {
+                l.mutex.lock();
+                ++l.counter;
+                l.mutex.unlock();
+            }
+            return 0;
+        }
+    };
+
+    // Mutex with the interface of ReadWriteLock.
+    struct ExclusiveLock
+    {
+        Mutex mutex;
+
+        void lock_read() { mutex.lock(); }
+        void unlock_read() { mutex.unlock(); }
+        void lock_write() { mutex.lock(); }
+        void unlock_write() { mutex.unlock(); }
+    };
+
+    // Readers sum a small table, one access in 64 updates it.
+    template <typename L>
+    struct ReadLoop
+    {
+        L lock;
+        u32 num;
+        u64 table[16];
+
+        static s32 run(void* user_data)
+        {
+            ReadLoop& l = *(ReadLoop*)user_data;
+            u64 sum = 0;
+            for (u32 i = 0; i < l.num; ++i)
+            {
+                if (i % 64 == 0)
+                {
+                    l.lock.lock_write();
+                    ++l.table[i % countof(l.table)];
+                    l.lock.unlock_write();
+                }
+                else
+                {
+                    l.lock.lock_read();
+                    for (u32 j = 0; j < countof(l.table); ++j)
+                        sum += l.table[j];
+                    l.lock.unlock_read();
+                }
+            }
+            return s32(sum & 1);
+        }
+    };
+
+    // Runs ReadLoop<L>::run() on `num_threads` threads.
+    template <typename L>
+    static void read_loop(u32 num_threads, u32 num)
+    {
+        ReadLoop<L> l;
+        l.num = num / num_threads;
+        memset(l.table, 0, sizeof(l.table));
+
+        Thread threads[8];
+        for (u32 i = 0; i < num_threads; ++i)
+            threads[i].start(ReadLoop<L>::run, &l);
+        for (u32 i = 0; i < num_threads; ++i)
+            threads[i].join();
+    }
+
+    // Runs LockLoop<M>::run() on `num_threads` threads.
+    template <typename M>
+    static void lock_loop(u32 num_threads, u32 num)
+    {
+        LockLoop<M> l;
+        l.num = num / num_threads;
+        l.counter = 0;
+
+        Thread threads[8];
+        for (u32 i = 0; i < num_threads; ++i)
+            threads[i].start(LockLoop<M>::run, &l);
+        for (u32 i = 0; i < num_threads; ++i)
+            threads[i].join();
+    }
+
+    static void bench_mutex()
+    {
+        const u32 NUM = 4*1000*1000;
+
+        printf("mutex %u lock/unlock\n", NUM);
+
+        for (u32 num_threads = 1; num_threads <= 8; num_threads *= 2)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "Mutex, %u threads", num_threads);
+            const f64 t_mutex = measure(name, 3, [&]() { lock_loop<Mutex>(num_threads, NUM); });
+            snprintf(name, sizeof(name), "SpinLock, %u threads", num_threads);
+            measure(name, 3, [&]() { lock_loop<SpinLock>(num_threads, NUM); });
+#if CROWN_PLATFORM_POSIX
+            snprintf(name, sizeof(name), "pthread errorcheck, %u threads", num_threads);
+            const f64 t_pthread = measure(name, 3, [&]() { lock_loop<ErrorCheckMutex>(num_threads, NUM); });
+            printf("    speedup: %.1fx\n", t_pthread / t_mutex);
+#else
+            CE_UNUSED(t_mutex);
+#endif
+        }
+
+        printf("read-mostly %u accesses\n", NUM);
+        for (u32 num_threads = 1; num_threads <= 8; num_threads *= 2)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "Mutex, %u threads", num_threads);
+            const f64 t_mutex = measure(name, 3, [&]() { read_loop<ExclusiveLock>(num_threads, NUM); });
+            snprintf(name, sizeof(name), "ReadWriteLock, %u threads", num_threads);
+            const f64 t_rw = measure(name, 3, [&]() { read_loop<ReadWriteLock>(num_threads, NUM); });
+            printf("    speedup: %.1fx\n", t_mutex / t_rw);
+        }
+
+        Semaphore sem;
+        measure("Semaphore post/wait", 3, [&]() {
+            for (u32 i = 0; i < NUM; ++i)
+            {
+                sem.post();
+                sem.wait();
+            }
+        });
+    }
+
+    // Readers look up random keys, one access in `write_every` sets one.
+    struct MapLoop
+    {
+        ConcurrentHashMap<u64, u64>* map;
+        u32 num;
+        u32 num_keys;
+        u32 write_every;
+        u64 seed;
+
+        static s32 run(void* user_data)
+        {
+            MapLoop& l = *(MapLoop*)user_data;
+            u64 state = l.seed;
+            u64 sum = 0;
+            for (u32 i = 0; i < l.num; ++i)
+            {
+                const u64 key = random_u64(state) % l.num_keys;
+                if (l.write_every != 0 && i % l.write_every == 0)
+                {
+                    l.map->set(key, i);
+                }
+                else
+                {
+                    u64 value = 0;
+                    l.map->get(key, value);
+                    sum += value;
+                }
+            }
+            return s32(sum & 1);
+        }
+    };
+
+    // Runs MapLoop::run() on `num_threads` threads.
+    static void map_loop(ConcurrentHashMap<u64, u64>& map, u32 num_threads, u32 num, u32 num_keys, u32 write_every)
+    {
+        MapLoop l[8];
+        Thread threads[8];
+        for (u32 i = 0; i < num_threads; ++i)
+        {
+            l[i].map = &map;
+            l[i].num = num / num_threads;
+            l[i].num_keys = num_keys;
+            l[i].write_every = write_every;
+            l[i].seed = 0x9e3779b97f4a7c15ull * (i + 1);
+            threads[i].start(MapLoop::run, &l[i]);
+        }
+        for (u32 i = 0; i < num_threads; ++i)
+            threads[i].join();
+    }
+
+    static void bench_concurrent_hash_map()
+    {
+        const u32 NUM = 4*1000*1000;
+        const u32 NUM_KEYS = 4096;
+
+        ConcurrentHashMap<u64, u64> map(default_allocator());
+        for (u32 i = 0; i < NUM_KEYS; ++i)
+            map.set(i, i);
+
+        printf("concurrent hash map %u accesses, %u keys\n", NUM, NUM_KEYS);
+        for (u32 num_threads = 1; num_threads <= 8; num_threads *= 2)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "get, %u threads", num_threads);
+            measure(name, 3, [&]() { map_loop(map, num_threads, NUM, NUM_KEYS, 0); });
+            snprintf(name, sizeof(name), "get, 1/64 set, %u threads", num_threads);
+            measure(name, 3, [&]() { map_loop(map, num_threads, NUM, NUM_KEYS, 64); });
+        }
+    }
+
+    // A few hundred nanoseconds of work.
+    static void lcg_job(void* user_data)
+    {
+        u64& x = *(u64*)user_data;
+        for (u32 i = 0; i < 256; ++i)
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+    }
+
+    struct SpawnJob
+    {
+        JobSystem* js;
+        Job* children;
+        u32 num_children;
+    };
+
+    static void spawn_job(void* user_data)
+    {
+        SpawnJob& s = *(SpawnJob*)user_data;
+        JobCounter counter;
+        s.js->run(s.children, s.num_children, &counter);
+        s.js->wait(counter);
+    }
+
+    static void bench_job_system()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM = 256*1024;
+        const u32 NUM_PARENTS = 64;
+
+        u32 cpus[256];
+        const u32 num_cores = thread::physical_cores(cpus, countof(cpus));
+        printf("job_system %u jobs, %u cores\n", NUM, num_cores);
+
+        Array<u64> values(a);
+        array::resize(values, NUM);
+        Array<Job> jobs(a);
+        array::resize(jobs, NUM);
+        for (u32 i = 0; i < NUM; ++i)
+        {
+            values[i] = i;
+            jobs[i].func = lcg_job;
+            jobs[i].user_data = &values[i];
+        }
+
+        const f64 t_serial = measure("serial", 5, [&]() {
+            for (u32 i = 0; i < NUM; ++i)
+                lcg_job(&values[i]);
+        });
+
+        for (u32 num_workers = 1; num_workers < num_cores * 2; num_workers *= 2)
+        {
+            JobSystem js(a, num_workers);
+            char name[64];
+
+            // All the jobs posted from this thread.
+            snprintf(name, sizeof(name), "flat, %u workers", num_workers);
+            const f64 t_flat = measure(name, 5, [&]() {
+                JobCounter counter;
+                js.run(array::begin(jobs), NUM, &counter);
+                js.wait(counter);
+            });
+
+            // Jobs posting jobs, which go to the deques of the workers.
+            SpawnJob spawns[NUM_PARENTS];
+            Job parents[NUM_PARENTS];
+            for (u32 i = 0; i < NUM_PARENTS; ++i)
+            {
+                spawns[i].js = &js;
+                spawns[i].children = &jobs[i * (NUM / NUM_PARENTS)];
+                spawns[i].num_children = NUM / NUM_PARENTS;
+                parents[i].func = spawn_job;
+                parents[i].user_data = &spawns[i];
+            }
+            snprintf(name, sizeof(name), "nested, %u workers", num_workers);
+            const f64 t_nested = measure(name, 5, [&]() {
+                JobCounter counter;
+                js.run(parents, NUM_PARENTS, &counter);
+                js.wait(counter);
+            });
+
+            printf("    speedup: flat %.1fx, nested %.1fx\n", t_serial / t_flat, t_serial / t_nested);
+        }
+    }
+
+    static void bench_task_graph()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM_LAYERS = 16;
+        const u32 WIDTH = 64;
+        const u32 NUM_TASKS = NUM_LAYERS * WIDTH;
+        const u32 NUM_FRAMES = 100;
+
+        u32 cpus[256];
+        const u32 num_cores = thread::physical_cores(cpus, countof(cpus));
+        printf("task_graph %u frames of %u tasks in %u layers, %u cores\n", NUM_FRAMES, NUM_TASKS, NUM_LAYERS, num_cores);
+
+        // Each task waits for two tasks of the previous layer.
+        Array<u64> values(a);
+        array::resize(values, NUM_TASKS);
+        Array<Job> jobs(a);
+        array::resize(jobs, NUM_TASKS);
+        Array<TaskGraph::Edge> edges(a);
+        u64 state = 1;
+        for (u32 i = 0; i < NUM_TASKS; ++i)
+        {
+            values[i] = i;
+            jobs[i].func = lcg_job;
+            jobs[i].user_data = &values[i];
+
+            if (i < WIDTH)
+                continue;
+            const u32 layer_start = (i / WIDTH - 1) * WIDTH;
+            for (u32 k = 0; k < 2; ++k)
+            {
+                TaskGraph::Edge e;
+                e.from = layer_start + u32(random_u64(state) % WIDTH);
+                e.to = i;
+                array::push_back(edges, e);
+            }
+        }
+
+        const auto add_tasks = [&](TaskGraph& tg) {
+            for (u32 i = 0; i < NUM_TASKS; ++i)
+                tg.add(lcg_job, &values[i]);
+            for (u32 i = 0; i < array::size(edges); ++i)
+                tg.add_edge(edges[i].from, edges[i].to);
+        };
+
+        for (u32 num_workers = 1; num_workers < num_cores * 2; num_workers *= 2)
+        {
+            JobSystem js(a, num_workers);
+            char name[64];
+
+            // Without a graph, the usual way is to wait for each layer.
+            snprintf(name, sizeof(name), "layer by layer, %u workers", num_workers);
+            const f64 t_layers = measure(name, 5, [&]() {
+                for (u32 f = 0; f < NUM_FRAMES; ++f)
+                {
+                    for (u32 l = 0; l < NUM_LAYERS; ++l)
+                    {
+                        JobCounter counter;
+                        js.run(&jobs[l * WIDTH], WIDTH, &counter);
+                        js.wait(counter);
+                    }
+                }
+            });
+
+            snprintf(name, sizeof(name), "graph built every frame, %u workers", num_workers);
+            const f64 t_rebuilt = measure(name, 5, [&]() {
+                for (u32 f = 0; f < NUM_FRAMES; ++f)
+                {
+                    TaskGraph tg(a);
+                    add_tasks(tg);
+                    tg.run(js);
+                }
+            });
+
+            TaskGraph tg(a);
+            add_tasks(tg);
+            tg.build();
+            snprintf(name, sizeof(name), "graph replayed, %u workers", num_workers);
+            const f64 t_replayed = measure(name, 5, [&]() {
+                for (u32 f = 0; f < NUM_FRAMES; ++f)
+                    tg.run(js);
+            });
+
+            printf("    speedup: %.1fx over layers, %.1fx over rebuilding\n", t_layers / t_replayed, t_rebuilt / t_replayed);
+        }
+    }
+
+    static void bench_parallel_algorithms()
+    {
+        Allocator& a = default_allocator();
+        const u32 NUM = 4*1024*1024;
+
+        u32 cpus[256];
+        const u32 num_cores = thread::physical_cores(cpus, countof(cpus));
+        printf("parallel_algorithms %u items, %u cores\n", NUM, num_cores);
+
+        Array<u64> keys(a);
+        array::resize(keys, NUM);
+        u64 state = 1;
+        for (u32 i = 0; i < NUM; ++i)
+            keys[i] = random_u64(state);
+
+        Array<f32> vals(a);
+        array::resize(vals, NUM);
+        for (u32 i = 0; i < NUM; ++i)
+            vals[i] = f32(keys[i] >> 40) / f32(1 << 24);
+
+        Array<u64> sorted(a);
+        Array<f32> scan(a);
+        const auto add = [](f32 x, f32 y) { return x + y; };
+
+        f32 sum = 0.0f;
+        const f64 t_reduce = measure("reduce, serial", 5, [&]() {
+            sum = 0.0f;
+            for (u32 i = 0; i < NUM; ++i)
+                sum += vals[i];
+        });
+        const f64 t_scan = measure("prefix_sum, serial", 5, [&]() {
+            scan = vals;
+            for (u32 i = 1; i < NUM; ++i)
+                scan[i] += scan[i - 1];
+        });
+        const f64 t_radix = measure("radix_sort, serial", 5, [&]() {
+            sorted = keys;
+            array::radix_sort(sorted);
+        });
+        const f64 t_merge = measure("merge_sort, serial", 5, [&]() {
+            sorted = keys;
+            array::merge_sort(sorted);
+        });
+
+        for (u32 num_workers = 1; num_workers < num_cores * 2; num_workers *= 2)
+        {
+            JobSystem js(a, num_workers);
+            char name[64];
+
+            snprintf(name, sizeof(name), "reduce, %u workers", num_workers);
+            const f64 t_preduce = measure(name, 5, [&]() {
+                sum = array::parallel_reduce(js, vals, 0.0f, add);
+            });
+            snprintf(name, sizeof(name), "prefix_sum, %u workers", num_workers);
+            const f64 t_pscan = measure(name, 5, [&]() {
+                scan = vals;
+                array::parallel_prefix_sum(js, scan);
+            });
+            snprintf(name, sizeof(name), "radix_sort, %u workers", num_workers);
+            const f64 t_pradix = measure(name, 5, [&]() {
+                sorted = keys;
+                array::parallel_radix_sort(js, sorted);
+            });
+            snprintf(name, sizeof(name), "merge_sort, %u workers", num_workers);
+            const f64 t_pmerge = measure(name, 5, [&]() {
+                sorted = keys;
+                array::parallel_merge_sort(js, sorted);
+            });
+
+            printf("    speedup: reduce %.1fx, prefix_sum %.1fx, radix_sort %.1fx, merge_sort %.1fx\n"
+                , t_reduce / t_preduce
+                , t_scan / t_pscan
+                , t_radix / t_pradix
+                , t_merge / t_pmerge
+                );
+        }
+        printf("    (sum %f)\n", sum);
+    }
+
+    static void bench_fiber()
+    {
+#if CROWN_FIBERS
+        Allocator& a = default_allocator();
+        const u32 NUM = 10*1000*1000;
+
+        printf("fiber %u round trips\n", NUM);
+
+        struct PingPong
+        {
+            Fiber main;
+            Fiber fiber;
+        };
+        PingPong pp;
+        void* stack = a.allocate(JobSystem::FIBER_STACK_SIZE, 16);
+        fiber::init_thread(pp.main);
+        fiber::create(pp.fiber, stack, JobSystem::FIBER_STACK_SIZE, [](void* user_data) {
+            PingPong& p = *(PingPong*)user_data;
+            for (;;)
+                fiber::switch_to(p.fiber, p.main);
+        }, &pp);
+
+        const f64 t = measure("switch_to and back", 5, [&]() {
+            for (u32 i = 0; i < NUM; ++i)
+                fiber::switch_to(pp.main, pp.fiber);
+        });
+        printf("    %.1f ns per switch\n", t * 1e9 / (NUM * 2.0));
+
+        fiber::destroy(pp.fiber);
+        fiber::shutdown_thread(pp.main);
+        a.deallocate(stack);
+
+        // Jobs waiting for jobs, on fibers or by helping.
+        const u32 NUM_JOBS = 256*1024;
+        const u32 NUM_PARENTS = 64;
+        Array<u64> values(a);
+        array::resize(values, NUM_JOBS);
+        Array<Job> jobs(a);
+        array::resize(jobs, NUM_JOBS);
+        for (u32 i = 0; i < NUM_JOBS; ++i)
+        {
+            values[i] = i;
+            jobs[i].func = lcg_job;
+            jobs[i].user_data = &values[i];
+        }
+
+        u32 cpus[256];
+        const u32 num_workers = max(1u, thread::physical_cores(cpus, countof(cpus)) - 1);
+        for (u32 num_fibers = 0; num_fibers <= 128; num_fibers += 128)
+        {
+            JobSystem js(a, num_workers, num_fibers);
+            SpawnJob spawns[NUM_PARENTS];
+            Job parents[NUM_PARENTS];
+            for (u32 i = 0; i < NUM_PARENTS; ++i)
+            {
+                spawns[i].js = &js;
+                spawns[i].children = &jobs[i * (NUM_JOBS / NUM_PARENTS)];
+                spawns[i].num_children = NUM_JOBS / NUM_PARENTS;
+                parents[i].func = spawn_job;
+                parents[i].user_data = &spawns[i];
+            }
+
+            char name[64];
+            snprintf(name, sizeof(name), "nested, %u workers, %u fibers", num_workers, num_fibers);
+            measure(name, 5, [&]() {
+                JobCounter counter;
+                js.run(parents, NUM_PARENTS, &counter);
+                js.wait(counter);
+            });
+        }
+#endif // CROWN_FIBERS
+    }
+
+#define RUN_BENCH(name)     \
+    do {                    \
+        name();             \
+    } while (0)
+
+    int main_benchmarks()
+    {
+        memory_globals::init();
+        RUN_BENCH(bench_sort);
+        RUN_BENCH(bench_search);
+        RUN_BENCH(bench_bit_array);
+        RUN_BENCH(bench_hash);
+        RUN_BENCH(bench_string_stream);
+        RUN_BENCH(bench_number_parse);
+        RUN_BENCH(bench_string_scan);
+        RUN_BENCH(bench_wildcard_set);
+        RUN_BENCH(bench_string_table);
+        RUN_BENCH(bench_utf8);
+        RUN_BENCH(bench_guid);
+        RUN_BENCH(bench_mutex);
+        RUN_BENCH(bench_concurrent_hash_map);
+        RUN_BENCH(bench_job_system);
+        RUN_BENCH(bench_task_graph);
+        RUN_BENCH(bench_parallel_algorithms);
+        RUN_BENCH(bench_fiber);
+        memory_globals::shutdown();
+        return EXIT_SUCCESS;
+    }
+
+} // namespace crown
+
+int main()
+{
+    return crown::main_benchmarks();
+}
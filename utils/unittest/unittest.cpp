@@ -8,18 +8,52 @@
 
 #include "config.h"
 #include "core/containers/array.inl"
+#include "core/containers/array_algorithms.inl"
+#include "core/containers/bit_array.inl"
+#include "core/containers/bucket_array.inl"
 #include "core/containers/pair.inl"
+#include "core/containers/parallel_algorithms.inl"
+#include "core/guid.inl"
 #include "core/memory/memory.inl"
 #include "core/memory/temp_allocator.inl"
 #include "core/murmur.h"
+#include "core/strings/dynamic_string.inl"
+#include "core/strings/number_format.h"
+#include "core/strings/number_parse.h"
 #include "core/strings/string.inl"
 #include "core/strings/string_id.inl"
+#include "core/strings/string_id_table.h"
+#include "core/strings/string_scan.h"
 #include "core/strings/string_stream.inl"
+#include "core/strings/string_table.h"
 #include "core/strings/string_view.inl"
-
-#include <stdlib.h> // EXIT_SUCCESS, EXIT_FAILURE
+#include "core/strings/utf8.h"
+#include "core/strings/wildcard_set.h"
+#include "core/thread/concurrent_hash_map.inl"
+#include "core/thread/condition_variable.h"
+#include "core/thread/fiber.h"
+#include "core/thread/job_system.h"
+#include "core/thread/lock_stats.h"
+#include "core/thread/mpmc_queue.inl"
+#include "core/thread/mutex.h"
+#include "core/thread/read_write_lock.h"
+#include "core/thread/scoped_mutex.inl"
+#include "core/thread/scoped_read_write_lock.inl"
+#include "core/thread/semaphore.h"
+#include "core/thread/spin_lock.inl"
+#include "core/thread/spsc_queue.inl"
+#include "core/thread/task_graph.h"
+#include "core/thread/thread.h"
+#include "core/thread/work_stealing_deque.inl"
+#include "core/xxh3.h"
+
+#include <math.h>   // INFINITY, signbit
+#include <stdlib.h> // EXIT_SUCCESS, EXIT_FAILURE, strtod, strtof
 #include <stdio.h>
 #include <string.h>
+#if CROWN_PLATFORM_LINUX
+#  include <pthread.h> // pthread_getattr_np
+#endif
 
 #undef CE_ASSERT
 #undef CE_ENSURE
@@ -50,6 +84,44 @@ namespace crown
         a.deallocate(p);
     }
 
+    static void test_scratch_allocator()
+    {
+        Allocator& a = default_scratch_allocator();
+
+        void* p = a.allocate(32);
+        ENSURE(a.allocated_size(p) >= 32);
+        a.deallocate(p);
+
+        // Frees in any order, then a block too big for the end of the ring
+        // buffer (1 MB): it must not wrap over the block still in use.
+        const u32 KB = 1024;
+        u8* x = (u8*)a.allocate(300*KB);
+        u8* y = (u8*)a.allocate(300*KB);
+        u8* z = (u8*)a.allocate(300*KB);
+        a.deallocate(x);
+        a.deallocate(y);
+        memset(z, 0xaa, 300*KB);
+        u8* w = (u8*)a.allocate(950*KB);
+        memset(w, 0x55, 950*KB);
+        bool ok = true;
+        for (u32 i = 0; i < 300*KB; ++i)
+            ok = ok && z[i] == 0xaa;
+        a.deallocate(z);
+        a.deallocate(w);
+        ENSURE(ok);
+
+        // Fill the ring exactly up to its end, then free everything.
+        void* blocks[1024];
+        for (u32 i = 0; i < countof(blocks); ++i)
+            blocks[i] = a.allocate(KB - 4, 4);
+        for (u32 i = 0; i < countof(blocks); ++i)
+            a.deallocate(blocks[i]);
+
+        p = a.allocate(32);
+        ENSURE(a.allocated_size(p) >= 32);
+        a.deallocate(p);
+    }
+
     // TODO(kasicass): unittest for temp_allocator
 
     static void test_new_delete()
@@ -312,6 +384,356 @@ namespace crown
         }
     }
 
+    static void test_array_algorithms()
+    {
+        Allocator& a = default_allocator();
+
+        struct Greater
+        {
+            bool operator()(const u32& x, const u32& y) const { return (x & 0xff) > (y & 0xff); }
+        };
+
+        // radix_sort() u32 / u64
+        {
+            Array<u32> v32(a);
+            Array<u64> v64(a);
+            u32 seed = 1;
+            for (u32 i = 0; i < 5000; ++i)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                array::push_back(v32, seed);
+                array::push_back(v64, (u64(seed) << 32) | (seed >> 7));
+            }
+
+            array::radix_sort(v32);
+            array::radix_sort(v64);
+            for (u32 i = 1; i < 5000; ++i)
+            {
+                ENSURE(v32[i - 1] <= v32[i]);
+                ENSURE(v64[i - 1] <= v64[i]);
+            }
+        }
+
+        // radix_sort() keys/values
+        {
+            Array<u32> keys(a);
+            Array<u16> values(a);
+            u32 k[] = { 30, 10, 20, 10, 0x10000, 5 };
+            u16 v[] = {  0,  1,  2,  3,       4, 5 };
+            array::push(keys, k, countof(k));
+            array::push(values, v, countof(v));
+
+            array::radix_sort(keys, values);
+            ENSURE(keys[0] == 5 && values[0] == 5);
+            ENSURE(keys[1] == 10 && values[1] == 1);
+            ENSURE(keys[2] == 10 && values[2] == 3);
+            ENSURE(keys[3] == 20 && values[3] == 2);
+            ENSURE(keys[4] == 30 && values[4] == 0);
+            ENSURE(keys[5] == 0x10000 && values[5] == 4);
+        }
+
+        // radix_sort() StringId64
+        {
+            Array<StringId64> ids(a);
+            array::push_back(ids, StringId64("c"));
+            array::push_back(ids, StringId64("a"));
+            array::push_back(ids, StringId64("b"));
+            array::radix_sort(ids);
+            ENSURE(ids[0] < ids[1]);
+            ENSURE(ids[1] < ids[2]);
+        }
+
+        // merge_sort()
+        {
+            Array<u32> v(a);
+            for (u32 i = 0; i < 1000; ++i)
+                array::push_back(v, ((i * 7919u) % 256) | (i << 8));
+
+            array::merge_sort(v, Greater());
+            for (u32 i = 1; i < 1000; ++i)
+            {
+                ENSURE((v[i - 1] & 0xff) >= (v[i] & 0xff));
+                if ((v[i - 1] & 0xff) == (v[i] & 0xff))
+                    ENSURE(v[i - 1] < v[i]); // stable
+            }
+
+            array::merge_sort(v);
+            for (u32 i = 1; i < 1000; ++i)
+                ENSURE(v[i - 1] < v[i]);
+        }
+
+        // find() / count()
+        {
+            Array<u32> v32(a);
+            Array<s64> v64(a);
+            Array<f32> vf(a);
+            Array<u16> v16(a);
+            for (u32 i = 0; i < 100; ++i)
+            {
+                array::push_back(v32, i % 10);
+                array::push_back(v64, s64(i % 10) - 5);
+                array::push_back(vf, f32(i % 10));
+                array::push_back(v16, u16(i % 10));
+            }
+
+            ENSURE(array::find(v32, 7u) == 7);
+            ENSURE(array::find(v32, 10u) == 100);
+            ENSURE(array::find(v64, s64(2)) == 7);
+            ENSURE(array::find(v64, s64(5)) == 100);
+            ENSURE(array::find(vf, 7.0f) == 7);
+            ENSURE(array::find(v16, u16(7)) == 7);
+
+            ENSURE(array::count(v32, 3u) == 10);
+            ENSURE(array::count(v32, 10u) == 0);
+            ENSURE(array::count(v64, s64(-5)) == 10);
+            ENSURE(array::count(vf, 3.0f) == 10);
+            ENSURE(array::count(v16, u16(3)) == 10);
+        }
+
+        // min_max()
+        {
+            Array<u32> vu(a);
+            Array<s32> vs(a);
+            Array<f32> vf(a);
+            for (u32 i = 0; i < 37; ++i)
+            {
+                array::push_back(vu, 0x7ffffff0u + i);
+                array::push_back(vs, s32(i) - 20);
+                array::push_back(vf, f32(i) * 0.5f - 3.0f);
+            }
+
+            u32 umin, umax;
+            array::min_max(vu, umin, umax);
+            ENSURE(umin == 0x7ffffff0u && umax == 0x7ffffff0u + 36);
+
+            s32 smin, smax;
+            array::min_max(vs, smin, smax);
+            ENSURE(smin == -20 && smax == 16);
+
+            f32 fmin, fmax;
+            array::min_max(vf, fmin, fmax);
+            ENSURE(fmin == -3.0f && fmax == 15.0f);
+        }
+    }
+
+    static void test_bit_array()
+    {
+        Allocator& a = default_allocator();
+
+        // set() / clear() / test() / assign()
+        {
+            BitArray ba(a);
+            ENSURE(bit_array::empty(ba) == true);
+
+            bit_array::resize(ba, 130);
+            ENSURE(bit_array::size(ba) == 130);
+            ENSURE(bit_array::count(ba) == 0);
+            ENSURE(bit_array::any(ba) == false);
+
+            bit_array::set(ba, 0);
+            bit_array::set(ba, 64);
+            bit_array::set(ba, 129);
+            ENSURE(bit_array::test(ba, 0) == true);
+            ENSURE(bit_array::test(ba, 1) == false);
+            ENSURE(bit_array::test(ba, 64) == true);
+            ENSURE(bit_array::test(ba, 129) == true);
+            ENSURE(bit_array::count(ba) == 3);
+
+            bit_array::clear(ba, 64);
+            ENSURE(bit_array::test(ba, 64) == false);
+            bit_array::assign(ba, 5, true);
+            ENSURE(bit_array::test(ba, 5) == true);
+            bit_array::assign(ba, 5, false);
+            ENSURE(bit_array::test(ba, 5) == false);
+            ENSURE(bit_array::count(ba) == 2);
+        }
+
+        // resize() / set_all() / clear_all()
+        {
+            BitArray ba(a);
+            bit_array::resize(ba, 70);
+            bit_array::set_all(ba);
+            ENSURE(bit_array::count(ba) == 70);
+
+            // Shrinking drops bits, growing again brings in cleared bits.
+            bit_array::resize(ba, 10);
+            ENSURE(bit_array::count(ba) == 10);
+            bit_array::resize(ba, 300);
+            ENSURE(bit_array::count(ba) == 10);
+            ENSURE(bit_array::test(ba, 69) == false);
+
+            BitArray copy(ba);
+            ENSURE(bit_array::count(copy) == 10);
+
+            bit_array::clear_all(ba);
+            ENSURE(bit_array::count(ba) == 0);
+        }
+
+        // bit_and() / bit_or() / bit_xor() / bit_andnot()
+        {
+            BitArray x(a);
+            BitArray y(a);
+            bit_array::resize(x, 1000);
+            bit_array::resize(y, 1000);
+            for (u32 i = 0; i < 1000; ++i)
+            {
+                bit_array::assign(x, i, i % 2 == 0);
+                bit_array::assign(y, i, i % 3 == 0);
+            }
+
+            BitArray r(x);
+            bit_array::bit_and(r, y);
+            ENSURE(bit_array::count(r) == 167); // multiples of 6
+            r = x;
+            bit_array::bit_or(r, y);
+            ENSURE(bit_array::count(r) == 500 + 334 - 167);
+            r = x;
+            bit_array::bit_xor(r, y);
+            ENSURE(bit_array::count(r) == 500 + 334 - 2 * 167);
+            r = x;
+            bit_array::bit_andnot(r, y);
+            ENSURE(bit_array::count(r) == 500 - 167);
+            ENSURE(bit_array::test(r, 2) == true);
+            ENSURE(bit_array::test(r, 6) == false);
+        }
+
+        // find_first_set() / find_first_clear() / for_each_set()
+        {
+            BitArray ba(a);
+            bit_array::resize(ba, 1000);
+            ENSURE(bit_array::find_first_set(ba) == 1000);
+            ENSURE(bit_array::find_first_clear(ba) == 0);
+
+            bit_array::set(ba, 3);
+            bit_array::set(ba, 700);
+            bit_array::set(ba, 999);
+            ENSURE(bit_array::find_first_set(ba) == 3);
+            ENSURE(bit_array::find_first_set(ba, 4) == 700);
+            ENSURE(bit_array::find_first_set(ba, 701) == 999);
+            ENSURE(bit_array::find_first_set(ba, 1000) == 1000);
+
+            bit_array::set_all(ba);
+            bit_array::clear(ba, 900);
+            ENSURE(bit_array::find_first_clear(ba) == 900);
+            ENSURE(bit_array::find_first_clear(ba, 901) == 1000);
+
+            struct Collect
+            {
+                u32* _sum;
+                u32* _num;
+                void operator()(u32 i) { *_sum += i; ++*_num; }
+            };
+
+            bit_array::clear_all(ba);
+            bit_array::set(ba, 1);
+            bit_array::set(ba, 64);
+            bit_array::set(ba, 998);
+            u32 sum = 0;
+            u32 num = 0;
+            Collect fn = { &sum, &num };
+            bit_array::for_each_set(ba, fn);
+            ENSURE(num == 3);
+            ENSURE(sum == 1 + 64 + 998);
+        }
+    }
+
+    static void test_bucket_array()
+    {
+        Allocator& a = default_allocator();
+
+        // add() / remove() / has()
+        {
+            BucketArray<int, 4> ba(a);
+            ENSURE(bucket_array::empty(ba) == true);
+            ENSURE(bucket_array::size(ba) == 0);
+            ENSURE(bucket_array::capacity(ba) == 0);
+
+            u32 i0 = bucket_array::add(ba, 10);
+            u32 i1 = bucket_array::add(ba, 11);
+            ENSURE(i0 == 0);
+            ENSURE(i1 == 1);
+            ENSURE(bucket_array::size(ba) == 2);
+            ENSURE(bucket_array::capacity(ba) == 4);
+            ENSURE(ba[i0] == 10);
+            ENSURE(ba[i1] == 11);
+
+            bucket_array::remove(ba, i0);
+            ENSURE(bucket_array::has(ba, i0) == false);
+            ENSURE(bucket_array::has(ba, i1) == true);
+            ENSURE(bucket_array::has(ba, 100) == false);
+            ENSURE(bucket_array::size(ba) == 1);
+
+            // Free slots are reused.
+            u32 i2 = bucket_array::add(ba, 12);
+            ENSURE(i2 == i0);
+            ENSURE(ba[i2] == 12);
+        }
+
+        // Pointers stay valid when growing.
+        {
+            BucketArray<int, 4> ba(a);
+            u32 i0 = bucket_array::add(ba, 42);
+            int* p = &ba[i0];
+
+            for (int i = 0; i < 100; ++i)
+                bucket_array::add(ba, i);
+
+            ENSURE(p == &ba[i0]);
+            ENSURE(*p == 42);
+            ENSURE(bucket_array::size(ba) == 101);
+            ENSURE(bucket_array::capacity(ba) == 104);
+        }
+
+        // reserve() / clear() / shrink_to_fit()
+        {
+            BucketArray<int, 4> ba(a);
+            bucket_array::reserve(ba, 9);
+            ENSURE(bucket_array::capacity(ba) == 12);
+            ENSURE(bucket_array::size(ba) == 0);
+
+            for (int i = 0; i < 6; ++i)
+                bucket_array::add(ba, i);
+
+            bucket_array::clear(ba);
+            ENSURE(bucket_array::size(ba) == 0);
+            ENSURE(bucket_array::capacity(ba) == 12);
+            ENSURE(bucket_array::add(ba, 1) == 0);
+
+            bucket_array::shrink_to_fit(ba);
+            ENSURE(bucket_array::capacity(ba) == 4);
+            ENSURE(bucket_array::add(ba, 2) == 1);
+        }
+
+        // begin() / next() / end() / for_each()
+        {
+            BucketArray<int, 64> ba(a);
+            for (int i = 0; i < 200; ++i)
+                bucket_array::add(ba, i);
+            for (u32 i = 0; i < 200; i += 2)
+                bucket_array::remove(ba, i);
+
+            u32 num = 0;
+            for (u32 i = bucket_array::begin(ba); i != bucket_array::end(ba); i = bucket_array::next(ba, i))
+            {
+                ENSURE(ba[i] == int(i));
+                ENSURE(i % 2 == 1);
+                ++num;
+            }
+            ENSURE(num == 100);
+
+            struct Sum
+            {
+                int* _sum;
+                void operator()(u32 /*index*/, int& item) { *_sum += item; }
+            };
+
+            int sum = 0;
+            Sum fn = { &sum };
+            bucket_array::for_each(ba, fn);
+            ENSURE(sum == 100 * 100);
+        }
+    }
+
     static void test_containers_pair()
     {
         Allocator& a = default_allocator();
@@ -441,6 +863,227 @@ namespace crown
         }
     }
 
+    static void test_dynamic_string()
+    {
+        Allocator& a = default_allocator();
+        {
+            DynamicString str(a);
+            ENSURE(str.empty());
+            ENSURE(str.length() == 0);
+            ENSURE(strcmp(str.c_str(), "") == 0);
+
+            // Short strings stay inline.
+            str = "hello";
+            ENSURE(str._heap == NULL);
+            ENSURE(str.length() == 5);
+            ENSURE(str == "hello");
+
+            str += ' ';
+            str += "crown";
+            ENSURE(str == "hello crown");
+            ENSURE(str.has_prefix("hello"));
+            ENSURE(str.has_suffix("crown"));
+            ENSURE(!str.has_suffix("hello"));
+            ENSURE(str.substring(6, 5) == "crown");
+            ENSURE(str.substring(6, 100) == "crown");
+            ENSURE(str.substring(100, 5).length() == 0);
+
+            // Long strings go to the heap.
+            str += ", a rather long string";
+            ENSURE(str._heap != NULL);
+            ENSURE(str == "hello crown, a rather long string");
+
+            // Appending to itself.
+            DynamicString self(a, "abc");
+            for (u32 i = 0; i < 5; ++i)
+                self += self.view();
+            ENSURE(self.length() == 3 * 32);
+            ENSURE(self.has_prefix("abcabc"));
+
+            str.clear();
+            ENSURE(str.empty());
+            ENSURE(strcmp(str.c_str(), "") == 0);
+        }
+        {
+            DynamicString str(a);
+            str.format("%d %s", 42, "apples");
+            ENSURE(str == "42 apples");
+            str.append_format(" and %d %s", 7, "very long oranges indeed");
+            ENSURE(str == "42 apples and 7 very long oranges indeed");
+
+            DynamicString copy(str);
+            ENSURE(copy == str);
+            copy = "x";
+            ENSURE(copy != str);
+            ENSURE(str < copy);
+        }
+        {
+            // Arguments pointing into the string itself.
+            DynamicString str(a, "abc");
+            str.append_format("-%s", str.c_str());
+            ENSURE(str == "abc-abc");
+            str.format("%s%s", str.c_str(), "0123456789012345678901234567890123456789");
+            ENSURE(str == "abc-abc0123456789012345678901234567890123456789");
+
+            char big[300];
+            memset(big, 'x', sizeof(big) - 1);
+            big[sizeof(big) - 1] = '\0';
+            str.append_format("%s%s", str.c_str(), big);
+            ENSURE(str.length() == 2*47 + 299);
+            ENSURE(str.has_prefix("abc-abc0123456789012345678901234567890123456789abc-abc"));
+        }
+        {
+            // Heap storage from the scratch allocator.
+            DynamicString str(default_scratch_allocator(), "a string too long to fit inline");
+            str += " and a bit more";
+            ENSURE(str == "a string too long to fit inline and a bit more");
+        }
+        {
+            DynamicString str(a, "textures/grass");
+            const StringId64 id = str.to_string_id64();
+            ENSURE(id == StringId64("textures/grass"));
+            ENSURE(str._flags & DynamicString::HAS_ID64);
+            ENSURE(str.to_string_id64() == id);
+            ENSURE(str.to_string_id32() == StringId32("textures/grass"));
+
+            // Mutations invalidate the cached ids.
+            str += ".png";
+            ENSURE(str._flags == 0);
+            ENSURE(str.to_string_id64() == StringId64("textures/grass.png"));
+        }
+    }
+
+    static void test_fiber()
+    {
+#if CROWN_FIBERS
+        Allocator& a = default_allocator();
+        struct Data
+        {
+            Fiber* caller;
+            Fiber fibers[2];
+            u32 log[8];
+            u32 num_log;
+        };
+        Data* data = CE_NEW(a, Data)();
+        data->num_log = 0;
+
+        void* stacks[2];
+        for (u32 i = 0; i < 2; ++i)
+            stacks[i] = a.allocate(64*1024, 16);
+
+        // Fibers switching to each other, then back to the thread.
+        fiber::create(data->fibers[0], stacks[0], 64*1024, [](void* user_data) {
+            Data& d = *(Data*)user_data;
+            d.log[d.num_log++] = 1;
+            fiber::switch_to(d.fibers[0], d.fibers[1]);
+            d.log[d.num_log++] = 3;
+            fiber::switch_to(d.fibers[0], *d.caller);
+            for (;;)
+            {
+                // Resumed on whichever thread, each time.
+                d.log[d.num_log++] = 4;
+                fiber::switch_to(d.fibers[0], *d.caller);
+            }
+        }, data);
+        fiber::create(data->fibers[1], stacks[1], 64*1024, [](void* user_data) {
+            Data& d = *(Data*)user_data;
+            d.log[d.num_log++] = 2;
+            fiber::switch_to(d.fibers[1], d.fibers[0]);
+            CE_UNREACHABLE();
+        }, data);
+
+        Fiber main_fiber;
+        fiber::init_thread(main_fiber);
+        data->caller = &main_fiber;
+        fiber::switch_to(main_fiber, data->fibers[0]);
+        ENSURE(data->num_log == 3);
+        ENSURE(data->log[0] == 1 && data->log[1] == 2 && data->log[2] == 3);
+
+        Thread t;
+        t.start([](void* user_data) {
+            Data& d = *(Data*)user_data;
+            Fiber thread_fiber;
+            fiber::init_thread(thread_fiber);
+            d.caller = &thread_fiber;
+            fiber::switch_to(thread_fiber, d.fibers[0]);
+            fiber::shutdown_thread(thread_fiber);
+            return 0;
+        }, data);
+        t.join();
+        ENSURE(data->num_log == 4 && data->log[3] == 4);
+
+        data->caller = &main_fiber;
+        fiber::switch_to(main_fiber, data->fibers[0]);
+        ENSURE(data->num_log == 5 && data->log[4] == 4);
+        fiber::shutdown_thread(main_fiber);
+
+        for (u32 i = 0; i < 2; ++i)
+        {
+            fiber::destroy(data->fibers[i]);
+            a.deallocate(stacks[i]);
+        }
+        CE_DELETE(a, data);
+#endif // CROWN_FIBERS
+    }
+
+    static void test_guid()
+    {
+        {
+            const Guid a = guid::new_guid();
+            const Guid b = guid::new_guid();
+            ENSURE(a != b);
+            ENSURE(a != GUID_ZERO);
+            ENSURE(((a.hi >> 12) & 0xf) == 4);
+            ENSURE((a.lo >> 62) == 2);
+        }
+        {
+            char buf[GUID_BUF_LEN];
+            const Guid g = guid::parse("0123ABCD-4567-89ab-CDEF-0123456789ab");
+            ENSURE(g.hi == 0x0123abcd456789abull);
+            ENSURE(g.lo == 0xcdef0123456789abull);
+            ENSURE(strcmp(guid::to_string(buf, sizeof(buf), g), "0123abcd-4567-89ab-cdef-0123456789ab") == 0);
+            ENSURE(strcmp(guid::to_string(buf, 9, g), "0123abcd") == 0);
+
+            const Guid n = guid::new_guid();
+            ENSURE(guid::parse(guid::to_string(buf, sizeof(buf), n)) == n);
+        }
+        {
+            Guid g;
+            ENSURE(guid::try_parse(g, "00000000-0000-0000-0000-000000000000") && g == GUID_ZERO);
+            ENSURE(!guid::try_parse(g, ""));
+            ENSURE(!guid::try_parse(g, "0123abcd-4567-89ab-cdef-0123456789a"));
+            ENSURE(!guid::try_parse(g, "0123abcd-4567-89ab-cdef-0123456789abc"));
+            ENSURE(!guid::try_parse(g, "0123abcd_4567-89ab-cdef-0123456789ab"));
+            ENSURE(!guid::try_parse(g, "0123abcd-4567-89ab-cdef-0123456789ag"));
+            ENSURE(!guid::try_parse(g, "0123abcd-+567-89ab-cdef-0123456789ab"));
+        }
+        {
+            // Guids sort like their strings, with operator< and radix_sort().
+            Allocator& a = default_allocator();
+            Array<Guid> guids(a);
+            for (u32 i = 0; i < 1000; ++i)
+            {
+                array::push_back(guids, guid::new_guid());
+            }
+            for (u32 i = 0; i < 1000; i += 10)
+                guids[i].hi = guids[0].hi; // Equal high halves.
+
+            Array<Guid> sorted(guids);
+            array::radix_sort(sorted);
+            char x[GUID_BUF_LEN];
+            char y[GUID_BUF_LEN];
+            for (u32 i = 1; i < array::size(sorted); ++i)
+            {
+                ENSURE(!(sorted[i] < sorted[i - 1]));
+                guid::to_string(x, sizeof(x), sorted[i - 1]);
+                guid::to_string(y, sizeof(y), sorted[i]);
+                ENSURE(strcmp(x, y) < 0);
+            }
+
+            ENSURE(hash<Guid>()(guids[0]) != hash<Guid>()(guids[1]));
+        }
+    }
+
     static void test_murmur_hash()
     {
         // murmur32()
@@ -468,6 +1111,441 @@ namespace crown
             hash = murmur64("abcdefghijk", 11, seed);
             ENSURE(hash == 0x121f16453e7e7f16ULL);
         }
+
+        // murmur64_init(), murmur64_update(), murmur64_final()
+        {
+            const char* str = "The quick brown fox jumps over the lazy dog, twice.";
+            const u32 len = strlen32(str);
+            const u64 expected = murmur64(str, len, 0x0BADBEEF);
+
+            for (u32 chunk = 1; chunk <= len; ++chunk)
+            {
+                Murmur64State st;
+                murmur64_init(st, len, 0x0BADBEEF);
+                for (u32 i = 0; i < len; i += chunk)
+                    murmur64_update(st, str + i, min(chunk, len - i));
+                ENSURE(murmur64_final(st) == expected);
+            }
+
+            Murmur64State st;
+            murmur64_init(st, 0, 0);
+            ENSURE(murmur64_final(st) == murmur64("", 0, 0));
+        }
+
+        // murmur64_batch()
+        {
+            const char* keys[] =
+            {
+                "", "a", "textures/grass.png", "meshes/tree.mesh",
+                "units/player/player.unit", "sounds/step", "abcdefgh", "abcdefghijk",
+                "levels/main_menu.level"
+            };
+            u32 lens[countof(keys)];
+            u64 hashes[countof(keys)];
+            for (u32 i = 0; i < countof(keys); ++i)
+                lens[i] = strlen32(keys[i]);
+
+            murmur64_batch((const void* const*)keys, lens, countof(keys), 0x0BADBEEF, hashes);
+            for (u32 i = 0; i < countof(keys); ++i)
+                ENSURE(hashes[i] == murmur64(keys[i], lens[i], 0x0BADBEEF));
+        }
+
+        // murmur32_constexpr(), murmur64_constexpr()
+        {
+            CE_STATIC_ASSERT(murmur32_constexpr("abcdefghijk", 11, 0) == 0x4a7439a6U);
+            CE_STATIC_ASSERT(murmur64_constexpr("abcdefghijk", 11, 0x0BADBEEF) == 0x121f16453e7e7f16ULL);
+
+            const char* str = "\xff\x80 constexpr murmur must match murmur32 and murmur64";
+            for (u32 len = 0; len < strlen32(str); ++len)
+            {
+                ENSURE(murmur32_constexpr(str, len, 0x0BADBEEF) == murmur32(str, len, 0x0BADBEEF));
+                ENSURE(murmur64_constexpr(str, len, 0x0BADBEEF) == murmur64(str, len, 0x0BADBEEF));
+            }
+        }
+    }
+
+    // Terminates the `len` characters written to `buf` by a format_*().
+    static const char* terminated(char* buf, u32 len)
+    {
+        buf[len] = '\0';
+        return buf;
+    }
+
+    static void test_number_format()
+    {
+        char buf[NUMBER_BUF_LEN + 1];
+
+        // Integers
+        {
+            ENSURE(strcmp(terminated(buf, format_u32(buf, 0)), "0") == 0);
+            ENSURE(strcmp(terminated(buf, format_u32(buf, 9)), "9") == 0);
+            ENSURE(strcmp(terminated(buf, format_u32(buf, 10)), "10") == 0);
+            ENSURE(strcmp(terminated(buf, format_u32(buf, 4294967295u)), "4294967295") == 0);
+            ENSURE(strcmp(terminated(buf, format_s32(buf, -1)), "-1") == 0);
+            ENSURE(strcmp(terminated(buf, format_s32(buf, INT32_MIN)), "-2147483648") == 0);
+            ENSURE(strcmp(terminated(buf, format_u64(buf, UINT64_MAX)), "18446744073709551615") == 0);
+            ENSURE(strcmp(terminated(buf, format_s64(buf, INT64_MIN)), "-9223372036854775808") == 0);
+            ENSURE(strcmp(terminated(buf, format_s64(buf, INT64_MAX)), "9223372036854775807") == 0);
+
+            u64 val = 1;
+            for (u32 i = 0; i < 20; ++i, val *= 10)
+            {
+                char ref[NUMBER_BUF_LEN];
+                snprintf(ref, sizeof(ref), "%llu", (unsigned long long)(val - 1));
+                ENSURE(strcmp(terminated(buf, format_u64(buf, val - 1)), ref) == 0);
+                snprintf(ref, sizeof(ref), "%llu", (unsigned long long)val);
+                ENSURE(strcmp(terminated(buf, format_u64(buf, val)), ref) == 0);
+            }
+        }
+
+        // Hex
+        {
+            ENSURE(strcmp(terminated(buf, format_hex(buf, 0, 0)), "0") == 0);
+            ENSURE(strcmp(terminated(buf, format_hex(buf, 0xbadbeef, 0)), "badbeef") == 0);
+            ENSURE(strcmp(terminated(buf, format_hex(buf, 0xbadbeef, 16)), "000000000badbeef") == 0);
+            ENSURE(strcmp(terminated(buf, format_hex(buf, UINT64_MAX, 4)), "ffffffffffffffff") == 0);
+        }
+
+        // Fixed
+        {
+            ENSURE(strcmp(terminated(buf, format_fixed(buf, 3.14159, 2)), "3.14") == 0);
+            ENSURE(strcmp(terminated(buf, format_fixed(buf, -2.5, 0)), "-3") == 0);
+            ENSURE(strcmp(terminated(buf, format_fixed(buf, 0.0625, 3)), "0.063") == 0);
+            ENSURE(strcmp(terminated(buf, format_fixed(buf, 100.0, 3)), "100.000") == 0);
+            ENSURE(strcmp(terminated(buf, format_fixed(buf, -0.001, 2)), "0.00") == 0);
+            ENSURE(strcmp(terminated(buf, format_fixed(buf, 1e300, 2)), "1e300") == 0);
+        }
+
+        // Floats, special values
+        {
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 0.0)), "0") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, -0.0)), "-0") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 1.0/0.0)), "inf") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, -1.0/0.0)), "-inf") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 0.0/0.0)), "nan") == 0);
+            ENSURE(strcmp(terminated(buf, format_f32(buf, 1.0f/0.0f)), "inf") == 0);
+        }
+
+        // Floats, shortest representation
+        {
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 0.1)), "0.1") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 1.5)), "1.5") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, -6.466)), "-6.466") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 100.0)), "100") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 0.001234)), "0.001234") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 1.5e-7)), "1.5e-7") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 1e30)), "1e30") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 1.234e33)), "1.234e33") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 1.7976931348623157e308)), "1.7976931348623157e308") == 0);
+            ENSURE(strcmp(terminated(buf, format_f64(buf, 5e-324)), "5e-324") == 0);
+            ENSURE(strcmp(terminated(buf, format_f32(buf, 1.2f)), "1.2") == 0);
+            ENSURE(strcmp(terminated(buf, format_f32(buf, 0.3f)), "0.3") == 0);
+            ENSURE(strcmp(terminated(buf, format_f32(buf, 3.4028235e38f)), "3.4028235e38") == 0);
+            ENSURE(strcmp(terminated(buf, format_f32(buf, 1e-45f)), "1e-45") == 0);
+        }
+
+        // Floats, round trip
+        {
+            u64 state = 0x0BADBEEF;
+            for (u32 i = 0; i < 100000; ++i)
+            {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                const u64 bits64 = state ^ (state >> 29);
+
+                f64 d;
+                memcpy(&d, &bits64, sizeof(d));
+                if (d == d)
+                    ENSURE(strtod(terminated(buf, format_f64(buf, d)), NULL) == d);
+
+                const u32 bits32 = u32(bits64 >> 32);
+                f32 f;
+                memcpy(&f, &bits32, sizeof(f));
+                if (f == f)
+                    ENSURE(strtof(terminated(buf, format_f32(buf, f)), NULL) == f);
+            }
+        }
+    }
+
+    static void test_number_parse()
+    {
+        // Integers
+        {
+            u32 u = 0;
+            s32 s = 0;
+            u64 u64v = 0;
+            s64 s64v = 0;
+
+            ParseResult pr = parse_u32("4294967295 ", u);
+            ENSURE(pr.consumed == 10 && !pr.overflow && u == 4294967295u);
+            pr = parse_u32("4294967296", u);
+            ENSURE(pr.consumed == 10 && pr.overflow && u == UINT32_MAX);
+            pr = parse_u32("-1", u);
+            ENSURE(pr.consumed == 0);
+            pr = parse_u32("+17x", u);
+            ENSURE(pr.consumed == 3 && u == 17);
+            pr = parse_u32("", u);
+            ENSURE(pr.consumed == 0);
+
+            pr = parse_s32("-2147483648", s);
+            ENSURE(pr.consumed == 11 && !pr.overflow && s == INT32_MIN);
+            pr = parse_s32("-2147483649", s);
+            ENSURE(pr.overflow && s == INT32_MIN);
+            pr = parse_s32("2147483648", s);
+            ENSURE(pr.overflow && s == INT32_MAX);
+            pr = parse_s32("-", s);
+            ENSURE(pr.consumed == 0);
+            pr = parse_s32(StringView("123456", 3), s);
+            ENSURE(pr.consumed == 3 && s == 123);
+
+            pr = parse_u64("18446744073709551615", u64v);
+            ENSURE(!pr.overflow && u64v == UINT64_MAX);
+            pr = parse_u64("18446744073709551616", u64v);
+            ENSURE(pr.overflow && u64v == UINT64_MAX);
+            pr = parse_s64("-9223372036854775808", s64v);
+            ENSURE(!pr.overflow && s64v == INT64_MIN);
+            pr = parse_s64("00000000000000000000009223372036854775807", s64v);
+            ENSURE(!pr.overflow && s64v == INT64_MAX);
+        }
+
+        // Hex
+        {
+            u64 val = 0;
+            ParseResult pr = parse_hex("0BADbeef", val);
+            ENSURE(pr.consumed == 8 && val == 0x0BADBEEF);
+            pr = parse_hex("0badbeef0123beefff", val, 16);
+            ENSURE(pr.consumed == 16 && val == 0x0BADBEEF0123BEEFULL);
+            pr = parse_hex("0badbeef0123beefff", val, 32);
+            ENSURE(pr.consumed == 18 && pr.overflow && val == UINT64_MAX);
+            pr = parse_hex("g", val);
+            ENSURE(pr.consumed == 0);
+        }
+
+        // Floats
+        {
+            f64 d = 0.0;
+            f32 f = 0.0f;
+
+            ParseResult pr = parse_f64("1.5e3,", d);
+            ENSURE(pr.consumed == 5 && d == 1500.0);
+            pr = parse_f64("-.25", d);
+            ENSURE(pr.consumed == 4 && d == -0.25);
+            pr = parse_f64("7.e", d);
+            ENSURE(pr.consumed == 2 && d == 7.0);
+            pr = parse_f64("1e-", d);
+            ENSURE(pr.consumed == 1 && d == 1.0);
+            pr = parse_f64(".", d);
+            ENSURE(pr.consumed == 0);
+            pr = parse_f64("-0", d);
+            ENSURE(pr.consumed == 2 && d == 0.0 && signbit(d));
+            pr = parse_f64("inf", d);
+            ENSURE(pr.consumed == 3 && !pr.overflow && d == f64(INFINITY));
+            pr = parse_f64("nan", d);
+            ENSURE(pr.consumed == 3 && d != d);
+            pr = parse_f64("1e400", d);
+            ENSURE(pr.overflow && d == f64(INFINITY));
+            pr = parse_f64("1e-400", d);
+            ENSURE(!pr.overflow && d == 0.0);
+            pr = parse_f64("2.2250738585072011e-308", d);
+            ENSURE(d == 2.2250738585072011e-308);
+            pr = parse_f64("0.100000000000000000000000000000000000000000001", d);
+            ENSURE(d == 0.1);
+
+            // 2^53 + 1 is halfway between two doubles: digits far past the
+            // first ones decide the rounding.
+            char halfway[1024];
+            strcpy(halfway, "9007199254740993.");
+            memset(halfway + 17, '0', 900);
+            strcpy(halfway + 917, "1");
+            pr = parse_f64(halfway, d);
+            ENSURE(pr.consumed == 918 && d == 9007199254740994.0);
+            halfway[917] = '\0';
+            pr = parse_f64(halfway, d);
+            ENSURE(d == 9007199254740992.0);
+            pr = parse_f32("3.40282356e38", f);
+            ENSURE(!pr.overflow && f == 3.4028235e38f);
+            pr = parse_f32("1e39", f);
+            ENSURE(pr.overflow && f == f32(INFINITY));
+
+            // Same as strtod()/strtof() on random numbers in many shapes.
+            u64 state = 0x0BADBEEF;
+            char buf[64];
+            for (u32 i = 0; i < 100000; ++i)
+            {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                const u64 r = state ^ (state >> 29);
+                const f64 v = f64(r >> 11) * (r & 1 ? 1e-10 : 1.0);
+                switch ((r >> 1) % 4)
+                {
+                case 0: snprintf(buf, sizeof(buf), "%.17g", v); break;
+                case 1: snprintf(buf, sizeof(buf), "%.6f", v / 1e6); break;
+                case 2: snprintf(buf, sizeof(buf), "%.12e", v * 1e-300); break;
+                case 3: snprintf(buf, sizeof(buf), "%u.%ue%d", u32(r >> 40), u32(r >> 20) & 0xfff, s32(r % 80) - 40); break;
+                }
+
+                pr = parse_f64(buf, d);
+                ENSURE(pr.consumed == strlen32(buf));
+                ENSURE(d == strtod(buf, NULL));
+                pr = parse_f32(buf, f);
+                ENSURE(pr.consumed == strlen32(buf));
+                ENSURE(f == strtof(buf, NULL));
+            }
+        }
+    }
+
+    static void test_parallel_algorithms()
+    {
+        Allocator& a = default_allocator();
+        JobSystem js1(a, 1);
+        JobSystem js3(a, 3);
+        JobSystem js_fibers(a, 2, 16);
+        JobSystem* systems[] = { &js1, &js3, &js_fibers };
+
+        {
+            // Every index is visited once.
+            const u32 n = 100003;
+            Array<u32> hits(a);
+            array::resize(hits, n);
+            for (u32 s = 0; s < countof(systems); ++s)
+            {
+                memset(array::begin(hits), 0, n * sizeof(u32));
+                parallel_for(*systems[s], n, [&](u32 begin, u32 end) {
+                    for (u32 i = begin; i < end; ++i)
+                        ++hits[i];
+                });
+                array::parallel_for(*systems[s], hits, [](u32& h) { h *= 3; }, 1000);
+                ENSURE(array::count(hits, 3u) == n);
+            }
+
+            u32 calls = 0;
+            parallel_for(js3, 0, [&](u32, u32) { ++calls; });
+            ENSURE(calls == 0);
+            parallel_for(js3, 10, [&](u32 begin, u32 end) { calls += end - begin; });
+            ENSURE(calls == 10);
+        }
+        {
+            // Same results whatever the number of threads, floats included.
+            const u32 n = 250000;
+            Array<f32> vals(a);
+            u64 state = 1;
+            for (u32 i = 0; i < n; ++i)
+            {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                array::push_back(vals, f32(state >> 40) / f32(1 << 24) - 0.5f);
+            }
+
+            const auto add = [](f32 x, f32 y) { return x + y; };
+            const f32 sum = array::parallel_reduce(js1, vals, 0.0f, add);
+            const f32 sum100 = array::parallel_reduce(js1, vals, 0.0f, add, 100);
+            for (u32 s = 1; s < countof(systems); ++s)
+            {
+                const f32 other = array::parallel_reduce(*systems[s], vals, 0.0f, add);
+                ENSURE(memcmp(&other, &sum, sizeof(sum)) == 0);
+                const f32 other100 = array::parallel_reduce(*systems[s], vals, 0.0f, add, 100);
+                ENSURE(memcmp(&other100, &sum100, sizeof(sum100)) == 0);
+            }
+
+            const u64 num_positive = parallel_reduce(js3, n, u64(0), [&](u32 begin, u32 end) {
+                u64 num = 0;
+                for (u32 i = begin; i < end; ++i)
+                    num += u64(vals[i] > 0.0f);
+                return num;
+            }, [](u64 x, u64 y) { return x + y; });
+            u64 expected = 0;
+            for (u32 i = 0; i < n; ++i)
+                expected += u64(vals[i] > 0.0f);
+            ENSURE(num_positive == expected);
+
+            // Partial results are constructed and destroyed, not assigned
+            // over raw memory.
+            struct Counted
+            {
+                s32* live;
+                u64 value;
+
+                Counted(s32* l, u64 v) : live(l), value(v) { ++*live; }
+                Counted(const Counted& o) : live(o.live), value(o.value) { ++*live; }
+                ~Counted() { --*live; }
+                Counted& operator=(const Counted& o) { value = o.value; return *this; }
+            };
+            s32 live = 0;
+            {
+                const Counted total = parallel_reduce(js3, n, Counted(&live, 0), [&](u32 begin, u32 end) {
+                    return Counted(&live, end - begin);
+                }, [&](const Counted& x, const Counted& y) { return Counted(&live, x.value + y.value); });
+                ENSURE(total.value == n);
+            }
+            ENSURE(live == 0);
+
+            Array<f32> scan1(vals);
+            array::parallel_prefix_sum(js1, scan1);
+            for (u32 s = 1; s < countof(systems); ++s)
+            {
+                Array<f32> scan(vals);
+                array::parallel_prefix_sum(*systems[s], scan);
+                ENSURE(memcmp(array::begin(scan), array::begin(scan1), n * sizeof(f32)) == 0);
+            }
+            // The last item is the reduction with the same chunks.
+            ENSURE(memcmp(&array::back(scan1), &sum, sizeof(sum)) == 0);
+        }
+        {
+            // Prefix sums, exact with integers.
+            const u32 sizes[] = { 0, 1, 2, 63, 64, 65, 1000, 32768, 100000 };
+            for (u32 i = 0; i < countof(sizes); ++i)
+            {
+                Array<u64> vals(a);
+                for (u32 j = 0; j < sizes[i]; ++j)
+                    array::push_back(vals, u64(j) * 7 + 1);
+
+                array::parallel_prefix_sum(js3, vals, i % 2 == 0 ? 0 : 10);
+                u64 sum = 0;
+                bool ok = true;
+                for (u32 j = 0; j < sizes[i]; ++j)
+                {
+                    sum += u64(j) * 7 + 1;
+                    ok = ok && vals[j] == sum;
+                }
+                ENSURE(ok);
+            }
+        }
+        {
+            // Sorts match the serial ones.
+            const u32 sizes[] = { 0, 1, 100, 40000, 200001 };
+            for (u32 i = 0; i < countof(sizes); ++i)
+            {
+                const u32 n = sizes[i];
+                Array<u64> keys(a);
+                u64 state = i + 1;
+                for (u32 j = 0; j < n; ++j)
+                    array::push_back(keys, (state = state * 6364136223846793005ull + 1442695040888963407ull) >> (j % 3 == 0 ? 8 : 40));
+
+                Array<u64> expected(keys);
+                array::radix_sort(expected);
+
+                for (u32 s = 0; s < countof(systems); ++s)
+                {
+                    Array<u64> sorted(keys);
+                    array::parallel_radix_sort(*systems[s], sorted);
+                    ENSURE(n == 0 || memcmp(array::begin(sorted), array::begin(expected), n * sizeof(u64)) == 0);
+
+                    Array<u64> merged(keys);
+                    array::parallel_merge_sort(*systems[s], merged);
+                    ENSURE(n == 0 || memcmp(array::begin(merged), array::begin(expected), n * sizeof(u64)) == 0);
+                }
+
+                // Stability: sort by the high 4 bits, the low bits store the
+                // original position.
+                Array<u32> items(a);
+                for (u32 j = 0; j < n; ++j)
+                    array::push_back(items, (u32(keys[j]) & 0xf0000000u) | j);
+
+                Array<u32> stable(items);
+                array::parallel_merge_sort(js3, stable, [](u32 x, u32 y) { return (x >> 28) < (y >> 28); });
+                bool ok = true;
+                for (u32 j = 1; j < n; ++j)
+                    ok = ok && (stable[j - 1] >> 28 < stable[j] >> 28 || (stable[j - 1] >> 28 == stable[j] >> 28 && stable[j - 1] < stable[j]));
+                ENSURE(ok);
+            }
+        }
     }
 
     static void test_string_id()
@@ -517,6 +1595,116 @@ namespace crown
             a.to_string(buf, STRING_ID64_BUF_LEN);
             ENSURE(strcmp(buf, "0BADBEEF0123BEEF"));
         }
+
+        // Compile time ids
+        {
+            constexpr StringId32 a = "abcdefghijk"_id32;
+            constexpr StringId64 b = "abcdefghijk"_id64;
+            CE_STATIC_ASSERT(a._id == 0x4a7439a6U);
+            CE_STATIC_ASSERT(b._id == 0xfeff07a18c726536ULL);
+            ENSURE(StringId64("hello crown!") == "hello crown!"_id64);
+
+            ENSURE(CE_STRING_ID_32("hello crown!") == 0xb43b4b93U);
+            ENSURE(CE_STRING_ID_64("hello crown!") == 0xc770ec4f5e298d4dULL);
+
+            const StringId64 id("world");
+            switch (id._id)
+            {
+            case CE_STRING_ID_64("hello"): ENSURE(false); break;
+            case CE_STRING_ID_64("world"): break;
+            default: ENSURE(false); break;
+            }
+        }
+    }
+
+    // Returns the path of the file `name` in the temporary directory.
+    static const char* temp_path(char* buf, u32 len, const char* name)
+    {
+        const char* dir = getenv("TMPDIR");
+        if (dir == NULL)
+            dir = getenv("TEMP");
+        if (dir == NULL)
+            dir = "/tmp";
+
+        snprintf(buf, len, "%s/%s", dir, name);
+        return buf;
+    }
+
+    static void test_string_id_table()
+    {
+#if CROWN_STRING_ID_TABLE
+        // Created by memory_globals::init(): start from an empty one.
+        string_id_table::shutdown();
+#endif
+        // Ids from literals are not recorded by the constructor.
+        string_id_table::init(default_allocator());
+        {
+            ENSURE(string_id_table::lookup(StringId32(0x0BADBEEFU)) == NULL);
+            ENSURE(string_id_table::lookup(StringId64(0x0BADBEEFULL)) == NULL);
+
+            ENSURE(string_id_table::add("units/player"_id32, "units/player", 12));
+            ENSURE(string_id_table::add("units/player"_id64, "units/player", 12));
+            ENSURE(strcmp(string_id_table::lookup("units/player"_id32), "units/player") == 0);
+            ENSURE(strcmp(string_id_table::lookup("units/player"_id64), "units/player") == 0);
+
+#if CROWN_STRING_ID_TABLE
+            // Recorded by the constructor.
+            const StringId64 id("textures/grass");
+            ENSURE(strcmp(string_id_table::lookup(id), "textures/grass") == 0);
+#endif
+
+            // Collisions.
+            ENSURE(string_id_table::add(StringId64(42ULL), "forty-two", 9));
+            ENSURE(string_id_table::add(StringId64(42ULL), "forty-two", 9));
+            ENSURE(string_id_table::num_collisions() == 0);
+            ENSURE(!string_id_table::add(StringId64(42ULL), "forty-three", 11));
+            ENSURE(string_id_table::num_collisions() == 1);
+            ENSURE(strcmp(string_id_table::lookup(StringId64(42ULL)), "forty-two") == 0);
+
+            // Growing.
+            char buf[32];
+            for (u32 i = 0; i < 5000; ++i)
+            {
+                snprintf(buf, sizeof(buf), "resource_%u", i);
+                ENSURE(string_id_table::add(StringId32(buf, strlen32(buf)), buf, strlen32(buf)));
+            }
+            for (u32 i = 0; i < 5000; ++i)
+            {
+                snprintf(buf, sizeof(buf), "resource_%u", i);
+                ENSURE(strcmp(string_id_table::lookup(StringId32(buf, strlen32(buf))), buf) == 0);
+            }
+        }
+
+        // Save and load.
+        {
+            char buf[256];
+            const char* path = temp_path(buf, sizeof(buf), "string_id_table.test");
+            ENSURE(string_id_table::save(path));
+
+            // Little-endian whatever the host.
+            u8 header[12];
+            FILE* f = fopen(path, "rb");
+            ENSURE(f != NULL && fread(header, 1, sizeof(header), f) == sizeof(header));
+            fclose(f);
+            ENSURE(memcmp(header, "SIDT\x01\0\0\0", 8) == 0);
+            string_id_table::shutdown();
+
+            string_id_table::init(default_allocator());
+            ENSURE(string_id_table::lookup("units/player"_id64) == NULL);
+            const bool loaded = string_id_table::load(path);
+            remove(path);
+            ENSURE(loaded);
+            ENSURE(strcmp(string_id_table::lookup("units/player"_id32), "units/player") == 0);
+            ENSURE(strcmp(string_id_table::lookup("units/player"_id64), "units/player") == 0);
+            ENSURE(strcmp(string_id_table::lookup(StringId64(42ULL)), "forty-two") == 0);
+            ENSURE(strcmp(string_id_table::lookup("resource_4999"_id32), "resource_4999") == 0);
+
+            ENSURE(!string_id_table::load(path));
+        }
+        string_id_table::shutdown();
+#if CROWN_STRING_ID_TABLE
+        string_id_table::init(default_allocator());
+#endif
     }
 
     static void test_string_inline()
@@ -604,12 +1792,251 @@ namespace crown
         }
     }
 
-    static void test_string_stream()
+    static void test_string_scan()
     {
-        // char
+        // Reference results, one byte at a time.
+        struct Naive
         {
-            TempAllocator1024 ta;
-            StringStream ss(ta);
+            static u32 find_any(const char* s, u32 n, const char* set, u32 from)
+            {
+                for (; from < n && strchr(set, s[from]) == NULL; ++from)
+                {
+                }
+                return from;
+            }
+
+            static u32 find_block_end(const char* s, u32 n, u32 from)
+            {
+                u32 depth = 0;
+                for (; from < n; ++from)
+                {
+                    if (s[from] == '{')
+                        ++depth;
+                    else if (s[from] == '}' && depth > 0 && --depth == 0)
+                        return from;
+                }
+                return n;
+            }
+        };
+
+        // Every length and every start position up to a few vectors, with
+        // the text at the very end of its allocation so that ASan catches
+        // reads past the end.
+        {
+            const char alphabet[] = "ab \t\n\r{}\v\f,";
+            u64 state = 0x0BADBEEF;
+
+            for (u32 n = 0; n < 150; ++n)
+            {
+                char* text = (char*)default_allocator().allocate(max(n, 1u), 1);
+                for (u32 i = 0; i < n; ++i)
+                {
+                    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                    text[i] = alphabet[(state >> 33) % (countof(alphabet) - 1)];
+                }
+
+                const StringView sv(text, n);
+                u32 newlines = 0;
+                for (u32 i = 0; i < n; ++i)
+                    newlines += text[i] == '\n';
+                ENSURE(string_scan::count_newlines(sv) == newlines);
+
+                for (u32 from = 0; from <= n; ++from)
+                {
+                    ENSURE(string_scan::find(sv, ',', from) == Naive::find_any(text, n, ",", from));
+                    ENSURE(string_scan::find_any(sv, "{}", 2, from) == Naive::find_any(text, n, "{}", from));
+                    ENSURE(string_scan::skip_spaces(sv, from) == Naive::find_any(text, n, "ab{},", from));
+                    ENSURE(string_scan::find_block_end(sv, '{', '}', from) == Naive::find_block_end(text, n, from));
+                }
+
+                default_allocator().deallocate(text);
+            }
+        }
+
+        // find_any() with a large set
+        {
+            const char* set = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+            ENSURE(string_scan::find_any("hello, World", set, strlen32(set)) == 7);
+            ENSURE(string_scan::find_any("hello, world", set, strlen32(set)) == 12);
+            ENSURE(string_scan::find_any("hello", set, 0) == 5);
+        }
+
+        // find_block_end()
+        {
+            const StringView sv("} a = { b = { c = 1 } d = [] } e");
+            ENSURE(string_scan::find_block_end(sv, '{', '}') == 29);
+            ENSURE(string_scan::find_block_end(sv, '{', '}', 7) == 20);
+            ENSURE(string_scan::find_block_end(sv, '[', ']') == 27);
+            ENSURE(string_scan::find_block_end("{ { }", '{', '}') == 5);
+        }
+
+        // split()
+        {
+            StringView parts[4];
+            ENSURE(string_scan::split("a,,bc", ',', parts, countof(parts)) == 3);
+            ENSURE(parts[0] == "a");
+            ENSURE(parts[1] == "");
+            ENSURE(parts[2] == "bc");
+
+            ENSURE(string_scan::split("", ',', parts, countof(parts)) == 1);
+            ENSURE(parts[0] == "");
+
+            ENSURE(string_scan::split("1,2,3,4,5,6", ',', parts, countof(parts)) == 6);
+            ENSURE(parts[3] == "4");
+        }
+    }
+
+    static void test_string_table()
+    {
+        Allocator& a = default_allocator();
+        {
+            StringTable st(a);
+            ENSURE(st.size() == 0);
+            ENSURE(st.find("foo") == StringTable::NO_OFFSET);
+
+            const u32 foo = st.add("foo");
+            const u32 bar = st.add("bar");
+            ENSURE(foo != bar);
+            ENSURE(st.add("foo") == foo);
+            ENSURE(st.add(StringView("foobar", 3)) == foo);
+            ENSURE(st.size() == 2);
+            ENSURE(st.find("bar") == bar);
+            ENSURE(st.find("ba") == StringTable::NO_OFFSET);
+            ENSURE(strcmp(st.c_str(foo), "foo") == 0);
+            ENSURE(st.view(bar) == "bar");
+
+            const u32 empty = st.add("");
+            ENSURE(st.find("") == empty);
+            ENSURE(st.view(empty)._length == 0);
+
+            // Adding a string already in the table never grows the index.
+            char buf[16];
+            for (u32 i = st.size(); i < 32; ++i)
+            {
+                ::snprintf(buf, sizeof(buf), "s%u", i);
+                st.add(buf);
+            }
+            ENSURE(st.size() == 32 && st._capacity == 64);
+            ENSURE(st.add("foo") == foo);
+            ENSURE(st._capacity == 64);
+
+            // Offsets must fit in 32 bits.
+            const u32 data_size = st._data_size;
+            st._data_size = StringTable::NO_OFFSET - 4;
+            ENSURE(st.add("too far") == StringTable::NO_OFFSET);
+            st._data_size = data_size;
+            ENSURE(st.size() == 32);
+            ENSURE(st.find("too far") == StringTable::NO_OFFSET);
+
+            st.clear();
+            ENSURE(st.size() == 0);
+            ENSURE(st.find("foo") == StringTable::NO_OFFSET);
+        }
+        {
+            // Many pages, a string larger than a page and a blob round trip.
+            StringTable st(a);
+            Array<u32> offsets(a);
+            char buf[64];
+            for (u32 i = 0; i < 20000; ++i)
+            {
+                ::snprintf(buf, sizeof(buf), "units/level_%u/item_%u.unit", i % 37, i);
+                array::push_back(offsets, st.add(buf));
+            }
+
+            Array<char> big(a);
+            array::resize(big, 200000);
+            for (u32 i = 0; i < array::size(big); ++i)
+                big[i] = 'a' + i % 26;
+            const u32 big_offset = st.add(StringView(big._data, array::size(big)));
+            const u32 after = st.add("after");
+            ENSURE(st.size() == 20002);
+            ENSURE(st.data_size() > 20000 * 24 + array::size(big));
+
+            for (u32 i = 0; i < 20000; i += 7)
+            {
+                ::snprintf(buf, sizeof(buf), "units/level_%u/item_%u.unit", i % 37, i);
+                ENSURE(st.find(buf) == offsets[i]);
+                ENSURE(st.view(offsets[i]) == buf);
+            }
+            ENSURE(st.view(big_offset) == StringView(big._data, array::size(big)));
+
+            Buffer blob(a);
+            st.save(blob);
+
+            // Like a mapped file.
+            char* mem = (char*)a.allocate(array::size(blob), 8);
+            memcpy(mem, blob._data, array::size(blob));
+
+            StringTableBlob stb;
+            ENSURE(stb.open(mem, array::size(blob)));
+            ENSURE(stb.size() == st.size());
+            for (u32 i = 0; i < 20000; i += 7)
+            {
+                ::snprintf(buf, sizeof(buf), "units/level_%u/item_%u.unit", i % 37, i);
+                ENSURE(stb.find(buf) == offsets[i]);
+                ENSURE(strcmp(stb.c_str(offsets[i]), buf) == 0);
+            }
+            ENSURE(stb.find(StringView(big._data, array::size(big))) == big_offset);
+            ENSURE(stb.view(after) == "after");
+            ENSURE(stb.find("units/level_0/item_20000.unit") == StringTable::NO_OFFSET);
+
+            ENSURE(!stb.open(mem, array::size(blob) - 1));
+
+            // Corrupt index entries.
+            StringTable::Entry* index = (StringTable::Entry*)(mem + 24);
+            u32 used = 0;
+            while (index[used].offset == StringTable::NO_OFFSET)
+                ++used;
+            const StringTable::Entry saved = index[used];
+            index[used].offset = st.data_size() - 1;
+            ENSURE(!stb.open(mem, array::size(blob)));
+            index[used].offset = saved.offset;
+            index[used].length = saved.length + 1;
+            ENSURE(!stb.open(mem, array::size(blob)));
+            index[used].offset = StringTable::NO_OFFSET;
+            ENSURE(!stb.open(mem, array::size(blob)));
+            index[used] = saved;
+            ENSURE(stb.open(mem, array::size(blob)));
+
+            // Saved on a host with the other byte order.
+            exchange(mem[20], mem[23]);
+            exchange(mem[21], mem[22]);
+            ENSURE(!stb.open(mem, array::size(blob)));
+            exchange(mem[20], mem[23]);
+            exchange(mem[21], mem[22]);
+
+            mem[0] = 'X';
+            ENSURE(!stb.open(mem, array::size(blob)));
+            a.deallocate(mem);
+        }
+        {
+            Buffer blob(a);
+            StringTable st(a);
+            st.save(blob);
+            u64 mem[8];
+            ENSURE(array::size(blob) <= sizeof(mem));
+            memcpy(mem, blob._data, array::size(blob));
+
+            StringTableBlob stb;
+            ENSURE(stb.open(mem, array::size(blob)));
+            ENSURE(stb.size() == 0);
+            ENSURE(stb.find("foo") == StringTable::NO_OFFSET);
+        }
+        {
+            // Pages from the scratch allocator.
+            StringTable st(default_scratch_allocator());
+            const u32 offset = st.add("scratch");
+            ENSURE(st.find("scratch") == offset);
+            ENSURE(st.view(offset) == "scratch");
+        }
+    }
+
+    static void test_string_stream()
+    {
+        // char
+        {
+            TempAllocator1024 ta;
+            StringStream ss(ta);
             ss << 'B' << 'a' << 'b' << 'y';
             ENSURE(strcmp(string_stream::c_str(ss), "Baby") == 0);
         }
@@ -661,6 +2088,15 @@ namespace crown
             ss << a << b;
             ENSURE(strcmp(string_stream::c_str(ss), "1.2-6.466") == 0);
         }
+
+        // stream_hex()/stream_fixed()
+        {
+            TempAllocator1024 ta;
+            StringStream ss(ta);
+            string_stream::stream_hex(ss, 0xbeef, 8) << ' ';
+            string_stream::stream_fixed(ss, 2.0/3.0, 4);
+            ENSURE(strcmp(string_stream::c_str(ss), "0000beef 0.6667") == 0);
+        }
     }
 
     static void test_string_view()
@@ -689,6 +2125,1229 @@ namespace crown
         b = "abc";
         ENSURE(a < b);
         ENSURE('C' < 'c');
+
+        {
+            // Hashes agree with the ids and owned strings of the same text.
+            const char* str = "foo/bar.unit";
+            const StringView sv(str);
+            DynamicString ds(default_allocator());
+            ds = str;
+            ENSURE(hash<StringView>()(sv) == StringId32(str)._id);
+            ENSURE(hash<StringId32>()(sv) == hash<StringId32>()(StringId32(str)));
+            ENSURE(hash<StringId64>()(sv) == hash<StringId64>()(StringId64(str)));
+            ENSURE(hash<DynamicString>()(ds) == hash<StringView>()(sv));
+            ENSURE(hash<DynamicString>()(sv) == hash<StringView>()(sv));
+            ENSURE(hash<StringId32>().to_key(sv) == StringId32(str));
+            ENSURE(hash<StringId32>().to_key(StringView(str, 3)) != StringId32(str));
+            ENSURE(hash<StringId64>().to_key(sv) == StringId64(str));
+            ENSURE(equal_to<DynamicString>()(ds, sv));
+        }
+    }
+
+    static void test_utf8()
+    {
+        Allocator& a = default_allocator();
+        {
+            ENSURE(utf8::validate(""));
+            ENSURE(utf8::validate("plain ascii"));
+            ENSURE(utf8::validate("\xc3\xa9t\xc3\xa9"));           // été
+            ENSURE(utf8::validate("\xe4\xb8\xad\xe6\x96\x87"));     // 中文
+            ENSURE(utf8::validate("\xf0\x9f\x98\x80"));             // U+1F600
+            ENSURE(utf8::validate("\xf4\x8f\xbf\xbf"));             // U+10FFFF
+            ENSURE(utf8::validate("\xed\x9f\xbf"));                 // U+D7FF
+            ENSURE(utf8::validate("\xee\x80\x80"));                 // U+E000
+
+            ENSURE(!utf8::validate("\x80"));                        // Lone continuation
+            ENSURE(!utf8::validate("\xc3"));                        // Truncated
+            ENSURE(!utf8::validate("\xc3x"));                       // Too short
+            ENSURE(!utf8::validate("\xc0\xaf"));                    // Overlong 2
+            ENSURE(!utf8::validate("\xe0\x80\xaf"));                // Overlong 3
+            ENSURE(!utf8::validate("\xf0\x80\x80\xaf"));            // Overlong 4
+            ENSURE(!utf8::validate("\xed\xa0\x80"));                // Surrogate
+            ENSURE(!utf8::validate("\xf4\x90\x80\x80"));            // Too large
+            ENSURE(!utf8::validate("\xf8\x88\x80\x80\x80"));        // 5 bytes
+            ENSURE(!utf8::validate("\xff"));
+            ENSURE(!utf8::validate("\xe4\xb8\xad\x80"));            // Too long
+        }
+        {
+            // Errors and sequences across vector blocks.
+            const char* seqs[] = { "\xc3\xa9", "\xe4\xb8\xad", "\xf0\x9f\x98\x80", "\xc3", "\xe4\xb8", "\xf0\x9f\x98", "\x80", "\xed\xa0\x80" };
+            char buf[128];
+            for (u32 k = 0; k < countof(seqs); ++k)
+            {
+                const u32 len = strlen32(seqs[k]);
+                const bool valid = k < 3;
+                for (u32 pos = 0; pos + len <= 100; ++pos)
+                {
+                    memset(buf, 'x', sizeof(buf));
+                    memcpy(buf + pos, seqs[k], len);
+                    ENSURE(utf8::validate(StringView(buf, pos + len)) == valid);
+                    ENSURE(utf8::validate(StringView(buf, 100)) == valid);
+                }
+            }
+        }
+        {
+            // Compare against the scalar decoder of to_utf32() on random
+            // strings of interesting bytes.
+            const u8 bytes[] = { 'a', 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0, 0xbf, 0xc0, 0xc2, 0xdf, 0xe0, 0xed, 0xef, 0xf0, 0xf4, 0xf5, 0xff };
+            u64 state = 1;
+            char buf[80];
+            Array<u32> u32s(a);
+            for (u32 iter = 0; iter < 20000; ++iter)
+            {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                const u32 len = u32(state >> 58) + 16;
+                for (u32 i = 0; i < len; ++i)
+                {
+                    state = state * 6364136223846793005ull + 1442695040888963407ull;
+                    const u32 r = u32(state >> 40);
+                    buf[i] = (r & 0x300) != 0 ? char(bytes[r % countof(bytes)]) : 'a';
+                }
+                array::clear(u32s);
+                ENSURE(utf8::validate(StringView(buf, len)) == utf8::to_utf32(StringView(buf, len), u32s));
+            }
+        }
+        {
+            const char* str = "h\xc3\xa9llo \xe4\xb8\xad\xe6\x96\x87 \xf0\x9f\x98\x80 and some more ascii text";
+            const StringView sv(str);
+            ENSURE(utf8::count_code_points(sv) == 35);
+
+            Array<u16> u16s(a);
+            array::push_back(u16s, u16(7));
+            ENSURE(utf8::to_utf16(sv, u16s));
+            ENSURE(array::size(u16s) == 1 + 36);
+            ENSURE(u16s[0] == 7);
+            ENSURE(u16s[2] == 0xe9);
+            ENSURE(u16s[7] == 0x4e2d);
+            ENSURE(u16s[10] == 0xd83d && u16s[11] == 0xde00);
+
+            Array<u32> u32s(a);
+            ENSURE(utf8::to_utf32(sv, u32s));
+            ENSURE(array::size(u32s) == 35);
+            ENSURE(u32s[9] == 0x1f600);
+
+            Array<char> back(a);
+            ENSURE(utf8::from_utf16(u16s._data + 1, array::size(u16s) - 1, back));
+            ENSURE(StringView(back._data, array::size(back)) == sv);
+            array::clear(back);
+            ENSURE(utf8::from_utf32(u32s._data, array::size(u32s), back));
+            ENSURE(StringView(back._data, array::size(back)) == sv);
+
+            // Failures leave the output unchanged.
+            ENSURE(!utf8::to_utf16("ab\xc3", u16s));
+            ENSURE(array::size(u16s) == 37);
+            const u16 lone[] = { 'a', 0xdc00 };
+            const u16 high[] = { 0xd800, 'a' };
+            ENSURE(!utf8::from_utf16(lone, countof(lone), back));
+            ENSURE(!utf8::from_utf16(high, countof(high), back));
+            ENSURE(!utf8::from_utf16(high, 1, back));
+            const u32 big[] = { 0x110000 };
+            const u32 sur[] = { 0xdfff };
+            ENSURE(!utf8::from_utf32(big, 1, back));
+            ENSURE(!utf8::from_utf32(sur, 1, back));
+            ENSURE(StringView(back._data, array::size(back)) == sv);
+        }
+    }
+
+    static void test_wildcard_set()
+    {
+        // Same results as wildcmp()
+        {
+            const char* patterns[] =
+            {
+                "", "*", "**", "?", "a", "a*", "*a", "*a*", "a?c", "a*c", "*ab*ba*",
+                "units/*.unit", "units/*/*.unit", "*.png", "textures/?/?*", "a*b*c*d",
+                "?*?", "*?a?*", "ab", "abc*", "abc*abc", "*bc", "b*?*b",
+            };
+
+            TempAllocator4096 ta;
+            WildcardSet ws(ta);
+            for (u32 i = 0; i < countof(patterns); ++i)
+                ENSURE(ws.add(patterns[i]) == i);
+            ws.compile();
+            ENSURE(ws.size() == countof(patterns));
+
+            const char alphabet[] = "abcd/.";
+            u64 state = 0x0BADBEEF;
+            BitArray matched(ta);
+            char str[16];
+
+            for (u32 n = 0; n < 20000; ++n)
+            {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                const u32 len = u32(state >> 60) % countof(str);
+                for (u32 i = 0; i < len; ++i)
+                {
+                    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                    str[i] = alphabet[(state >> 33) % (countof(alphabet) - 1)];
+                }
+                str[len] = '\0';
+
+                u32 num = 0;
+                for (u32 i = 0; i < countof(patterns); ++i)
+                    num += wildcmp(patterns[i], str);
+
+                ENSURE(ws.match(str, matched) == num);
+                ENSURE(ws.match_any(str) == (num != 0));
+                for (u32 i = 0; i < countof(patterns); ++i)
+                    ENSURE(bit_array::test(matched, i) == (wildcmp(patterns[i], str) == 1));
+            }
+        }
+
+        // Paths
+        {
+            TempAllocator1024 ta;
+            WildcardSet ws(ta);
+            ws.add("units/*.unit");
+            ws.add("*.png");
+            ws.add("units/*/textures/*.png");
+            ws.compile();
+
+            BitArray matched(ta);
+            ENSURE(ws.match("units/tree.unit", matched) == 1);
+            ENSURE(bit_array::test(matched, 0));
+            ENSURE(ws.match("units/tree/textures/bark.png", matched) == 2);
+            ENSURE(bit_array::test(matched, 1));
+            ENSURE(bit_array::test(matched, 2));
+            ENSURE(ws.match("units/tree.png.bak", matched) == 0);
+            ENSURE(!ws.match_any("core/shaders/common.shader"));
+        }
+    }
+
+    // Whether MAP::has() accepts a KEY.
+    template <typename MAP, typename KEY, typename = void>
+    struct HasLookup { static const bool value = false; };
+
+    template <typename MAP, typename KEY>
+    struct HasLookup<MAP, KEY, decltype(void(std::declval<const MAP&>().has(std::declval<const KEY&>())))> { static const bool value = true; };
+
+    static void test_concurrent_hash_map()
+    {
+        Allocator& a = default_allocator();
+        {
+            ConcurrentHashMap<u64, u32> m(a);
+            ENSURE(m.size() == 0);
+            ENSURE(!m.has(0));
+
+            u32 v = 0;
+            ENSURE(!m.get(42, v));
+            ENSURE(!m.remove(42));
+
+            m.set(42, 1);
+            ENSURE(m.size() == 1);
+            ENSURE(m.get(42, v) && v == 1);
+            m.set(42, 2);
+            ENSURE(m.size() == 1);
+            ENSURE(m.get(42, v) && v == 2);
+            ENSURE(m.remove(42));
+            ENSURE(!m.has(42));
+            ENSURE(m.size() == 0);
+        }
+        {
+            // Grow through several incremental migrations.
+            ConcurrentHashMap<u64, u64> m(a);
+            const u64 NUM = 10000;
+            for (u64 i = 0; i < NUM; ++i)
+                m.set(i * 7919, i);
+            ENSURE(m.size() == NUM);
+
+            for (u64 i = 0; i < NUM; ++i)
+            {
+                u64 v = 0;
+                ENSURE(m.get(i * 7919, v));
+                ENSURE(v == i);
+            }
+            ENSURE(!m.has(1));
+
+            for (u64 i = 0; i < NUM; i += 2)
+                ENSURE(m.remove(i * 7919));
+            ENSURE(m.size() == NUM / 2);
+
+            for (u64 i = 0; i < NUM; ++i)
+                ENSURE(m.has(i * 7919) == (i % 2 == 1));
+
+            m.clear();
+            ENSURE(m.size() == 0);
+            ENSURE(!m.has(7919));
+            m.set(7919, 3);
+            ENSURE(m.size() == 1);
+        }
+        {
+            // Deleted slots must not make the map grow or hold on to old
+            // tables.
+            ConcurrentHashMap<u64, u64> m(a);
+            for (u64 i = 0; i < 1000; ++i)
+                m.set(i, i);
+            for (u64 i = 0; i < 1000; ++i)
+                m.remove(i);
+
+            const u32 allocated = a.total_allocated();
+            for (u64 i = 0; i < 100000; ++i)
+            {
+                m.set(1000 + i, i);
+                ENSURE(m.remove(1000 + i));
+            }
+            ENSURE(m.size() == 0);
+            ENSURE(a.total_allocated() <= allocated);
+        }
+        {
+            // Look up StringId keys by views, without hashing to a StringId.
+            ConcurrentHashMap<StringId32, u32> m32(a);
+            ConcurrentHashMap<StringId64, u32> m64(a);
+            const char* names[] = { "core/units/camera", "core/units/light", "core/units/mesh" };
+            for (u32 i = 0; i < countof(names); ++i)
+            {
+                m32.set(StringId32(names[i]), i);
+                m64.set(StringId64(names[i]), i);
+            }
+
+            for (u32 i = 0; i < countof(names); ++i)
+            {
+                const StringView name(names[i]);
+                u32 v = 0;
+                ENSURE(m32.get(name, v) && v == i);
+                ENSURE(m64.get(name, v) && v == i);
+                ENSURE(m32.has(name));
+                ENSURE(m64.has(name));
+            }
+
+            const char* path = "core/units/camera.unit";
+            ENSURE(m32.has(StringView(path, 17)));
+            ENSURE(!m32.has(StringView(path, 16)));
+            ENSURE(!m64.has(StringView(path)));
+            ENSURE(m32.has(StringId32(names[1])));
+        }
+        {
+            // Views only look up keys whose hash has a to_key() for them:
+            // ids do, owned strings would have to allocate.
+            typedef ConcurrentHashMap<StringId32, u32> Map32;
+            typedef ConcurrentHashMap<StringId64, u32> Map64;
+            typedef ConcurrentHashMap<DynamicString, u32> MapString;
+            typedef ConcurrentHashMap<u64, u32> MapInteger;
+            CE_STATIC_ASSERT((HasLookup<Map32, StringView>::value));
+            CE_STATIC_ASSERT((HasLookup<Map64, StringView>::value));
+            CE_STATIC_ASSERT(!(HasLookup<MapString, StringView>::value));
+            CE_STATIC_ASSERT(!(HasLookup<MapInteger, StringView>::value));
+        }
+    }
+
+    static void test_mpmc_queue()
+    {
+        Allocator& a = default_allocator();
+        {
+            MpmcQueue<u32> q(a, 5);
+            ENSURE(q.capacity() == 8);
+            ENSURE(q.size() == 0);
+
+            u32 v = 0;
+            ENSURE(!q.pop(v));
+
+            for (u32 i = 0; i < 8; ++i)
+                ENSURE(q.push(i));
+            ENSURE(!q.push(8));
+            ENSURE(q.size() == 8);
+
+            for (u32 i = 0; i < 8; ++i)
+            {
+                ENSURE(q.pop(v));
+                ENSURE(v == i);
+            }
+            ENSURE(!q.pop(v));
+
+            const QueueStats qs = q.stats();
+            ENSURE(qs.num_full == 1);
+            ENSURE(qs.num_empty == 2);
+        }
+        {
+            // Many laps around the ring.
+            MpmcQueue<u64> q(a, 4);
+            u64 v = 0;
+            for (u64 i = 0; i < 1000; ++i)
+            {
+                ENSURE(q.push(i));
+                ENSURE(q.push(i + 1));
+                ENSURE(q.pop(v));
+                ENSURE(v == i);
+                ENSURE(q.pop(v));
+                ENSURE(v == i + 1);
+            }
+            ENSURE(q.size() == 0);
+        }
+    }
+
+    static void test_spsc_queue()
+    {
+        Allocator& a = default_allocator();
+        {
+            SpscQueue<u32> q(a, 8);
+            ENSURE(q.capacity() == 8);
+            ENSURE(q.size() == 0);
+
+            u32 v = 0;
+            ENSURE(!q.pop(v));
+
+            for (u32 i = 0; i < 8; ++i)
+                ENSURE(q.push(i));
+            ENSURE(!q.push(8));
+            ENSURE(q.size() == 8);
+
+            for (u32 i = 0; i < 8; ++i)
+            {
+                ENSURE(q.pop(v));
+                ENSURE(v == i);
+            }
+
+            const QueueStats qs = q.stats();
+            ENSURE(qs.num_full == 1);
+            ENSURE(qs.num_empty == 1);
+        }
+        {
+            // Batches wrapping around the end of the ring.
+            SpscQueue<u32> q(a, 16);
+            u32 in[12];
+            u32 out[12];
+            u32 next_in = 0;
+            u32 next_out = 0;
+            for (u32 lap = 0; lap < 100; ++lap)
+            {
+                for (u32 i = 0; i < 12; ++i)
+                    in[i] = next_in + i;
+                const u32 pushed = q.push(in, 12);
+                next_in += pushed;
+
+                const u32 popped = q.pop(out, 7 + lap % 6);
+                for (u32 i = 0; i < popped; ++i)
+                    ENSURE(out[i] == next_out + i);
+                next_out += popped;
+                ENSURE(q.size() == next_in - next_out);
+            }
+
+            while (u32 popped = q.pop(out, 12))
+            {
+                for (u32 i = 0; i < popped; ++i)
+                    ENSURE(out[i] == next_out + i);
+                next_out += popped;
+            }
+            ENSURE(next_out == next_in);
+        }
+    }
+
+    static void test_work_stealing_deque()
+    {
+        Allocator& a = default_allocator();
+        {
+            WorkStealingDeque<uintptr_t> q(a, 8);
+            ENSURE(q.capacity() == 8);
+            ENSURE(q.size() == 0);
+
+            uintptr_t v = 0;
+            ENSURE(!q.pop(v));
+            ENSURE(!q.steal(v));
+
+            for (uintptr_t i = 0; i < 8; ++i)
+                ENSURE(q.push(i));
+            ENSURE(!q.push(8));
+            ENSURE(q.size() == 8);
+
+            // The owner pops the newest, thieves steal the oldest.
+            ENSURE(q.pop(v) && v == 7);
+            ENSURE(q.steal(v) && v == 0);
+            ENSURE(q.steal(v) && v == 1);
+            ENSURE(q.pop(v) && v == 6);
+            ENSURE(q.size() == 4);
+            for (uintptr_t i = 2; i < 6; ++i)
+                ENSURE(q.steal(v) && v == i);
+            ENSURE(!q.pop(v));
+            ENSURE(!q.steal(v));
+
+            // Only the owner's failed pops count, not the failed steals.
+            const QueueStats qs = q.stats();
+            ENSURE(qs.num_full == 1);
+            ENSURE(qs.num_empty == 2);
+        }
+        {
+            // The owner pushes and pops while thieves steal: every item is
+            // taken exactly once.
+            const u32 NUM_ITEMS = 100000;
+            struct Data
+            {
+                WorkStealingDeque<uintptr_t>* deque;
+                std::atomic<u8> taken[NUM_ITEMS];
+                std::atomic<bool> done;
+            };
+            WorkStealingDeque<uintptr_t> q(a, 256);
+            Data* data = CE_NEW(a, Data)();
+            data->deque = &q;
+            for (u32 i = 0; i < NUM_ITEMS; ++i)
+                data->taken[i].store(0);
+            data->done.store(false);
+
+            const u32 NUM_THIEVES = 3;
+            Thread thieves[NUM_THIEVES];
+            for (u32 i = 0; i < NUM_THIEVES; ++i)
+            {
+                thieves[i].start([](void* user_data) {
+                    Data& d = *(Data*)user_data;
+                    uintptr_t v;
+                    while (!d.done.load())
+                    {
+                        if (d.deque->steal(v))
+                            d.taken[v].fetch_add(1);
+                    }
+                    return 0;
+                }, data);
+            }
+
+            uintptr_t v;
+            for (u32 i = 0; i < NUM_ITEMS; ++i)
+            {
+                while (!q.push(i))
+                {
+                    if (q.pop(v))
+                        data->taken[v].fetch_add(1);
+                }
+                if (i % 3 == 0 && q.pop(v))
+                    data->taken[v].fetch_add(1);
+            }
+            while (q.pop(v))
+                data->taken[v].fetch_add(1);
+
+            data->done.store(true);
+            for (u32 i = 0; i < NUM_THIEVES; ++i)
+                thieves[i].join();
+
+            u32 num_wrong = 0;
+            for (u32 i = 0; i < NUM_ITEMS; ++i)
+                num_wrong += data->taken[i].load() != 1;
+            ENSURE(num_wrong == 0);
+            CE_DELETE(a, data);
+        }
+    }
+
+    static void test_job_system(u32 num_fibers)
+    {
+        Allocator& a = default_allocator();
+        JobSystem js(a, 3, num_fibers);
+        ENSURE(js.num_workers() == 3);
+
+        static std::atomic<u32> s_sum;
+        {
+            // Posted by a thread that is not a worker.
+            s_sum.store(0);
+            Job jobs[1000];
+            for (u32 i = 0; i < countof(jobs); ++i)
+            {
+                jobs[i].func = [](void* user_data) { s_sum.fetch_add(u32(uintptr_t(user_data))); };
+                jobs[i].user_data = (void*)uintptr_t(i);
+            }
+
+            JobCounter counter;
+            js.run(jobs, countof(jobs), &counter);
+            js.wait(counter);
+            ENSURE(counter._value.load() == 0);
+            ENSURE(s_sum.load() == 999 * 1000 / 2);
+
+            // Again, reusing the counter.
+            js.run(jobs, 10, &counter);
+            js.wait(counter);
+            ENSURE(s_sum.load() == 999 * 1000 / 2 + 45);
+        }
+        {
+            // Jobs that run jobs and wait for them, more than fit in the
+            // deque of a worker.
+            struct Parent
+            {
+                JobSystem* js;
+                u32 num_children;
+                Job* children;
+            };
+
+            s_sum.store(0);
+            const u32 NUM_PARENTS = 8;
+            const u32 NUM_CHILDREN = 5000;
+            Parent parents[NUM_PARENTS];
+            Job jobs[NUM_PARENTS];
+            Array<Job> children(a);
+            array::resize(children, NUM_PARENTS * NUM_CHILDREN);
+
+            for (u32 i = 0; i < NUM_PARENTS; ++i)
+            {
+                parents[i].js = &js;
+                parents[i].num_children = i == 0 ? NUM_CHILDREN : 100;
+                parents[i].children = &children[i * NUM_CHILDREN];
+                jobs[i].func = [](void* user_data) {
+                    Parent& p = *(Parent*)user_data;
+                    for (u32 i = 0; i < p.num_children; ++i)
+                    {
+                        p.children[i].func = [](void*) { s_sum.fetch_add(1); };
+                        p.children[i].user_data = NULL;
+                    }
+
+                    JobCounter counter;
+                    p.js->run(p.children, p.num_children, &counter);
+                    p.js->wait(counter);
+                };
+                jobs[i].user_data = &parents[i];
+            }
+
+            JobCounter counter;
+            js.run(jobs, NUM_PARENTS, &counter);
+            js.wait(counter);
+            ENSURE(s_sum.load() == NUM_CHILDREN + (NUM_PARENTS - 1) * 100);
+
+            // Again, with all the jobs left to the workers.
+            s_sum.store(0);
+            js.run(jobs, NUM_PARENTS, &counter);
+            while (counter._value.load() != 0)
+                thread::yield();
+            ENSURE(s_sum.load() == NUM_CHILDREN + (NUM_PARENTS - 1) * 100);
+        }
+        {
+            // Small batches, with the workers falling asleep in between.
+            s_sum.store(0);
+            Job job;
+            job.func = [](void*) { s_sum.fetch_add(1); };
+            job.user_data = NULL;
+            for (u32 i = 0; i < 100; ++i)
+            {
+                JobCounter counter;
+                js.run(&job, 1, &counter);
+                js.wait(counter);
+                for (u32 j = 0; j < 100; ++j)
+                    thread::yield();
+            }
+            ENSURE(s_sum.load() == 100);
+        }
+        {
+            // Jobs earlier in the array start first, on the deque of a
+            // worker too. One worker and no help from this thread keep the
+            // order deterministic.
+            JobSystem js1(a, 1, num_fibers);
+            static u32 s_positions[4];
+            struct Parent
+            {
+                JobSystem* js;
+                Job children[4];
+            };
+
+            Parent parent;
+            parent.js = &js1;
+            for (u32 i = 0; i < countof(parent.children); ++i)
+            {
+                parent.children[i].func = [](void* user_data) { s_positions[uintptr_t(user_data)] = s_sum.fetch_add(1); };
+                parent.children[i].user_data = (void*)uintptr_t(i);
+            }
+
+            Job job;
+            job.func = [](void* user_data) {
+                Parent& p = *(Parent*)user_data;
+                JobCounter counter;
+                p.js->run(p.children, countof(p.children), &counter);
+                p.js->wait(counter);
+            };
+            job.user_data = &parent;
+
+            s_sum.store(0);
+            JobCounter counter;
+            js1.run(&job, 1, &counter);
+            while (counter._value.load() != 0)
+                thread::yield();
+            for (u32 i = 0; i < countof(s_positions); ++i)
+                ENSURE(s_positions[i] == i);
+        }
+    }
+
+    static void test_job_system()
+    {
+        test_job_system(0);
+
+        // Waiting jobs suspend their fiber, or wait by helping once the
+        // pool is empty.
+        test_job_system(64);
+        test_job_system(2);
+    }
+
+    static void test_mutex()
+    {
+        {
+            Mutex m;
+            m.lock();
+            ENSURE(!m.try_lock());
+            m.unlock();
+            ENSURE(m.try_lock());
+            m.unlock();
+        }
+        {
+            // Contended, long enough for lock() to spin and to sleep.
+            struct Data
+            {
+                Mutex mutex;
+                u32 counter;
+            };
+            Data data;
+            data.counter = 0;
+
+            const u32 NUM_THREADS = 4;
+            Thread threads[NUM_THREADS];
+            for (u32 i = 0; i < NUM_THREADS; ++i)
+            {
+                threads[i].start([](void* user_data) {
+                    Data& d = *(Data*)user_data;
+                    for (u32 i = 0; i < 20000; ++i)
+                    {
+                        ScopedMutex sm(d.mutex);
+                        ++d.counter;
+                    }
+                    return 0;
+                }, &data);
+            }
+            for (u32 i = 0; i < NUM_THREADS; ++i)
+                threads[i].join();
+            ENSURE(data.counter == NUM_THREADS * 20000);
+        }
+    }
+
+    static void test_read_write_lock()
+    {
+        {
+            ReadWriteLock rw;
+            rw.lock_read();
+            ENSURE(rw.try_lock_read());
+            ENSURE(!rw.try_lock_write());
+            rw.unlock_read();
+            rw.unlock_read();
+            ENSURE(rw.try_lock_write());
+            ENSURE(!rw.try_lock_read());
+            ENSURE(!rw.try_lock_write());
+            rw.unlock_write();
+            rw.lock_write();
+            rw.unlock_write();
+        }
+        {
+            // Mostly readers. Writers keep `a` and `b` equal, readers must
+            // never see them differ.
+            struct Data
+            {
+                ReadWriteLock lock;
+                u32 a;
+                u32 b;
+                std::atomic<u32> num_torn;
+            };
+            Data data;
+            data.a = 0;
+            data.b = 0;
+            data.num_torn.store(0);
+
+            const u32 NUM_THREADS = 4;
+            Thread threads[NUM_THREADS];
+            for (u32 i = 0; i < NUM_THREADS; ++i)
+            {
+                threads[i].start([](void* user_data) {
+                    Data& d = *(Data*)user_data;
+                    for (u32 i = 0; i < 20000; ++i)
+                    {
+                        if (i % 16 == 0)
+                        {
+                            ScopedWriteLock swl(d.lock);
+                            ++d.a;
+                            ++d.b;
+                        }
+                        else
+                        {
+                            ScopedReadLock srl(d.lock);
+                            if (d.a != d.b)
+                                d.num_torn.fetch_add(1);
+                        }
+                    }
+                    return 0;
+                }, &data);
+            }
+            for (u32 i = 0; i < NUM_THREADS; ++i)
+                threads[i].join();
+            ENSURE(data.num_torn.load() == 0);
+            ENSURE(data.a == NUM_THREADS * 20000 / 16);
+            ENSURE(data.b == data.a);
+        }
+    }
+
+    static void test_spin_lock()
+    {
+        {
+            SpinLock sl;
+            ENSURE(sizeof(sl) == CROWN_CACHE_LINE_SIZE);
+            sl.lock();
+            ENSURE(!sl.try_lock());
+            sl.unlock();
+            ENSURE(sl.try_lock());
+            sl.unlock();
+        }
+        {
+            struct Data
+            {
+                SpinLock lock;
+                u32 counter;
+            };
+            Data data;
+            data.counter = 0;
+
+            const u32 NUM_THREADS = 4;
+            Thread threads[NUM_THREADS];
+            for (u32 i = 0; i < NUM_THREADS; ++i)
+            {
+                threads[i].start([](void* user_data) {
+                    Data& d = *(Data*)user_data;
+                    for (u32 i = 0; i < 20000; ++i)
+                    {
+                        ScopedSpinLock ssl(d.lock);
+                        ++d.counter;
+                    }
+                    return 0;
+                }, &data);
+            }
+            for (u32 i = 0; i < NUM_THREADS; ++i)
+                threads[i].join();
+            ENSURE(data.counter == NUM_THREADS * 20000);
+        }
+    }
+
+    static void test_lock_stats()
+    {
+#if CROWN_LOCK_STATS
+        // Locks with the same name share their counters.
+        Mutex m1("test mutex");
+        Mutex m2("test mutex");
+        SpinLock sl("test spin lock");
+        ReadWriteLock rw("test read-write lock");
+        Mutex unnamed;
+
+        auto find = [](const char* name) {
+            LockStats stats[256];
+            const u32 num = min(lock_stats::get(stats, countof(stats)), u32(countof(stats)));
+            LockStats ls = { NULL, 0, 0, 0 };
+            for (u32 i = 0; i < num; ++i)
+            {
+                if (strcmp(stats[i].name, name) == 0)
+                    ls = stats[i];
+            }
+            return ls;
+        };
+
+        lock_stats::reset();
+        m1.lock();
+        m1.unlock();
+        m2.lock();
+        m2.unlock();
+        ENSURE(m1.try_lock());
+        ENSURE(!m1.try_lock());
+        m1.unlock();
+        unnamed.lock();
+        unnamed.unlock();
+        sl.lock();
+        sl.unlock();
+        rw.lock_read();
+        rw.lock_read();
+        rw.unlock_read();
+        rw.unlock_read();
+        rw.lock_write();
+        rw.unlock_write();
+
+        LockStats ls = find("test mutex");
+        ENSURE(ls.name != NULL);
+        ENSURE(ls.num_acquires == 3);
+        ENSURE(ls.num_contended == 0);
+        ENSURE(ls.wait_ns == 0);
+        ENSURE(find("test spin lock").num_acquires == 1);
+        ENSURE(find("test read-write lock").num_acquires == 3);
+
+        // A thread waits on each lock while this one holds it.
+        struct Data
+        {
+            Mutex* mutex;
+            SpinLock* spin_lock;
+            ReadWriteLock* rw_lock;
+        };
+        Data data = { &m1, &sl, &rw };
+        m1.lock();
+        sl.lock();
+        rw.lock_write();
+
+        Thread t;
+        t.start([](void* user_data) {
+            Data& d = *(Data*)user_data;
+            d.mutex->lock();
+            d.mutex->unlock();
+            d.spin_lock->lock();
+            d.spin_lock->unlock();
+            d.rw_lock->lock_read();
+            d.rw_lock->unlock_read();
+            return 0;
+        }, &data);
+
+        const u64 WAIT_NS = 2*1000*1000;
+        u64 start = lock_stats::now();
+        while (lock_stats::now() - start < WAIT_NS)
+            thread::yield();
+        m1.unlock();
+        start = lock_stats::now();
+        while (lock_stats::now() - start < WAIT_NS)
+            thread::yield();
+        sl.unlock();
+        start = lock_stats::now();
+        while (lock_stats::now() - start < WAIT_NS)
+            thread::yield();
+        rw.unlock_write();
+        t.join();
+
+        const char* names[] = { "test mutex", "test spin lock", "test read-write lock" };
+        for (u32 i = 0; i < countof(names); ++i)
+        {
+            ls = find(names[i]);
+            ENSURE(ls.num_contended == 1);
+            ENSURE(ls.wait_ns > 0);
+        }
+
+        lock_stats::reset();
+        ENSURE(find("test mutex").num_acquires == 0);
+#else
+        Mutex m("test mutex");
+        m.lock();
+        m.unlock();
+        ENSURE(lock_stats::get(NULL, 0) == 0);
+#endif
+    }
+
+    static void test_semaphore()
+    {
+        {
+            Semaphore s;
+            ENSURE(!s.try_wait());
+            s.post(2);
+            ENSURE(s.try_wait());
+            s.wait();
+            ENSURE(!s.try_wait());
+        }
+        {
+            // Producer/consumer, consumers start before anything is posted.
+            struct Data
+            {
+                Semaphore sem;
+                std::atomic<u32> consumed;
+            };
+            Data data;
+            data.consumed.store(0);
+
+            const u32 NUM_THREADS = 4;
+            const u32 NUM_ITEMS = 10000;
+            Thread threads[NUM_THREADS];
+            for (u32 i = 0; i < NUM_THREADS; ++i)
+            {
+                threads[i].start([](void* user_data) {
+                    Data& d = *(Data*)user_data;
+                    for (u32 i = 0; i < NUM_ITEMS / NUM_THREADS; ++i)
+                    {
+                        d.sem.wait();
+                        d.consumed.fetch_add(1);
+                    }
+                    return 0;
+                }, &data);
+            }
+            for (u32 i = 0; i < NUM_ITEMS; i += 10)
+                data.sem.post(i % 20 == 0 ? 1 : 19);
+            for (u32 i = 0; i < NUM_THREADS; ++i)
+                threads[i].join();
+            ENSURE(data.consumed.load() == NUM_ITEMS);
+            ENSURE(!data.sem.try_wait());
+        }
+    }
+
+    static void test_condition_variable()
+    {
+        // Threads take turns: each waits for its own value of `turn`.
+        struct Data
+        {
+            Mutex mutex;
+            ConditionVariable cv;
+            u32 turn;
+            u32 sum;
+        };
+        Data data;
+        data.turn = 0;
+        data.sum = 0;
+
+        const u32 NUM_THREADS = 3;
+        const u32 NUM_ROUNDS = 1000;
+        struct Arg
+        {
+            Data* data;
+            u32 index;
+        };
+        Arg args[NUM_THREADS];
+        Thread threads[NUM_THREADS];
+        for (u32 i = 0; i < NUM_THREADS; ++i)
+        {
+            args[i].data = &data;
+            args[i].index = i;
+            threads[i].start([](void* user_data) {
+                Arg& a = *(Arg*)user_data;
+                Data& d = *a.data;
+                for (u32 i = 0; i < NUM_ROUNDS; ++i)
+                {
+                    ScopedMutex sm(d.mutex);
+                    while (d.turn % NUM_THREADS != a.index)
+                        d.cv.wait(d.mutex);
+                    d.sum += a.index;
+                    ++d.turn;
+                    d.cv.broadcast();
+                }
+                return 0;
+            }, &args[i]);
+        }
+        for (u32 i = 0; i < NUM_THREADS; ++i)
+            threads[i].join();
+        ENSURE(data.turn == NUM_THREADS * NUM_ROUNDS);
+        ENSURE(data.sum == NUM_ROUNDS * (0 + 1 + 2));
+
+        // signal() with a single waiter.
+        data.turn = 0;
+        threads[0].start([](void* user_data) {
+            Data& d = *(Data*)user_data;
+            ScopedMutex sm(d.mutex);
+            while (d.turn == 0)
+                d.cv.wait(d.mutex);
+            return s32(d.turn);
+        }, &data);
+        {
+            ScopedMutex sm(data.mutex);
+            data.turn = 7;
+            data.cv.signal();
+        }
+        ENSURE(threads[0].join() == 7);
+    }
+
+    static void test_task_graph()
+    {
+        Allocator& a = default_allocator();
+
+        // Each task stamps its position in the run.
+        struct Task
+        {
+            std::atomic<u32>* sequence;
+            u32 position;
+            u32 num_runs;
+        };
+        const auto task_func = [](void* user_data) {
+            Task& t = *(Task*)user_data;
+            t.position = t.sequence->fetch_add(1);
+            ++t.num_runs;
+        };
+
+        {
+            // Critical path: 0 -> 1 -> 2 costs 6, 3 costs 1.
+            TaskGraph tg(a);
+            Task tasks[4];
+            std::atomic<u32> sequence(0);
+            const u64 costs[] = { 1, 2, 3, 1 };
+            for (u32 i = 0; i < countof(tasks); ++i)
+            {
+                tasks[i].sequence = &sequence;
+                tasks[i].num_runs = 0;
+                ENSURE(tg.add(task_func, &tasks[i], costs[i]) == i);
+            }
+            tg.add_edge(0, 1);
+            tg.add_edge(1, 2);
+            tg.build();
+            ENSURE(tg.size() == 4);
+            ENSURE(tg._nodes[0].priority == 6);
+            ENSURE(tg._nodes[1].priority == 5);
+            ENSURE(tg._nodes[2].priority == 3);
+            ENSURE(tg._nodes[3].priority == 1);
+            ENSURE(array::size(tg._roots) == 2);
+            ENSURE(tg._roots[0] == 0);
+            ENSURE(tg._roots[1] == 3);
+
+            // Each task runs once, after its predecessors.
+            JobSystem js(a, 1);
+            tg.run(js);
+            ENSURE(tasks[0].position < tasks[1].position);
+            ENSURE(tasks[1].position < tasks[2].position);
+            for (u32 i = 0; i < countof(tasks); ++i)
+                ENSURE(tasks[i].num_runs == 1);
+
+            // Clearing drops the times of the last run too.
+            tg.set_timing(true);
+            tg.run(js);
+            tg.clear();
+            ENSURE(tg.size() == 0);
+            ENSURE(array::size(tg._timings) == 0);
+            ENSURE(array::size(tg._jobs) == 0);
+            ENSURE(array::size(tg._successors) == 0);
+            ENSURE(tg._pending == NULL);
+            tg.run(js);
+        }
+        {
+            // Random DAG replayed many times, on threads and on fibers.
+            const u32 NUM_TASKS = 300;
+            TaskGraph tg(a);
+            Array<Task> tasks(a);
+            array::resize(tasks, NUM_TASKS);
+            std::atomic<u32> sequence(0);
+            for (u32 i = 0; i < NUM_TASKS; ++i)
+            {
+                tasks[i].sequence = &sequence;
+                tasks[i].num_runs = 0;
+                tg.add(task_func, &tasks[i], 1 + i % 7);
+            }
+
+            Array<TaskGraph::Edge> edges(a);
+            u32 state = 1;
+            for (u32 to = 1; to < NUM_TASKS; ++to)
+            {
+                for (u32 k = 0; k < 3; ++k)
+                {
+                    state = state * 1664525u + 1013904223u;
+                    TaskGraph::Edge e;
+                    e.from = (state >> 8) % to;
+                    e.to = to;
+                    tg.add_edge(e.from, e.to);
+                    array::push_back(edges, e);
+                }
+            }
+            tg.build();
+
+            JobSystem js3(a, 3);
+            JobSystem js_fibers(a, 2, 16);
+            JobSystem* systems[] = { &js3, &js_fibers };
+            const u32 NUM_RUNS = 50;
+            bool ok = true;
+            for (u32 s = 0; s < countof(systems); ++s)
+            {
+                for (u32 r = 0; r < NUM_RUNS; ++r)
+                {
+                    tg.set_timing(r % 2 == 1);
+                    tg.run(*systems[s]);
+                    for (u32 i = 0; i < array::size(edges); ++i)
+                        ok = ok && tasks[edges[i].from].position < tasks[edges[i].to].position;
+
+                    if (r % 2 == 1)
+                    {
+                        for (u32 i = 0; i < array::size(edges); ++i)
+                            ok = ok && tg.timing(edges[i].from).end <= tg.timing(edges[i].to).start;
+                        for (u32 i = 0; i < NUM_TASKS; ++i)
+                            ok = ok && tg.timing(i).start <= tg.timing(i).end;
+                    }
+                }
+            }
+            ENSURE(ok);
+            for (u32 i = 0; i < NUM_TASKS; ++i)
+                ENSURE(tasks[i].num_runs == NUM_RUNS * countof(systems));
+            ENSURE(sequence.load() == NUM_TASKS * NUM_RUNS * countof(systems));
+        }
+    }
+
+    static void test_thread()
+    {
+        {
+            Thread t;
+            ENSURE(!t.is_running());
+
+            std::atomic<u32> step(0);
+            t.start([](void* data) {
+                std::atomic<u32>& s = *(std::atomic<u32>*)data;
+                s.store(1);
+                while (s.load() != 2)
+                {
+                }
+                return 42;
+            }, &step);
+
+            while (step.load() != 1)
+            {
+            }
+            ENSURE(t.is_running());
+            ENSURE(t.set_name("unittest-worker-with-a-long-name"));
+            ENSURE(t.set_priority(ThreadPriority::LOW));
+
+            u32 cpus[256];
+            const u32 num_cores = thread::physical_cores(cpus, countof(cpus));
+            ENSURE(num_cores >= 1 && num_cores <= thread::num_cpus());
+            ENSURE(t.set_affinity(cpus, 1));
+
+            step.store(2);
+            ENSURE(t.join() == 42);
+            ENSURE(!t.is_running());
+            ENSURE(t.exit_code() == 42);
+        }
+        {
+            // Explicit stack size, restarted after join.
+            Thread t;
+            for (u32 i = 0; i < 2; ++i)
+            {
+                t.start([](void*) {
+                    // Sanitizers take a good part of the stack: only probe
+                    // a bit of it, and check the size where possible.
+                    volatile char buf[64*1024];
+                    buf[0] = 1;
+                    buf[sizeof(buf) - 1] = 2;
+                    s32 ret = buf[0] + buf[sizeof(buf) - 1];
+#if CROWN_PLATFORM_LINUX
+                    pthread_attr_t attr;
+                    size_t size = 0;
+                    pthread_getattr_np(pthread_self(), &attr);
+                    pthread_attr_getstacksize(&attr, &size);
+                    pthread_attr_destroy(&attr);
+                    if (size < 1024*1024)
+                        ret = 0;
+#endif
+                    return ret;
+                }, NULL, 1024*1024);
+                ENSURE(t.join() == 3);
+            }
+        }
+#if CROWN_PLATFORM_LINUX
+        {
+            // A stack below the minimum size fails without starting.
+            Thread t;
+            ENSURE(!t.start([](void*) { return 0; }, NULL, 1));
+            ENSURE(!t.is_running());
+            ENSURE(t.start([](void*) { return 5; }));
+            ENSURE(t.join() == 5);
+        }
+#endif
+        {
+            // Joined by the destructor.
+            Thread t;
+            t.start([](void*) { return 0; });
+        }
+    }
+
+    static void test_xxh3()
+    {
+        // Reference values from XXH3_64bits_withSeed().
+        {
+            ENSURE(xxh3_64("", 0, 0) == 0x2d06800538d394c2ULL);
+            ENSURE(xxh3_64("abc", 3, 0) == 0x78af5f94892f3950ULL);
+            ENSURE(xxh3_64("abcdefghijk", 11, 0) == 0x386cb4f266186f62ULL);
+            ENSURE(xxh3_64("abcdefghijk", 11, 0x0BADBEEF) == 0xd6ccb4f4bafe57b5ULL);
+
+            const char* str = "hello crown! hello crown! hello crown!";
+            ENSURE(xxh3_64(str, 38, 0) == 0x8e00487197a073e6ULL);
+            ENSURE(xxh3_64(str, 38, 0x0BADBEEF) == 0xe1e1281addf7de5cULL);
+        }
+
+        // Long input
+        {
+            u8 data[512];
+            for (u32 i = 0; i < countof(data); ++i)
+                data[i] = u8(i);
+            ENSURE(xxh3_64(data, 512, 0) == 0x1059105ad19bfa09ULL);
+            ENSURE(xxh3_64(data, 512, 0x0BADBEEF) == 0x49b2990ff86815d6ULL);
+        }
+
+        // xxh3_hash
+        {
+            const u64 val = 0x0BADBEEF;
+            ENSURE(xxh3_hash<u64>()(val) == u32(xxh3_64(&val, sizeof(val), 0)));
+        }
     }
 
 #define RUN_TEST(name)      \
@@ -700,14 +3359,43 @@ namespace crown
     {
         memory_globals::init();
         RUN_TEST(test_default_allocator);
+        RUN_TEST(test_scratch_allocator);
         RUN_TEST(test_new_delete);
         RUN_TEST(test_array);
+        RUN_TEST(test_array_algorithms);
+        RUN_TEST(test_bit_array);
+        RUN_TEST(test_bucket_array);
+        RUN_TEST(test_concurrent_hash_map);
+        RUN_TEST(test_condition_variable);
         RUN_TEST(test_containers_pair);
+        RUN_TEST(test_dynamic_string);
+        RUN_TEST(test_fiber);
+        RUN_TEST(test_guid);
+        RUN_TEST(test_job_system);
+        RUN_TEST(test_lock_stats);
+        RUN_TEST(test_mpmc_queue);
         RUN_TEST(test_murmur_hash);
+        RUN_TEST(test_mutex);
+        RUN_TEST(test_number_format);
+        RUN_TEST(test_number_parse);
+        RUN_TEST(test_parallel_algorithms);
+        RUN_TEST(test_read_write_lock);
+        RUN_TEST(test_semaphore);
+        RUN_TEST(test_spin_lock);
+        RUN_TEST(test_spsc_queue);
         RUN_TEST(test_string_id);
+        RUN_TEST(test_string_id_table);
         RUN_TEST(test_string_inline);
+        RUN_TEST(test_string_scan);
         RUN_TEST(test_string_stream);
+        RUN_TEST(test_string_table);
         RUN_TEST(test_string_view);
+        RUN_TEST(test_task_graph);
+        RUN_TEST(test_thread);
+        RUN_TEST(test_utf8);
+        RUN_TEST(test_wildcard_set);
+        RUN_TEST(test_work_stealing_deque);
+        RUN_TEST(test_xxh3);
         memory_globals::shutdown();
         return EXIT_SUCCESS;
     }